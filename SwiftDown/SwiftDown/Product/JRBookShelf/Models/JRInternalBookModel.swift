@@ -26,17 +26,24 @@ class JRInternalBookModel: NSObject {
 extension JRInternalBookModel {
 	
 	/// 加载内置书
+	///
+	/// 有缓存时先用缓存显示，再在后台验证，数据变化时 completion 会再调用一次
 	static func loadInternalBook(completion:@escaping (_ list: [JRInternalBookModel]?, _ isSuccess: Bool) -> ()) {
-		JRNetWorkManager.shared.myRequest(JRIgnoreFile.Url_InternalBook) { (json: AnyObject?, isSuccess: Bool) in
+		JRNetWorkManager.shared.myCachedRequest(JRIgnoreFile.Url_InternalBook,
+		                                        policy: .staleWhileRevalidate,
+		                                        maxAge: 300) { (data: Data?, isSuccess: Bool) in
 			
 			/// 数据判断
-			guard let jsonData = json else {
+			guard
+				let data = data,
+				let jsonData = (try? JSONSerialization.jsonObject(with: data, options: [])) as? [String : Any],
+				let result = jsonData["result"] as? [[String : AnyObject]]
+			else {
 				completion(nil, false)
 				return
 			}
 			
 			/// 数据处理
-			let result = jsonData["result"] as! [[String : AnyObject]]
 			let array = NSArray.yy_modelArray(with: JRInternalBookModel.self, json: result)
 			completion(array as? [JRInternalBookModel], true)
 		}
@@ -20,6 +20,9 @@ class JRNetWorkManager: NSObject {
 	/// 网络单粒
 	static let shared = JRNetWorkManager()
 
+	/// 进行中的请求 [请求标识: 等待结果的回调]
+	fileprivate var inFlightRequests = [String : [(AnyObject?, Bool) -> ()]]()
+	fileprivate let inFlightLock = NSLock()
 }
 
 // MARK: - 公共上行参数
@@ -46,6 +49,29 @@ extension JRNetWorkManager {
 		return JRNetWorkURL.getPublicParam(param: param)
 	}
 	
+	/// 请求标识，用于合并相同的请求
+	///
+	/// 由请求方法、URL 和按 key 排序的参数组成，不包含每次都会变化的 sig；
+	/// 参数与 Alamofire 发送时一样编码，值中的 '&'、'=' 不会和分隔符混淆
+	///
+	/// - Parameters:
+	///   - url: 请求地址
+	///   - method: 请求方法
+	///   - param: 处理后的请求参数
+	/// - Returns: 请求标识
+	func requestKey(_ url: URLConvertible, method: HTTPMethod, param: [String : Any]) -> String {
+		
+		let urlString = (try? url.asURL().absoluteString) ?? "\(url)"
+		
+		var components = [(String, String)]()
+		for name in param.keys.sorted(by: {$0 < $1}) where name != "sig" {
+			components += URLEncoding.default.queryComponents(fromKey: name, value: param[name]!)
+		}
+		
+		let query = components.map { "\($0)=\($1)" }.joined(separator: "&")
+		return method.rawValue + " " + urlString + "?" + query
+	}
+	
 	/// 获取webView公共上行参数
 	///
 	/// - Returns: 返回webView公共上行参数
@@ -53,6 +79,21 @@ extension JRNetWorkManager {
 		return [:];
 	}
 	
+	/// 接口是否返回成功
+	///
+	/// 业务错误也是 HTTP 200，只能看响应中的 code；只取出 code 字段，不解析整个响应
+	///
+	/// - Parameter data: 响应数据
+	/// - Returns: code 为 JRNetWorkCode.success 时返回 true
+	static func isSuccessResponse(_ data: Data) -> Bool {
+		guard
+			let code = CZJSONModelDecoder.value(atKeyPath: "code", from: data)
+		else {
+			return false
+		}
+		return "\(code)" == JRNetWorkCode.success.rawValue
+	}
+	
 }
 
 // MARK: - 网络工具
@@ -60,6 +101,9 @@ extension JRNetWorkManager {
 	
 	/// 普通网络请求
 	///
+	/// 与进行中的请求相同 (URL 和除 sig 以外的参数都相同) 时不再发送，
+	/// 等第一个请求返回后用同一个结果回调
+	///
 	/// - Parameters:
 	///   - url: 请求地址
 	///   - method: 请求方法
@@ -80,13 +124,135 @@ extension JRNetWorkManager {
 		/// 处理请求参数
 		let param: [String:Any] = processParam(param: parameters)
 		
+		/// 相同的请求正在进行时只登记回调
+		let key = requestKey(url, method: method, param: param)
+		
+		inFlightLock.lock()
+		if inFlightRequests[key] != nil {
+			inFlightRequests[key]!.append(completion)
+			inFlightLock.unlock()
+			return
+		}
+		inFlightRequests[key] = [completion]
+		inFlightLock.unlock()
+		
 		/// 请求方法
 		Alamofire.request(url, method: method,
 		                  parameters: param,
 		                  encoding: encoding,
 		                  headers: header).responseJSON { (response) in
 							print(response.result)
-							completion(response.result.value as AnyObject?, true)
+							
+							/// 取出所有等待这个结果的回调
+							self.inFlightLock.lock()
+							let callbacks = self.inFlightRequests.removeValue(forKey: key) ?? []
+							self.inFlightLock.unlock()
+							
+							for callback in callbacks {
+								callback(response.result.value as AnyObject?, true)
+							}
+		}
+	}
+	
+	/// 使用磁盘缓存的网络请求，返回原始数据
+	///
+	/// 缓存 key 与 requestKey 相同 (不包含 sig)；只保存通过 validate 的响应，
+	/// 缓存过期后带 If-None-Match / If-Modified-Since 请求，304 时继续使用缓存，
+	/// 网络失败或响应没有通过 validate 时使用过期的缓存
+	///
+	/// - Parameters:
+	///   - url: 请求地址
+	///   - method: 请求方法
+	///   - parameters: 请求参数
+	///   - encoding: 编码
+	///   - policy: 缓存使用方式，staleWhileRevalidate 时 completion 可能调用两次
+	///   - maxAge: 服务器没有给出 max-age 时的有效期 (秒)
+	///   - validate: 检查响应数据，默认要求 code 为成功
+	///   - completion: 请求完成回调
+	func myCachedRequest(_ url: URLConvertible,
+	                     method: HTTPMethod = .post,
+	                     parameters: Parameters? = nil,
+	                     encoding: ParameterEncoding = URLEncoding.default,
+	                     policy: JRCachePolicy = .revalidate,
+	                     maxAge: TimeInterval = 0,
+	                     validate: @escaping (_ data: Data) -> Bool = JRNetWorkManager.isSuccessResponse,
+	                     completion: @escaping (_ data: Data?, _ isSuccess: Bool) -> ()) {
+		
+		/// 处理请求参数
+		let param: [String:Any] = processParam(param: parameters)
+		
+		/// 缓存 key 不包含每次都会变化的 sig
+		let key = requestKey(url, method: method, param: param)
+		let cache = JRResponseCache.shared
+		
+		cache.entry(forKey: key) { (entry: JRCacheEntry?) in
+			
+			/// 1. 缓存未过期，不请求网络
+			if let entry = entry, entry.isFresh {
+				completion(entry.data, true)
+				return
+			}
+			
+			/// 2. 先返回过期的缓存
+			var served = false
+			if let entry = entry, policy == .staleWhileRevalidate {
+				completion(entry.data, true)
+				served = true
+			}
+			
+			/// 3. 条件请求
+			var header: HTTPHeaders = self.registerUserToken()
+			if let etag = entry?.etag {
+				header["If-None-Match"] = etag
+			}
+			if let lastModified = entry?.lastModified {
+				header["If-Modified-Since"] = lastModified
+			}
+			
+			Alamofire.request(url, method: method,
+			                  parameters: param,
+			                  encoding: encoding,
+			                  headers: header).response { (response) in
+								
+								guard
+									let http = response.response,
+									response.error == nil
+								else {
+									/// 网络失败时使用过期的缓存
+									if !served {
+										completion(entry?.data, entry != nil)
+									}
+									return
+								}
+								
+								/// 数据没有变化
+								if http.statusCode == 304, let entry = entry {
+									cache.refresh(forKey: key, response: http, defaultMaxAge: maxAge)
+									if !served {
+										completion(entry.data, true)
+									}
+									return
+								}
+								
+								/// 业务错误不保存，避免之后当作有效数据返回
+								guard
+									http.statusCode >= 200 && http.statusCode < 300,
+									let data = response.data,
+									validate(data)
+								else {
+									if !served {
+										completion(entry?.data, entry != nil)
+									}
+									return
+								}
+								
+								cache.store(data, response: http, forKey: key, defaultMaxAge: maxAge)
+								
+								/// 已经返回过相同的缓存时不再回调
+								if !served || data != entry?.data {
+									completion(data, true)
+								}
+			}
 		}
 	}
 	
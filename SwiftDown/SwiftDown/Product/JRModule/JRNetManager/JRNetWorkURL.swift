@@ -21,23 +21,30 @@ extension JRNetWorkURL {
 	/// - Returns: 请求上行参数
 	static func getPublicParam(param: [String : Any]?) -> [String:Any] {
 
-		/// 获取基础参数
-		var mParam = publicUpwardConcatenation()
-		/// 合并参数
+		/// 获取基础参数，公共参数已经转义
+		var mParam = encodedPublicParam
+		/// 合并参数，只转义本次请求的参数 (中文转义)
 		for (k, v) in param ?? [:]{
-			mParam.updateValue(v, forKey: k)
-		}
-		mParam["sig"] = getParamSign(param: mParam);
-		/// 中文转义
-		let keys = mParam.keys
-		for key in keys {
-			let value: String = mParam[key]! as! String
-			mParam.updateValue(value.addingPercentEncoding(withAllowedCharacters: .urlQueryAllowed)!,
-			                   forKey: key)
+			let value: String = v as! String
+			mParam.updateValue(value.cz_percentEncoded, forKey: k)
 		}
+		/// 签名只需要请求参数，公共参数已经预先排序拼接
+		mParam["sig"] = JRParamSigner.shared.sign(requestParam: param).cz_percentEncoded
 		return mParam
 	}
 	
+	/// 公共上行参数，只创建一次
+	static let publicParam: [String : Any] = publicUpwardConcatenation()
+	
+	/// 转义后的公共上行参数，只转义一次
+	static let encodedPublicParam: [String : Any] = {
+		var encoded: [String : Any] = [:]
+		for (key, value) in publicParam {
+			encoded[key] = (value as! String).cz_percentEncoded
+		}
+		return encoded
+	}()
+	
 	/// 获取公共上行参数
 	///
 	/// - Returns: 返回客户端基本信息
@@ -68,19 +75,8 @@ extension JRNetWorkURL {
 	/// - Parameter param: 请求参数
 	/// - Returns: 参数签名
 	static func getParamSign(param: [String : Any]) -> String {
-		
-		var sign: String = String()
-		let keys: Array = param.keys.sorted(by: {$0 < $1})
-		
-		for i in 0..<keys.count {
-			let key = keys[i]
-			if(i == 0){
-				sign.append(String(format: "%@=%@", key, param[key]! as! String))
-			}else{
-				sign.append(String(format: "&%@=%@", key, param[key]! as! String))
-			}
-		}
-		return JRIgnoreFile.encryptSign(sign: sign)
+		/// 与公共参数相同的部分会被预先拼接的片段覆盖，结果不变
+		return JRParamSigner.shared.sign(requestParam: param)
 	}
 }
 
@@ -165,14 +161,12 @@ extension JRNetWorkURL {
 	// Use of unresolved identifier 'CC_MD5'
 	static func md5String(str:String) -> String{
 		let cStr = str.cString(using: String.Encoding.utf8);
-		let buffer = UnsafeMutablePointer<UInt8>.allocate(capacity: 16)
-		CC_MD5(cStr!,(CC_LONG)(strlen(cStr!)), buffer)
-		let md5String = NSMutableString();
-		for i in 0 ..< 16{
-			md5String.appendFormat("%02x", buffer[i])
-		}
-		free(buffer)
-		return md5String as String
+		var digest = [UInt8](repeating: 0, count: Int(CC_MD5_DIGEST_LENGTH))
+		CC_MD5(cStr!,(CC_LONG)(strlen(cStr!)), &digest)
+		/// 十六进制编码一次写入，末尾保留 '\0'
+		var hex = [CChar](repeating: 0, count: digest.count * 2 + 1)
+		cz_hex_encode(digest, digest.count, &hex)
+		return String(cString: hex)
 	}
 }
 
@@ -0,0 +1,113 @@
+//
+//  JRParamSigner.swift
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/28.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+import Foundation
+
+/// 参数签名工具
+///
+/// 公共上行参数固定不变，创建时排好序并拼成 "key=value" 的 UTF8 片段；
+/// 每次签名只对请求自己的几个参数排序，与公共片段归并后写入复用的缓冲区
+class JRParamSigner: NSObject {
+
+	/// 使用公共上行参数的签名工具
+	static let shared = JRParamSigner(publicParam: JRNetWorkURL.publicUpwardConcatenation())
+
+	/// 排好序的公共参数
+	fileprivate let publicKeys: [String]
+	/// 与 publicKeys 一一对应的 "key=value" 片段
+	fileprivate let publicSegments: [[UInt8]]
+	/// 全部公共片段加上 '&' 的长度
+	fileprivate let publicLength: Int
+
+	/// 签名字符串缓冲区，加锁复用
+	fileprivate var buffer = [UInt8]()
+	fileprivate let lock = NSLock()
+
+	/// 创建签名工具
+	///
+	/// - Parameter publicParam: 公共上行参数
+	init(publicParam: [String : Any]) {
+
+		let keys = publicParam.keys.sorted(by: {$0 < $1})
+		let segments = keys.map { (key: String) -> [UInt8] in
+			return Array("\(key)=\(JRParamSigner.stringValue(publicParam[key]!))".utf8)
+		}
+
+		publicKeys = keys
+		publicSegments = segments
+		publicLength = segments.reduce(0) { $0 + $1.count + 1 }
+
+		super.init()
+	}
+
+	/// 计算签名
+	///
+	/// 与公共参数同名的请求参数覆盖公共参数，结果与把两者合并后
+	/// 按 key 排序、用 '&' 连接 "key=value" 再加密相同
+	///
+	/// - Parameter requestParam: 请求自己的参数，可以包含公共参数
+	/// - Returns: 参数签名
+	func sign(requestParam: [String : Any]?) -> String {
+		return JRIgnoreFile.encryptSign(sign: signingString(requestParam: requestParam))
+	}
+
+	/// 加密前的签名字符串
+	///
+	/// - Parameter requestParam: 请求自己的参数，可以包含公共参数
+	/// - Returns: 按 key 排序、用 '&' 连接的 "key=value"
+	func signingString(requestParam: [String : Any]?) -> String {
+
+		/// 1. 只对请求参数排序
+		let param = requestParam ?? [:]
+		let keys = param.keys.sorted(by: {$0 < $1})
+
+		lock.lock()
+		defer {
+			lock.unlock()
+		}
+
+		buffer.removeAll(keepingCapacity: true)
+		buffer.reserveCapacity(publicLength + 64 * keys.count)
+
+		/// 2. 归并两个有序序列，同名时使用请求参数
+		var i = 0
+		var j = 0
+
+		while i < publicKeys.count || j < keys.count {
+
+			if !buffer.isEmpty {
+				buffer.append(0x26) // '&'
+			}
+
+			if j == keys.count || (i < publicKeys.count && publicKeys[i] < keys[j]) {
+				buffer.append(contentsOf: publicSegments[i])
+				i += 1
+				continue
+			}
+
+			let key = keys[j]
+			if i < publicKeys.count && publicKeys[i] == key {
+				i += 1
+			}
+			buffer.append(contentsOf: key.utf8)
+			buffer.append(0x3D) // '='
+			buffer.append(contentsOf: JRParamSigner.stringValue(param[key]!).utf8)
+			j += 1
+		}
+
+		return String(bytes: buffer, encoding: .utf8) ?? ""
+	}
+
+	/// 参数值转换为字符串
+	fileprivate static func stringValue(_ value: Any) -> String {
+		if let string = value as? String {
+			return string
+		}
+		return "\(value)"
+	}
+}
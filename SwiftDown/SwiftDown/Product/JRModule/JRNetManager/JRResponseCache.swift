@@ -0,0 +1,281 @@
+//
+//  JRResponseCache.swift
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/30.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+import UIKit
+
+/// 缓存使用方式
+enum JRCachePolicy {
+	/// 缓存未过期时直接使用，过期后带 ETag / Last-Modified 重新验证
+	case revalidate
+	/// 先返回缓存 (即使已经过期)，再在后台验证，数据有变化时再回调一次
+	case staleWhileRevalidate
+}
+
+/// 缓存条目
+struct JRCacheEntry {
+	/// 响应数据
+	let data: Data
+	/// 验证头
+	let etag: String?
+	let lastModified: String?
+	/// 过期时间
+	let expires: Date
+
+	/// 是否还在有效期内
+	var isFresh: Bool {
+		return expires > Date()
+	}
+}
+
+/// 磁盘响应缓存
+///
+/// 目录接口等都是 POST 请求，URLCache 不会缓存，这里按规范化后的请求参数保存响应：
+/// 遵守 Cache-Control 的 max-age / no-cache / no-store，保存 ETag / Last-Modified 用于条件请求，
+/// 总大小超过上限时按最近访问时间淘汰
+class JRResponseCache: NSObject {
+
+	/// 共享缓存，保存在 Caches/JRResponseCache，上限 20 MB
+	static let shared = JRResponseCache(directory: ("JRResponseCache" as NSString).cz_appendCacheDir(),
+	                                    sizeLimit: 20 * 1024 * 1024)
+
+	/// 缓存目录
+	let directory: String
+	/// 数据文件的总大小上限 (字节)
+	let sizeLimit: Int
+
+	/// 所有磁盘操作都在这个串行队列中
+	fileprivate let queue = DispatchQueue(label: "com.youranmuye0.response-cache")
+	/// 索引 [文件名: 元数据]，与数据文件一起保存；
+	/// 读取只更新内存中的访问时间，保存、删除时才写入 index.plist
+	fileprivate var index = [String : [String : Any]]()
+	fileprivate var indexPath: String {
+		return (directory as NSString).appendingPathComponent("index.plist")
+	}
+
+	/// 创建缓存
+	///
+	/// - Parameters:
+	///   - directory: 缓存目录
+	///   - sizeLimit: 数据文件的总大小上限
+	init(directory: String, sizeLimit: Int) {
+		self.directory = directory
+		self.sizeLimit = sizeLimit
+		super.init()
+
+		queue.async {
+			try? FileManager.default.createDirectory(atPath: directory, withIntermediateDirectories: true, attributes: nil)
+			if let saved = NSDictionary(contentsOfFile: self.indexPath) as? [String : [String : Any]] {
+				self.index = saved
+			}
+		}
+	}
+}
+
+// MARK: - 读写
+extension JRResponseCache {
+
+	/// 读取缓存，在主线程回调
+	///
+	/// - Parameters:
+	///   - key: 缓存 key
+	///   - completion: 缓存条目，不存在时为 nil
+	func entry(forKey key: String, completion: @escaping (_ entry: JRCacheEntry?) -> ()) {
+
+		queue.async {
+			let name = self.fileName(forKey: key)
+			var entry: JRCacheEntry?
+
+			if let meta = self.index[name],
+				let data = try? Data(contentsOf: URL(fileURLWithPath: self.filePath(name))) {
+
+				entry = JRCacheEntry(data: data,
+				                     etag: meta["etag"] as? String,
+				                     lastModified: meta["lastModified"] as? String,
+				                     expires: Date(timeIntervalSince1970: meta["expires"] as? Double ?? 0))
+
+				/// 更新访问时间，用于淘汰，下次保存索引时一起写入
+				self.index[name]?["access"] = Date().timeIntervalSince1970
+			}
+
+			DispatchQueue.main.async {
+				completion(entry)
+			}
+		}
+	}
+
+	/// 保存响应，Cache-Control 为 no-store 时不保存
+	///
+	/// - Parameters:
+	///   - data: 响应数据
+	///   - response: 响应
+	///   - key: 缓存 key
+	///   - defaultMaxAge: 服务器没有给出 max-age 时的有效期
+	func store(_ data: Data, response: HTTPURLResponse, forKey key: String, defaultMaxAge: TimeInterval) {
+
+		guard
+			let maxAge = JRResponseCache.maxAge(of: response, defaultMaxAge: defaultMaxAge)
+		else {
+			remove(forKey: key)
+			return
+		}
+
+		queue.async {
+			let name = self.fileName(forKey: key)
+
+			do {
+				try data.write(to: URL(fileURLWithPath: self.filePath(name)), options: .atomic)
+			} catch {
+				return
+			}
+
+			let now = Date().timeIntervalSince1970
+			var meta: [String : Any] = ["expires": now + maxAge,
+			                            "access": now,
+			                            "size": data.count]
+			if let etag = JRResponseCache.header("ETag", of: response) {
+				meta["etag"] = etag
+			}
+			if let lastModified = JRResponseCache.header("Last-Modified", of: response) {
+				meta["lastModified"] = lastModified
+			}
+
+			self.index[name] = meta
+			self.evictIfNeeded()
+			self.saveIndex()
+		}
+	}
+
+	/// 服务器返回 304 时延长有效期，并使用响应中新的验证头
+	func refresh(forKey key: String, response: HTTPURLResponse, defaultMaxAge: TimeInterval) {
+
+		let maxAge = JRResponseCache.maxAge(of: response, defaultMaxAge: defaultMaxAge) ?? 0
+
+		queue.async {
+			let name = self.fileName(forKey: key)
+
+			guard
+				var meta = self.index[name]
+			else { return }
+
+			let now = Date().timeIntervalSince1970
+			meta["expires"] = now + maxAge
+			meta["access"] = now
+			if let etag = JRResponseCache.header("ETag", of: response) {
+				meta["etag"] = etag
+			}
+			if let lastModified = JRResponseCache.header("Last-Modified", of: response) {
+				meta["lastModified"] = lastModified
+			}
+
+			self.index[name] = meta
+			self.saveIndex()
+		}
+	}
+
+	/// 删除一条缓存
+	func remove(forKey key: String) {
+		queue.async {
+			let name = self.fileName(forKey: key)
+			if self.index.removeValue(forKey: name) != nil {
+				try? FileManager.default.removeItem(atPath: self.filePath(name))
+				self.saveIndex()
+			}
+		}
+	}
+
+	/// 清空缓存
+	func removeAll() {
+		queue.async {
+			for name in self.index.keys {
+				try? FileManager.default.removeItem(atPath: self.filePath(name))
+			}
+			self.index.removeAll()
+			self.saveIndex()
+		}
+	}
+}
+
+// MARK: - 私有方法
+extension JRResponseCache {
+
+	/// key 散列为文件名
+	fileprivate func fileName(forKey key: String) -> String {
+		return (key as NSString).cz_fastHashString()
+	}
+
+	fileprivate func filePath(_ name: String) -> String {
+		return (directory as NSString).appendingPathComponent(name)
+	}
+
+	fileprivate func saveIndex() {
+		(index as NSDictionary).write(toFile: indexPath, atomically: true)
+	}
+
+	/// 总大小超过上限时，从最久没有访问的开始删除
+	fileprivate func evictIfNeeded() {
+
+		var total = index.values.reduce(0) { $0 + ($1["size"] as? Int ?? 0) }
+		if total <= sizeLimit {
+			return
+		}
+
+		let names = index.keys.sorted {
+			(index[$0]?["access"] as? Double ?? 0) < (index[$1]?["access"] as? Double ?? 0)
+		}
+
+		for name in names {
+			if total <= sizeLimit {
+				break
+			}
+			total -= index[name]?["size"] as? Int ?? 0
+			index.removeValue(forKey: name)
+			try? FileManager.default.removeItem(atPath: filePath(name))
+		}
+	}
+
+	/// 响应头，不区分大小写
+	fileprivate static func header(_ name: String, of response: HTTPURLResponse) -> String? {
+		let lowercased = name.lowercased()
+		for (key, value) in response.allHeaderFields {
+			if let key = key as? String, key.lowercased() == lowercased {
+				return value as? String
+			}
+		}
+		return nil
+	}
+
+	/// 响应的有效期
+	///
+	/// - Returns: no-store 时返回 nil，no-cache 为 0，其次为 max-age，都没有时为 defaultMaxAge
+	fileprivate static func maxAge(of response: HTTPURLResponse, defaultMaxAge: TimeInterval) -> TimeInterval? {
+
+		guard
+			let cacheControl = header("Cache-Control", of: response)
+		else {
+			return defaultMaxAge
+		}
+
+		var maxAge = defaultMaxAge
+
+		for item in cacheControl.lowercased().components(separatedBy: ",") {
+			let directive = item.trimmingCharacters(in: .whitespaces)
+
+			if directive == "no-store" {
+				return nil
+			}
+			if directive == "no-cache" {
+				return 0
+			}
+			if directive.hasPrefix("max-age="),
+				let value = TimeInterval(directive.substring(from: directive.index(directive.startIndex, offsetBy: 8))) {
+				maxAge = value
+			}
+		}
+		return maxAge
+	}
+}
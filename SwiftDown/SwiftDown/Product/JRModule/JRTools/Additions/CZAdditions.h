@@ -16,6 +16,14 @@
 
 #import "NSAttributedString+CZAdditon.h"
 #import "NSString+CZHash.h"
+#import "NSData+CZHash.h"
 #import "NSString+CZBase64.h"
 #import "NSString+CZPath.h"
+#import "CZTreeHash.h"
+#import "CZHmac.h"
+#import "CZResumableHasher.h"
+#import "CZHashService.h"
+#import "CZBase64Stream.h"
+#import "CZClassMapping.h"
+#import "CZJSONModelDecoder.h"
 
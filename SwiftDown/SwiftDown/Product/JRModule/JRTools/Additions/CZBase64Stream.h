@@ -0,0 +1,57 @@
+//
+//  CZBase64Stream.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/22.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "cz_base64.h"
+
+/// 流式编解码的输出，返回 NO 时停止
+typedef BOOL (^CZBase64Sink)(const void *bytes, NSUInteger length);
+
+/// 流式 BASE 64 编码
+///
+/// 输入可以按任意长度分段，结果每满 4 KB 交给输出一次，内存占用与数据大小无关
+@interface CZBase64Encoder : NSObject
+
+/// 使用输出 block 创建
+///
+/// @param alphabet 字母表，URL 安全字母表不补 '='
+/// @param sink     输出
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet sink:(CZBase64Sink)sink;
+
+/// 直接写入文件，文件无法创建时返回 nil
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet outputPath:(NSString *)path;
+
+/// 追加数据，输出失败后返回 NO
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length;
+- (BOOL)appendData:(NSData *)data;
+
+/// 输出剩余部分并关闭文件
+- (BOOL)finish;
+
+@end
+
+/// 流式 BASE 64 解码
+///
+/// 4 个字符一组可以跨越两次输入，适合边下载边解码大资源
+@interface CZBase64Decoder : NSObject
+
+/// 使用输出 block 创建
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet sink:(CZBase64Sink)sink;
+
+/// 直接写入文件，文件无法创建时返回 nil
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet outputPath:(NSString *)path;
+
+/// 追加字符，包含非法字符或输出失败后返回 NO
+- (BOOL)appendBytes:(const char *)chars length:(NSUInteger)length;
+- (BOOL)appendData:(NSData *)data;
+- (BOOL)appendString:(NSString *)string;
+
+/// 检查结尾、输出最后一组并关闭文件
+- (BOOL)finish;
+
+@end
@@ -0,0 +1,177 @@
+//
+//  CZBase64Stream.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/22.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "CZBase64Stream.h"
+#import <fcntl.h>
+#import <unistd.h>
+
+static int CZBase64BlockSink(void *ctx, const void *bytes, size_t len) {
+    CZBase64Sink sink = (__bridge CZBase64Sink)ctx;
+    
+    return sink(bytes, len) ? 0 : 1;
+}
+
+/// 创建输出文件，失败返回 -1
+static int CZBase64OpenFile(NSString *path) {
+    return open(path.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+#pragma mark - CZBase64Encoder
+
+@implementation CZBase64Encoder {
+    cz_base64_encoder _encoder;
+    CZBase64Sink _sink;
+    int _fd;
+    BOOL _failed;
+}
+
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet sink:(CZBase64Sink)sink {
+    self = [super init];
+    if (self) {
+        _sink = [sink copy];
+        _fd = -1;
+        cz_base64_encoder_init(&_encoder, alphabet, alphabet == CZBase64Standard, CZBase64BlockSink, (__bridge void *)_sink);
+    }
+    return self;
+}
+
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet outputPath:(NSString *)path {
+    self = [super init];
+    if (self) {
+        _fd = CZBase64OpenFile(path);
+        if (_fd < 0) {
+            return nil;
+        }
+        cz_base64_encoder_init(&_encoder, alphabet, alphabet == CZBase64Standard, cz_base64_fd_sink, &_fd);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    if (!_failed && cz_base64_encoder_update(&_encoder, bytes, length) != 0) {
+        _failed = YES;
+    }
+    return !_failed;
+}
+
+- (BOOL)appendData:(NSData *)data {
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        *stop = ![self appendBytes:bytes length:byteRange.length];
+    }];
+    return !_failed;
+}
+
+- (BOOL)finish {
+    if (!_failed && cz_base64_encoder_final(&_encoder) != 0) {
+        _failed = YES;
+    }
+    if (_fd >= 0) {
+        _failed = close(_fd) != 0 || _failed;
+        _fd = -1;
+    }
+    return !_failed;
+}
+
+@end
+
+#pragma mark - CZBase64Decoder
+
+@implementation CZBase64Decoder {
+    cz_base64_decoder _decoder;
+    CZBase64Sink _sink;
+    int _fd;
+    BOOL _failed;
+}
+
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet sink:(CZBase64Sink)sink {
+    self = [super init];
+    if (self) {
+        _sink = [sink copy];
+        _fd = -1;
+        cz_base64_decoder_init(&_decoder, alphabet, CZBase64BlockSink, (__bridge void *)_sink);
+    }
+    return self;
+}
+
+- (instancetype)initWithAlphabet:(CZBase64Alphabet)alphabet outputPath:(NSString *)path {
+    self = [super init];
+    if (self) {
+        _fd = CZBase64OpenFile(path);
+        if (_fd < 0) {
+            return nil;
+        }
+        cz_base64_decoder_init(&_decoder, alphabet, cz_base64_fd_sink, &_fd);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+- (BOOL)appendBytes:(const char *)chars length:(NSUInteger)length {
+    if (!_failed && cz_base64_decoder_update(&_decoder, chars, length) != 0) {
+        _failed = YES;
+    }
+    return !_failed;
+}
+
+- (BOOL)appendData:(NSData *)data {
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        *stop = ![self appendBytes:bytes length:byteRange.length];
+    }];
+    return !_failed;
+}
+
+- (BOOL)appendString:(NSString *)string {
+    
+    // 1. 内部存储是 ASCII 时直接使用
+    const char *ptr = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingASCII);
+    if (ptr != NULL) {
+        return [self appendBytes:ptr length:string.length];
+    }
+    
+    // 2. 否则分段转码到栈上的缓冲区，非 ASCII 字符一定不合法
+    char buffer[CZ_BASE64_STREAM_CHUNK];
+    NSRange range = NSMakeRange(0, string.length);
+    
+    while (range.length > 0) {
+        NSUInteger used = 0;
+        
+        if (![string getBytes:buffer maxLength:sizeof(buffer) usedLength:&used encoding:NSASCIIStringEncoding options:0 range:range remainingRange:&range] || used == 0) {
+            _failed = YES;
+            break;
+        }
+        if (![self appendBytes:buffer length:used]) {
+            break;
+        }
+    }
+    
+    return !_failed;
+}
+
+- (BOOL)finish {
+    if (!_failed && cz_base64_decoder_final(&_decoder) != 0) {
+        _failed = YES;
+    }
+    if (_fd >= 0) {
+        _failed = close(_fd) != 0 || _failed;
+        _fd = -1;
+    }
+    return !_failed;
+}
+
+@end
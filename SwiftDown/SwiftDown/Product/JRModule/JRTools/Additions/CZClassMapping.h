@@ -0,0 +1,80 @@
+//
+//  CZClassMapping.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/23.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "cz_atom.h"
+
+/// 一个可写属性的赋值信息
+typedef struct {
+    /// 属性名，由 CZClassMapping 持有
+    __unsafe_unretained NSString *name;
+    /// setter 及其实现，创建映射表时解析一次
+    SEL setter;
+    IMP imp;
+    /// 类型编码的第一个字符，如 '@' 'q' 'd' 'B'
+    char type;
+    /// 对象类型属性的类，id 类型为 Nil
+    __unsafe_unretained Class cls;
+    /// 数值属性的成员变量偏移，类允许直接写入时 >= 0，否则为 -1 (调用 setter)
+    ptrdiff_t offset;
+    /// 属性名在原子表中的 ID，表已满时为 CZ_ATOM_NONE
+    cz_atom atom;
+} CZPropertyInfo;
+
+/// 类的字典 -> 模型映射表
+///
+/// 每个类只解析一次属性列表，之后按 key 的散列查找属性，
+/// 通过缓存的 setter IMP 直接赋值，不再经过 KVC 的线性查找
+///
+/// 默认所有属性都调用 setter；类的 +cz_mapsScalarsDirectly 返回 YES 时，
+/// 没有自定义 setter 的数值属性 (Int / Bool / CGFloat 等) 直接写入成员变量，不调用 setter
+@interface CZClassMapping : NSObject
+
+/// 映射的类
+@property (nonatomic, readonly) Class cls;
+
+/// 可写属性的个数
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/// 原子表已满、有属性名没有登记时为 NO，此时需要按字符串查找
+@property (nonatomic, assign, readonly) BOOL allAtomsInterned;
+
+/// 返回类的映射表，第一次调用时创建并缓存
++ (instancetype)mappingForClass:(Class)cls;
+
+/// 查找 key 对应的属性
+///
+/// @return 属性信息，不存在或只读时返回 NULL
+- (const CZPropertyInfo *)propertyForKey:(NSString *)key;
+
+/// 按原子 ID 查找属性，只比较整数
+///
+/// 创建映射表时所有属性名都已登记，之后登记的 ID 一定不是本类的属性
+///
+/// @return 属性信息，不存在或只读时返回 NULL
+- (const CZPropertyInfo *)propertyForAtom:(cz_atom)atom;
+
+/// 把 JSON 值赋给对象的属性
+///
+/// NSNull 赋为 nil (数值属性跳过)，NSNumber 赋给字符串属性时转换为字符串，
+/// 数值属性接受 NSNumber 和 NSString
+- (void)setValue:(id)value forProperty:(const CZPropertyInfo *)property ofObject:(id)object;
+
+/// 把整数直接赋给属性，不创建 NSNumber
+///
+/// 数值属性按类型转换后写入成员变量 (offset < 0 时调用 setter)，
+/// 对象属性赋为 NSNumber，字符串属性赋为十进制字符串
+- (void)setInteger:(int64_t)value forProperty:(const CZPropertyInfo *)property ofObject:(id)object;
+
+/// 把浮点数直接赋给属性，不创建 NSNumber
+- (void)setDouble:(double)value forProperty:(const CZPropertyInfo *)property ofObject:(id)object;
+
+/// 使用字典给对象赋值，字典中没有对应属性的 key 被忽略
+- (void)setValuesWithDictionary:(NSDictionary *)dict toObject:(id)object;
+
+@end
@@ -0,0 +1,372 @@
+//
+//  CZClassMapping.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/23.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "CZClassMapping.h"
+#import "NSObject+CZRuntime.h"
+#import "cz_registry.h"
+#import <objc/runtime.h>
+
+/// 按类型写入整数
+static inline void CZWriteInteger(void *slot, char type, int64_t value) {
+    switch (type) {
+        case 'c': *(char *)slot = (char)value; break;
+        case 'C': *(unsigned char *)slot = (unsigned char)value; break;
+        case 's': *(short *)slot = (short)value; break;
+        case 'S': *(unsigned short *)slot = (unsigned short)value; break;
+        case 'i': *(int *)slot = (int)value; break;
+        case 'I': *(unsigned int *)slot = (unsigned int)value; break;
+        case 'l': *(long *)slot = (long)value; break;
+        case 'L': *(unsigned long *)slot = (unsigned long)value; break;
+        case 'q': *(long long *)slot = value; break;
+        case 'Q': *(unsigned long long *)slot = (unsigned long long)value; break;
+        case 'B': *(bool *)slot = value != 0; break;
+        case 'f': *(float *)slot = (float)value; break;
+        case 'd': *(double *)slot = (double)value; break;
+    }
+}
+
+/// 浮点数转为整数，向零取整
+///
+/// 超出 int64 范围的 double 直接转换是未定义行为：超出范围时取边界，NaN 为 0
+static inline int64_t CZIntegerFromDouble(double value) {
+    // 2^63，可以用 double 精确表示
+    const double limit = 9223372036854775808.0;
+    
+    if (value >= limit) {
+        return INT64_MAX;
+    }
+    if (value >= -limit) {
+        return (int64_t)value;
+    }
+    return value < 0 ? INT64_MIN : 0;
+}
+
+@implementation CZClassMapping {
+    /// 属性信息数组
+    CZPropertyInfo *_properties;
+    /// 持有属性名
+    NSArray<NSString *> *_names;
+    /// key -> CZPropertyInfo *
+    CFDictionaryRef _table;
+    /// 原子 ID -> CZPropertyInfo *，长度为创建时的最大 ID + 1
+    const CZPropertyInfo **_atomTable;
+    cz_atom _atomCount;
+}
+
+#pragma mark - 创建
+
+/// 类 -> 映射表
+static cz_registry *CZMappingRegistry(void) {
+    static cz_registry *registry;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        registry = cz_registry_create(1024);
+    });
+    return registry;
+}
+
++ (instancetype)mappingForClass:(Class)cls {
+    
+    // 查找注册表，读取不加锁
+    CZClassMapping *mapping = (__bridge CZClassMapping *)cz_registry_get(CZMappingRegistry(), (__bridge const void *)cls);
+    
+    if (mapping != nil) {
+        return mapping;
+    }
+    
+    // 多个线程同时创建时只有第一个发布的生效，其余的丢弃
+    mapping = [[self alloc] initWithClass:cls];
+    
+    return cz_registry_publish_object(CZMappingRegistry(), (__bridge const void *)cls, mapping);
+}
+
+- (instancetype)initWithClass:(Class)cls {
+    self = [super init];
+    if (self) {
+        _cls = cls;
+        
+        unsigned int count = 0;
+        objc_property_t *list = class_copyPropertyList(cls, &count);
+        
+        _properties = calloc(MAX(count, 1), sizeof(CZPropertyInfo));
+        NSMutableArray *names = [NSMutableArray arrayWithCapacity:count];
+        
+        NSUInteger n = 0;
+        for (unsigned int i = 0; i < count; i++) {
+            if ([self parseProperty:list[i] into:&_properties[n]]) {
+                [names addObject:_properties[n].name];
+                n++;
+            }
+        }
+        free(list);
+        
+        _names = names.copy;
+        _count = n;
+        
+        // 值直接保存属性信息的地址，不需要 retain
+        const void **keys = malloc(MAX(n, 1) * sizeof(void *));
+        const void **values = malloc(MAX(n, 1) * sizeof(void *));
+        for (NSUInteger i = 0; i < n; i++) {
+            keys[i] = (__bridge const void *)_properties[i].name;
+            values[i] = &_properties[i];
+        }
+        _table = CFDictionaryCreate(kCFAllocatorDefault, keys, values, n, &kCFTypeDictionaryKeyCallBacks, NULL);
+        free(keys);
+        free(values);
+        
+        // 登记属性名，按 ID 建立直接索引
+        for (NSUInteger i = 0; i < n; i++) {
+            const char *name = _properties[i].name.UTF8String;
+            _properties[i].atom = cz_atom_intern(name, strlen(name));
+        }
+        _allAtomsInterned = YES;
+        for (NSUInteger i = 0; i < n; i++) {
+            if (_properties[i].atom == CZ_ATOM_NONE) {
+                _allAtomsInterned = NO;
+            }
+        }
+        _atomCount = cz_atom_max() + 1;
+        _atomTable = calloc(_atomCount, sizeof(CZPropertyInfo *));
+        for (NSUInteger i = 0; i < n; i++) {
+            if (_properties[i].atom != CZ_ATOM_NONE) {
+                _atomTable[_properties[i].atom] = &_properties[i];
+            }
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_table != NULL) {
+        CFRelease(_table);
+    }
+    free(_properties);
+    free(_atomTable);
+}
+
+/// 解析属性的 setter 和类型，只读属性返回 NO
+- (BOOL)parseProperty:(objc_property_t)property into:(CZPropertyInfo *)info {
+    
+    NSString *name = [NSString stringWithUTF8String:property_getName(property)];
+    
+    unsigned int count = 0;
+    objc_property_attribute_t *attrs = property_copyAttributeList(property, &count);
+    
+    SEL setter = NULL;
+    const char *type = "";
+    const char *ivarName = NULL;
+    BOOL readonly = NO;
+    BOOL dynamic = NO;
+    
+    for (unsigned int i = 0; i < count; i++) {
+        switch (attrs[i].name[0]) {
+            case 'T':
+                type = attrs[i].value;
+                break;
+            case 'R':
+                readonly = YES;
+                break;
+            case 'S':
+                setter = sel_registerName(attrs[i].value);
+                break;
+            case 'V':
+                ivarName = attrs[i].value;
+                break;
+            case 'D':
+                dynamic = YES;
+                break;
+        }
+    }
+    
+    info->type = type[0];
+    info->cls = Nil;
+    info->offset = -1;
+    
+    // 类允许时，没有自定义 setter 的数值属性直接写入成员变量
+    if (strchr("cCsSiIlLqQBfd", info->type) != NULL && info->type != '\0' &&
+        ivarName != NULL && setter == NULL && !dynamic && [_cls cz_mapsScalarsDirectly]) {
+        Ivar ivar = class_getInstanceVariable(_cls, ivarName);
+        
+        if (ivar != NULL) {
+            info->offset = ivar_getOffset(ivar);
+        }
+    }
+    
+    // T@"NSString" -> NSString，id 类型为 T@
+    if (info->type == '@' && type[1] == '"') {
+        const char *begin = type + 2;
+        const char *end = strchr(begin, '"');
+        const char *protocol = strchr(begin, '<');
+        
+        if (end != NULL) {
+            if (protocol != NULL && protocol < end) {
+                end = protocol;
+            }
+            NSString *clsName = [[NSString alloc] initWithBytes:begin length:end - begin encoding:NSUTF8StringEncoding];
+            info->cls = NSClassFromString(clsName);
+        }
+    }
+    free(attrs);
+    
+    if (readonly) {
+        return NO;
+    }
+    
+    if (setter == NULL) {
+        NSString *first = [name substringToIndex:1].uppercaseString;
+        NSString *setterName = [NSString stringWithFormat:@"set%@%@:", first, [name substringFromIndex:1]];
+        setter = NSSelectorFromString(setterName);
+    }
+    
+    if (![_cls instancesRespondToSelector:setter]) {
+        return NO;
+    }
+    
+    info->name = name;
+    info->setter = setter;
+    info->imp = class_getMethodImplementation(_cls, setter);
+    
+    return YES;
+}
+
+#pragma mark - 查找
+
+- (const CZPropertyInfo *)propertyForKey:(NSString *)key {
+    return CFDictionaryGetValue(_table, (__bridge const void *)key);
+}
+
+- (const CZPropertyInfo *)propertyForAtom:(cz_atom)atom {
+    return atom < _atomCount ? _atomTable[atom] : NULL;
+}
+
+#pragma mark - 赋值
+
+- (void)setValue:(id)value forProperty:(const CZPropertyInfo *)property ofObject:(id)object {
+    
+    SEL sel = property->setter;
+    IMP imp = property->imp;
+    
+    // 1. 对象类型
+    if (property->type == '@') {
+        if (value == (id)kCFNull) {
+            value = nil;
+        } else if (property->cls == [NSString class] && [value isKindOfClass:[NSNumber class]]) {
+            value = [value stringValue];
+        }
+        ((void (*)(id, SEL, id))imp)(object, sel, value);
+        return;
+    }
+    
+    // 2. 数值类型，NSNull 和其他对象跳过
+    if (![value isKindOfClass:[NSNumber class]] && ![value isKindOfClass:[NSString class]]) {
+        return;
+    }
+    
+    switch (property->type) {
+        case 'f':
+        case 'd':
+            [self setDouble:[value doubleValue] forProperty:property ofObject:object];
+            break;
+        case 'B':
+            [self setInteger:[value boolValue] forProperty:property ofObject:object];
+            break;
+        case 'c': case 'C': case 's': case 'S': case 'i': case 'I':
+        case 'l': case 'L': case 'q': case 'Q':
+            [self setInteger:[value longLongValue] forProperty:property ofObject:object];
+            break;
+        default:
+            // 结构体等其他类型交给 KVC
+            [object setValue:value forKey:property->name];
+            break;
+    }
+}
+
+- (void)setInteger:(int64_t)value forProperty:(const CZPropertyInfo *)property ofObject:(id)object {
+    
+    // 1. 直接写入成员变量
+    if (property->offset >= 0) {
+        CZWriteInteger((uint8_t *)(__bridge void *)object + property->offset, property->type, value);
+        return;
+    }
+    
+    SEL sel = property->setter;
+    IMP imp = property->imp;
+    
+    // 2. 调用 setter
+    switch (property->type) {
+        case '@':
+            if (property->cls == [NSString class]) {
+                ((void (*)(id, SEL, id))imp)(object, sel, [NSString stringWithFormat:@"%lld", value]);
+            } else {
+                ((void (*)(id, SEL, id))imp)(object, sel, @(value));
+            }
+            break;
+        case 'c': ((void (*)(id, SEL, char))imp)(object, sel, (char)value); break;
+        case 'C': ((void (*)(id, SEL, unsigned char))imp)(object, sel, (unsigned char)value); break;
+        case 's': ((void (*)(id, SEL, short))imp)(object, sel, (short)value); break;
+        case 'S': ((void (*)(id, SEL, unsigned short))imp)(object, sel, (unsigned short)value); break;
+        case 'i': ((void (*)(id, SEL, int))imp)(object, sel, (int)value); break;
+        case 'I': ((void (*)(id, SEL, unsigned int))imp)(object, sel, (unsigned int)value); break;
+        case 'l': ((void (*)(id, SEL, long))imp)(object, sel, (long)value); break;
+        case 'L': ((void (*)(id, SEL, unsigned long))imp)(object, sel, (unsigned long)value); break;
+        case 'q': ((void (*)(id, SEL, long long))imp)(object, sel, value); break;
+        case 'Q': ((void (*)(id, SEL, unsigned long long))imp)(object, sel, (unsigned long long)value); break;
+        case 'B': ((void (*)(id, SEL, bool))imp)(object, sel, value != 0); break;
+        case 'f': ((void (*)(id, SEL, float))imp)(object, sel, (float)value); break;
+        case 'd': ((void (*)(id, SEL, double))imp)(object, sel, (double)value); break;
+        default:
+            [object setValue:@(value) forKey:property->name];
+            break;
+    }
+}
+
+- (void)setDouble:(double)value forProperty:(const CZPropertyInfo *)property ofObject:(id)object {
+    
+    switch (property->type) {
+        case 'f':
+            if (property->offset >= 0) {
+                *(float *)((uint8_t *)(__bridge void *)object + property->offset) = (float)value;
+            } else {
+                ((void (*)(id, SEL, float))property->imp)(object, property->setter, (float)value);
+            }
+            break;
+        case 'd':
+            if (property->offset >= 0) {
+                *(double *)((uint8_t *)(__bridge void *)object + property->offset) = value;
+            } else {
+                ((void (*)(id, SEL, double))property->imp)(object, property->setter, value);
+            }
+            break;
+        case '@':
+            if (property->cls == [NSString class]) {
+                ((void (*)(id, SEL, id))property->imp)(object, property->setter, @(value).stringValue);
+            } else {
+                ((void (*)(id, SEL, id))property->imp)(object, property->setter, @(value));
+            }
+            break;
+        case 'c': case 'C': case 's': case 'S': case 'i': case 'I':
+        case 'l': case 'L': case 'q': case 'Q': case 'B':
+            [self setInteger:CZIntegerFromDouble(value) forProperty:property ofObject:object];
+            break;
+        default:
+            [object setValue:@(value) forKey:property->name];
+            break;
+    }
+}
+
+- (void)setValuesWithDictionary:(NSDictionary *)dict toObject:(id)object {
+    [dict enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+        const CZPropertyInfo *property = [self propertyForKey:key];
+        
+        if (property != NULL) {
+            [self setValue:value forProperty:property ofObject:object];
+        }
+    }];
+}
+
+@end
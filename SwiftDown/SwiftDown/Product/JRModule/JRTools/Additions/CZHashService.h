@@ -0,0 +1,87 @@
+//
+//  CZHashService.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/19.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "NSString+CZHash.h"
+
+/// 文件散列完成回调，在主线程执行
+///
+/// @param hashes 与 -cz_fileHashesWithTypes: 相同，文件无法读取或 types 中没有可用的算法时为 nil
+typedef void (^CZHashCompletion)(NSDictionary<NSNumber *, NSString *> *hashes);
+
+/// 一个文件散列任务
+///
+/// 通过 queuePriority 调整优先级；文件不再需要时调用 -cancel，
+/// 执行中的任务在读完当前数据块后停止，已取消的任务不会回调。
+/// 散列计算完成后任务不能再取消，-cancel 无效，回调照常执行
+@interface CZHashTask : NSOperation
+
+/// 文件路径
+@property (nonatomic, copy, readonly) NSString *path;
+
+/// 散列算法
+@property (nonatomic, assign, readonly) CZFileHashType types;
+
+@end
+
+/// 异步文件散列服务
+///
+/// 任务在有界的后台队列中按优先级执行，调用方线程不会被文件读取阻塞
+@interface CZHashService : NSObject
+
+/// 共享服务，最多同时执行 2 个任务
++ (instancetype)sharedService;
+
+/// 创建服务
+///
+/// @param count 最大并发任务数，同时读取的文件过多只会互相争抢磁盘
+- (instancetype)initWithMaxConcurrentCount:(NSInteger)count;
+
+/// 提交文件散列任务
+///
+/// @param path       文件路径
+/// @param types      散列算法，可以组合，只读取一遍文件
+/// @param priority   队列优先级
+/// @param completion 完成回调
+///
+/// @return 任务，可以用来取消或调整优先级
+- (CZHashTask *)hashFileAtPath:(NSString *)path
+                         types:(CZFileHashType)types
+                      priority:(NSOperationQueuePriority)priority
+                    completion:(CZHashCompletion)completion;
+
+/// 取消所有任务
+- (void)cancelAllTasks;
+
+#pragma mark - 统计
+
+/// 排队中和执行中的任务数
+@property (nonatomic, assign, readonly) NSUInteger queueDepth;
+
+/// 执行中的任务数
+@property (nonatomic, assign, readonly) NSUInteger runningCount;
+
+/// 已完成 (含失败) 的任务数
+@property (nonatomic, assign, readonly) NSUInteger completedCount;
+
+/// 读取失败的任务数
+@property (nonatomic, assign, readonly) NSUInteger failedCount;
+
+/// 已取消的任务数
+@property (nonatomic, assign, readonly) NSUInteger cancelledCount;
+
+/// 已完成任务的平均排队时间 (秒)
+@property (nonatomic, assign, readonly) NSTimeInterval averageWaitTime;
+
+/// 已完成任务的平均执行时间 (秒)
+@property (nonatomic, assign, readonly) NSTimeInterval averageRunTime;
+
+/// 已完成任务的最长执行时间 (秒)
+@property (nonatomic, assign, readonly) NSTimeInterval maxRunTime;
+
+@end
@@ -0,0 +1,228 @@
+//
+//  CZHashService.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/19.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "CZHashService.h"
+#import "cz_digest.h"
+#import <QuartzCore/QuartzCore.h>
+
+@interface CZHashService ()
+
+- (void)task:(CZHashTask *)task didFinishWithWaitTime:(NSTimeInterval)wait runTime:(NSTimeInterval)run failed:(BOOL)failed;
+- (void)taskDidCancel:(CZHashTask *)task;
+
+@end
+
+#pragma mark - CZHashTask
+
+/// 任务状态，完成和取消只有一个能成立
+typedef NS_ENUM(int, CZHashTaskState) {
+    CZHashTaskStatePending = 0,
+    CZHashTaskStateCompleted,
+    CZHashTaskStateCancelled,
+};
+
+@implementation CZHashTask {
+    /// CZHashTaskState，完成或取消时从 Pending 原子地切换一次
+    int _state;
+    /// 供 C 代码读取的取消标记
+    int _cancelFlag;
+    CFTimeInterval _enqueueTime;
+    CZHashCompletion _completion;
+    __weak CZHashService *_service;
+}
+
+- (instancetype)initWithPath:(NSString *)path types:(CZFileHashType)types service:(CZHashService *)service completion:(CZHashCompletion)completion {
+    self = [super init];
+    if (self) {
+        _path = path.copy;
+        _types = types;
+        _service = service;
+        _completion = [completion copy];
+        _enqueueTime = CACurrentMediaTime();
+    }
+    return self;
+}
+
+/// 从 Pending 切换到 state，已经完成或取消的任务返回 NO
+- (BOOL)transitionToState:(CZHashTaskState)state {
+    int expected = CZHashTaskStatePending;
+    return __atomic_compare_exchange_n(&_state, &expected, state, NO, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+- (void)cancel {
+    // 已经完成的任务取消无效，照常回调；取消只统计一次
+    if (![self transitionToState:CZHashTaskStateCancelled]) {
+        return;
+    }
+    __atomic_store_n(&_cancelFlag, 1, __ATOMIC_RELAXED);
+    [_service taskDidCancel:self];
+    [super cancel];
+}
+
+- (void)main {
+    if (self.isCancelled) {
+        return;
+    }
+    
+    CFTimeInterval start = CACurrentMediaTime();
+    
+    CZDigestMask mask = (CZDigestMask)_types & CZDigestMaskAll;
+    NSDictionary *hashes = nil;
+    
+    // 与 -cz_fileHashesWithTypes: 相同，没有可用的算法时不读取文件，结果为 nil
+    if (mask != 0) {
+        uint8_t buffer[CZDigestCount][CZ_DIGEST_MAX_LENGTH];
+        
+        int result = cz_multi_digest_file_cancellable(_path.fileSystemRepresentation, mask, &_cancelFlag, buffer);
+        if (result == 1) {
+            return;
+        }
+        if (result == 0) {
+            hashes = CZFileHashesDictionary(_types, buffer);
+        }
+    }
+    
+    // 读完时恰好被取消，按取消处理，不计入完成
+    if (![self transitionToState:CZHashTaskStateCompleted]) {
+        return;
+    }
+    
+    CFTimeInterval end = CACurrentMediaTime();
+    [_service task:self didFinishWithWaitTime:start - _enqueueTime runTime:end - start failed:hashes == nil];
+    
+    CZHashCompletion completion = _completion;
+    if (completion == nil) {
+        return;
+    }
+    
+    // 已完成的任务之后不能再被取消，一定回调
+    dispatch_async(dispatch_get_main_queue(), ^{
+        completion(hashes);
+    });
+}
+
+@end
+
+#pragma mark - CZHashService
+
+@implementation CZHashService {
+    NSOperationQueue *_queue;
+    
+    NSUInteger _completedCount;
+    NSUInteger _failedCount;
+    NSUInteger _cancelledCount;
+    NSTimeInterval _totalWaitTime;
+    NSTimeInterval _totalRunTime;
+    NSTimeInterval _maxRunTime;
+}
+
++ (instancetype)sharedService {
+    static CZHashService *instance;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[self alloc] initWithMaxConcurrentCount:2];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    return [self initWithMaxConcurrentCount:2];
+}
+
+- (instancetype)initWithMaxConcurrentCount:(NSInteger)count {
+    self = [super init];
+    if (self) {
+        _queue = [NSOperationQueue new];
+        _queue.name = @"com.youranmuye0.hash-service";
+        _queue.maxConcurrentOperationCount = MAX(count, 1);
+        _queue.qualityOfService = NSQualityOfServiceUtility;
+    }
+    return self;
+}
+
+- (CZHashTask *)hashFileAtPath:(NSString *)path types:(CZFileHashType)types priority:(NSOperationQueuePriority)priority completion:(CZHashCompletion)completion {
+    CZHashTask *task = [[CZHashTask alloc] initWithPath:path types:types service:self completion:completion];
+    task.queuePriority = priority;
+    
+    [_queue addOperation:task];
+    
+    return task;
+}
+
+- (void)cancelAllTasks {
+    [_queue cancelAllOperations];
+}
+
+#pragma mark - 统计
+
+- (void)task:(CZHashTask *)task didFinishWithWaitTime:(NSTimeInterval)wait runTime:(NSTimeInterval)run failed:(BOOL)failed {
+    @synchronized (self) {
+        _completedCount++;
+        _failedCount += failed ? 1 : 0;
+        _totalWaitTime += wait;
+        _totalRunTime += run;
+        _maxRunTime = MAX(_maxRunTime, run);
+    }
+}
+
+- (void)taskDidCancel:(CZHashTask *)task {
+    @synchronized (self) {
+        _cancelledCount++;
+    }
+}
+
+- (NSUInteger)queueDepth {
+    return _queue.operationCount;
+}
+
+- (NSUInteger)runningCount {
+    NSUInteger count = 0;
+    
+    for (NSOperation *op in _queue.operations) {
+        count += op.isExecuting ? 1 : 0;
+    }
+    return count;
+}
+
+- (NSUInteger)completedCount {
+    @synchronized (self) {
+        return _completedCount;
+    }
+}
+
+- (NSUInteger)failedCount {
+    @synchronized (self) {
+        return _failedCount;
+    }
+}
+
+- (NSUInteger)cancelledCount {
+    @synchronized (self) {
+        return _cancelledCount;
+    }
+}
+
+- (NSTimeInterval)averageWaitTime {
+    @synchronized (self) {
+        return _completedCount > 0 ? _totalWaitTime / _completedCount : 0;
+    }
+}
+
+- (NSTimeInterval)averageRunTime {
+    @synchronized (self) {
+        return _completedCount > 0 ? _totalRunTime / _completedCount : 0;
+    }
+}
+
+- (NSTimeInterval)maxRunTime {
+    @synchronized (self) {
+        return _maxRunTime;
+    }
+}
+
+@end
@@ -0,0 +1,49 @@
+//
+//  CZHmac.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/14.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "NSString+CZHash.h"
+#import "cz_hmac.h"
+
+/// 绑定密钥的 HMAC 计算器
+///
+/// 创建时一次性算好 key ^ ipad / key ^ opad 两个分组的散列状态，
+/// 之后每条消息只复制状态，适合固定密钥的请求签名
+@interface CZHmac : NSObject
+
+/// 散列算法
+@property (nonatomic, readonly) CZHashAlgorithm algorithm;
+
+/// 结果长度 (字节)
+@property (nonatomic, readonly) NSUInteger digestLength;
+
+/// 预处理好的密钥，配合 cz_hmac_begin 分段计算
+@property (nonatomic, readonly) const cz_hmac_key *key;
+
+/// 使用密钥创建计算器
+///
+/// @param key       密钥 (UTF8)，nil 按空密钥处理
+/// @param algorithm 散列算法
+///
+/// @return algorithm 不是 CZHashAlgorithm 中的值时返回 nil
+- (instancetype)initWithKey:(NSString *)key algorithm:(CZHashAlgorithm)algorithm;
+
+/// 共享计算器，按密钥和算法缓存，参数与 -initWithKey:algorithm: 相同
++ (instancetype)sharedHmacWithKey:(NSString *)key algorithm:(CZHashAlgorithm)algorithm;
+
+/// 计算 HMAC
+///
+/// @param bytes  消息
+/// @param length 消息长度
+/// @param output 结果，至少 digestLength 字节
+- (void)hmacBytes:(const void *)bytes length:(NSUInteger)length output:(uint8_t *)output;
+
+/// 计算 HMAC，返回二进制结果
+- (NSData *)hmacForData:(NSData *)data;
+
+@end
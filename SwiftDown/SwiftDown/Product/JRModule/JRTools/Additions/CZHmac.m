@@ -0,0 +1,78 @@
+//
+//  CZHmac.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/14.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "CZHmac.h"
+
+@implementation CZHmac {
+    cz_hmac_key _key;
+}
+
+- (instancetype)initWithKey:(NSString *)key algorithm:(CZHashAlgorithm)algorithm {
+    if (algorithm > CZHashAlgorithmSHA512) {
+        return nil;
+    }
+    
+    self = [super init];
+    if (self) {
+        NSData *keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+        
+        _algorithm = algorithm;
+        cz_hmac_key_init(&_key, (CZDigestAlgorithm)algorithm, keyData.bytes, keyData.length);
+    }
+    return self;
+}
+
++ (instancetype)sharedHmacWithKey:(NSString *)key algorithm:(CZHashAlgorithm)algorithm {
+    if (algorithm > CZHashAlgorithmSHA512) {
+        return nil;
+    }
+    // nil 与 -initWithKey:algorithm: 一样按空密钥处理，NSCache 不接受 nil 作为 key
+    key = key ?: @"";
+    
+    // 每种算法一个缓存，查找时不需要拼接 key
+    static NSCache *caches[CZHashAlgorithmSHA512 + 1];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for (NSUInteger i = 0; i <= CZHashAlgorithmSHA512; i++) {
+            caches[i] = [NSCache new];
+            caches[i].countLimit = 8;
+        }
+    });
+    
+    NSCache *cache = caches[algorithm];
+    
+    CZHmac *hmac = [cache objectForKey:key];
+    if (hmac == nil) {
+        hmac = [[self alloc] initWithKey:key algorithm:algorithm];
+        [cache setObject:hmac forKey:key.copy];
+    }
+    
+    return hmac;
+}
+
+- (const cz_hmac_key *)key {
+    return &_key;
+}
+
+- (NSUInteger)digestLength {
+    return cz_digest_length((CZDigestAlgorithm)_algorithm);
+}
+
+- (void)hmacBytes:(const void *)bytes length:(NSUInteger)length output:(uint8_t *)output {
+    cz_hmac(&_key, bytes, length, output);
+}
+
+- (NSData *)hmacForData:(NSData *)data {
+    NSMutableData *result = [NSMutableData dataWithLength:self.digestLength];
+    
+    [self hmacBytes:data.bytes length:data.length output:result.mutableBytes];
+    
+    return result.copy;
+}
+
+@end
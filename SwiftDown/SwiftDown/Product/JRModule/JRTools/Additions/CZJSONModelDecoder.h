@@ -0,0 +1,51 @@
+//
+//  CZJSONModelDecoder.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/24.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// 流式 JSON -> 模型解码
+///
+/// 直接扫描响应数据，逐个对象创建模型并通过 CZClassMapping 赋值，
+/// 不经过 NSJSONSerialization 生成的字典 / 数组树：
+///
+/// - 字符串和数字直接从原始数据解析，整数、浮点数不装箱
+/// - key 按原始字节查到原子 ID 后按整数分派，模型中没有的 key 整段跳过
+/// - 对象类型属性遇到嵌套的字典、数组时，只把这一段交给 NSJSONSerialization
+@interface CZJSONModelDecoder : NSObject
+
+/// 解码 keyPath 处的数组，keyPath 处是对象时返回一个元素的数组
+///
+/// @param cls     模型类
+/// @param data    JSON 数据
+/// @param keyPath 用 '.' 分隔的路径，如 @"result.chapterList"，nil 表示顶层
+///
+/// @return 模型数组，JSON 格式错误或路径不存在时返回 nil
++ (NSArray *)objectsOfClass:(Class)cls fromData:(NSData *)data keyPath:(NSString *)keyPath
+    NS_SWIFT_NAME(objects(of:from:keyPath:));
+
+/// 逐个解码 keyPath 处数组中的对象
+///
+/// 每解码完一个对象调用一次 block，*stop 置为 YES 后不再扫描剩余数据
+///
+/// @return JSON 格式错误或路径不存在时返回 NO
++ (BOOL)enumerateObjectsOfClass:(Class)cls
+                       fromData:(NSData *)data
+                        keyPath:(NSString *)keyPath
+                     usingBlock:(void (^)(id object, BOOL *stop))block
+    NS_SWIFT_NAME(enumerateObjects(of:from:keyPath:using:));
+
+/// 取出 keyPath 处的单个值，不解析其余部分
+///
+/// 用于在解码大数组之前检查 code 等字段；标量直接装箱 (NSString / NSNumber / NSNull)，
+/// 字典、数组交给 NSJSONSerialization
+///
+/// @return JSON 格式错误或路径不存在时返回 nil
++ (id)valueAtKeyPath:(NSString *)keyPath fromData:(NSData *)data
+    NS_SWIFT_NAME(value(atKeyPath:from:));
+
+@end
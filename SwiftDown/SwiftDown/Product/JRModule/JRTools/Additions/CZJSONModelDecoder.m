@@ -0,0 +1,338 @@
+//
+//  CZJSONModelDecoder.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/24.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "CZJSONModelDecoder.h"
+#import "CZClassMapping.h"
+#import "cz_json.h"
+
+@implementation CZJSONModelDecoder
+
+#pragma mark - 公共方法
+
++ (NSArray *)objectsOfClass:(Class)cls fromData:(NSData *)data keyPath:(NSString *)keyPath {
+    
+    NSMutableArray *objects = [NSMutableArray array];
+    
+    BOOL success = [self enumerateObjectsOfClass:cls fromData:data keyPath:keyPath usingBlock:^(id object, BOOL *stop) {
+        [objects addObject:object];
+    }];
+    
+    return success ? objects.copy : nil;
+}
+
++ (BOOL)enumerateObjectsOfClass:(Class)cls
+                       fromData:(NSData *)data
+                        keyPath:(NSString *)keyPath
+                     usingBlock:(void (^)(id, BOOL *))block {
+    
+    if (cls == Nil || data == nil) {
+        return NO;
+    }
+    
+    cz_json_parser parser;
+    cz_json_init(&parser, data.bytes, data.length);
+    
+    // 1. 找到 keyPath 处的值
+    CZJSONToken token = cz_json_next(&parser);
+    
+    if (![self seekKeyPath:keyPath parser:&parser token:&token]) {
+        return NO;
+    }
+    
+    CZClassMapping *mapping = [CZClassMapping mappingForClass:cls];
+    BOOL stop = NO;
+    
+    // 2. 单个对象
+    if (token == CZJSONObjectBegin) {
+        id object = [self decodeObjectOfClass:cls mapping:mapping parser:&parser];
+        
+        if (object == nil) {
+            return NO;
+        }
+        block(object, &stop);
+        return YES;
+    }
+    
+    if (token != CZJSONArrayBegin) {
+        return NO;
+    }
+    
+    // 3. 数组，逐个解码，非对象元素跳过
+    while (!stop) {
+        token = cz_json_next(&parser);
+        
+        if (token == CZJSONArrayEnd) {
+            break;
+        }
+        if (token != CZJSONObjectBegin) {
+            if (cz_json_skip(&parser, token) != 0) {
+                return NO;
+            }
+            continue;
+        }
+        
+        @autoreleasepool {
+            id object = [self decodeObjectOfClass:cls mapping:mapping parser:&parser];
+            
+            if (object == nil) {
+                return NO;
+            }
+            block(object, &stop);
+        }
+    }
+    
+    return YES;
+}
+
++ (id)valueAtKeyPath:(NSString *)keyPath fromData:(NSData *)data {
+    
+    if (data == nil) {
+        return nil;
+    }
+    
+    cz_json_parser parser;
+    cz_json_init(&parser, data.bytes, data.length);
+    
+    CZJSONToken token = cz_json_next(&parser);
+    
+    if (![self seekKeyPath:keyPath parser:&parser token:&token]) {
+        return nil;
+    }
+    
+    switch (token) {
+        case CZJSONInteger:
+            return @(parser.integer);
+            
+        case CZJSONDouble:
+            return @(parser.number);
+            
+        case CZJSONTrue:
+        case CZJSONFalse:
+            return @(token == CZJSONTrue);
+            
+        case CZJSONNull:
+            return [NSNull null];
+            
+        case CZJSONString:
+            return [self stringWithParser:&parser];
+            
+        case CZJSONObjectBegin:
+        case CZJSONArrayBegin: {
+            const char *begin = cz_json_position(&parser) - 1;
+            
+            if (cz_json_skip(&parser, token) != 0) {
+                return nil;
+            }
+            
+            NSData *value = [NSData dataWithBytesNoCopy:(void *)begin
+                                                 length:cz_json_position(&parser) - begin
+                                           freeWhenDone:NO];
+            return [NSJSONSerialization JSONObjectWithData:value options:0 error:NULL];
+        }
+            
+        default:
+            return nil;
+    }
+}
+
+#pragma mark - 路径
+
+/// 从 *token 开始依次查找 keyPath 的每一段，成功时 *token 为对应值的第一个 token
++ (BOOL)seekKeyPath:(NSString *)keyPath parser:(cz_json_parser *)parser token:(CZJSONToken *)token {
+    
+    for (NSString *component in [keyPath componentsSeparatedByString:@"."]) {
+        if (component.length == 0) {
+            continue;
+        }
+        if (![self seekKey:component parser:parser token:token]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+/// 在 *token 开始的对象中查找 key，成功时 *token 为 key 对应值的第一个 token
++ (BOOL)seekKey:(NSString *)key parser:(cz_json_parser *)parser token:(CZJSONToken *)token {
+    
+    if (*token != CZJSONObjectBegin) {
+        return NO;
+    }
+    
+    const char *name = key.UTF8String;
+    size_t length = strlen(name);
+    
+    while (YES) {
+        CZJSONToken t = cz_json_next(parser);
+        
+        if (t != CZJSONKey) {
+            return NO;
+        }
+        
+        BOOL match;
+        if (parser->str_escaped) {
+            char *buffer = malloc(parser->str_len);
+            size_t len = cz_json_unescape(parser->str, parser->str_len, buffer);
+            match = len == length && memcmp(buffer, name, length) == 0;
+            free(buffer);
+        } else {
+            match = parser->str_len == length && memcmp(parser->str, name, length) == 0;
+        }
+        
+        t = cz_json_next(parser);
+        if (match) {
+            *token = t;
+            return YES;
+        }
+        if (cz_json_skip(parser, t) != 0) {
+            return NO;
+        }
+    }
+}
+
+#pragma mark - 对象
+
+/// 解码一个对象，parser 位于 '{' 之后，返回时位于对应的 '}' 之后
++ (id)decodeObjectOfClass:(Class)cls mapping:(CZClassMapping *)mapping parser:(cz_json_parser *)parser {
+    
+    id object = [cls new];
+    
+    while (YES) {
+        CZJSONToken token = cz_json_next(parser);
+        
+        if (token == CZJSONObjectEnd) {
+            return object;
+        }
+        if (token != CZJSONKey) {
+            return nil;
+        }
+        
+        // 1. 按原子 ID 查找属性，不创建 key 字符串
+        const CZPropertyInfo *property = [mapping propertyForAtom:cz_json_key_atom(parser)];
+        
+        if (property == NULL && !mapping.allAtomsInterned) {
+            property = [self propertyForKeyWithParser:parser mapping:mapping];
+        }
+        
+        // 2. 赋值，没有对应属性时跳过整个值
+        token = cz_json_next(parser);
+        
+        if (property == NULL) {
+            if (cz_json_skip(parser, token) != 0) {
+                return nil;
+            }
+            continue;
+        }
+        
+        if (![self setToken:token property:property mapping:mapping object:object parser:parser]) {
+            return nil;
+        }
+    }
+}
+
+/// 原子表已满时按字符串查找当前 key
++ (const CZPropertyInfo *)propertyForKeyWithParser:(cz_json_parser *)parser mapping:(CZClassMapping *)mapping {
+    
+    NSString *key = [self stringWithParser:parser];
+    
+    return key != nil ? [mapping propertyForKey:key] : NULL;
+}
+
+/// 把 token 开始的值赋给属性
++ (BOOL)setToken:(CZJSONToken)token
+        property:(const CZPropertyInfo *)property
+         mapping:(CZClassMapping *)mapping
+          object:(id)object
+          parser:(cz_json_parser *)parser {
+    
+    switch (token) {
+        case CZJSONInteger:
+            [mapping setInteger:parser->integer forProperty:property ofObject:object];
+            return YES;
+            
+        case CZJSONDouble:
+            [mapping setDouble:parser->number forProperty:property ofObject:object];
+            return YES;
+            
+        case CZJSONTrue:
+        case CZJSONFalse:
+            [mapping setInteger:token == CZJSONTrue forProperty:property ofObject:object];
+            return YES;
+            
+        case CZJSONNull:
+            [mapping setValue:(id)kCFNull forProperty:property ofObject:object];
+            return YES;
+            
+        case CZJSONString: {
+            // 字符串只赋给字符串、id 和数值属性
+            BOOL isString = property->type == '@' && (property->cls == Nil || [property->cls isSubclassOfClass:[NSString class]]);
+            
+            if (property->type == '@' && !isString) {
+                return YES;
+            }
+            
+            NSString *string = [self stringWithParser:parser];
+            
+            if (string == nil) {
+                return NO;
+            }
+            if (isString && property->cls != Nil && property->cls != [NSString class]) {
+                string = [property->cls stringWithString:string];
+            }
+            [mapping setValue:string forProperty:property ofObject:object];
+            return YES;
+        }
+            
+        case CZJSONObjectBegin:
+        case CZJSONArrayBegin: {
+            // 嵌套的值只赋给对象属性，这一段交给 NSJSONSerialization
+            const char *begin = cz_json_position(parser) - 1;
+            
+            if (cz_json_skip(parser, token) != 0) {
+                return NO;
+            }
+            if (property->type != '@') {
+                return YES;
+            }
+            
+            NSData *data = [NSData dataWithBytesNoCopy:(void *)begin
+                                                length:cz_json_position(parser) - begin
+                                          freeWhenDone:NO];
+            id value = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+            
+            if (value != nil && (property->cls == Nil || [value isKindOfClass:property->cls])) {
+                [mapping setValue:value forProperty:property ofObject:object];
+            }
+            return YES;
+        }
+            
+        default:
+            return NO;
+    }
+}
+
+/// 当前字符串或 key 的内容，UTF8 不合法时返回 nil
++ (NSString *)stringWithParser:(cz_json_parser *)parser {
+    
+    if (!parser->str_escaped) {
+        return [[NSString alloc] initWithBytes:parser->str length:parser->str_len encoding:NSUTF8StringEncoding];
+    }
+    
+    // 转义后不会变长
+    char *buffer = malloc(MAX(parser->str_len, 1));
+    size_t length = cz_json_unescape(parser->str, parser->str_len, buffer);
+    
+    NSString *string = nil;
+    if (length != (size_t)-1) {
+        string = [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+    }
+    free(buffer);
+    
+    return string;
+}
+
+@end
@@ -0,0 +1,63 @@
+//
+//  CZResumableHasher.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/17.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "NSString+CZHash.h"
+
+/// 可以保存、恢复进度的文件散列
+///
+/// 下载过程中每收到一段数据就追加一次，随时把中间状态存成 checkpoint，
+/// App 被杀后从 checkpoint 继续，最后一个字节写完时散列也随之完成，
+/// 不需要再完整读一遍文件
+///
+/// 只支持 SHA1 / SHA224 / SHA256，其他算法的状态由 CommonCrypto 持有，格式不稳定
+@interface CZResumableHasher : NSObject
+
+/// 散列算法
+@property (nonatomic, readonly) CZHashAlgorithm algorithm;
+
+/// 已经散列的字节数，也是下次 appendFileAtPath: 开始读取的位置
+@property (nonatomic, readonly) unsigned long long processedLength;
+
+/// 创建新的散列
+///
+/// @param algorithm 散列算法，不支持时返回 nil
+- (instancetype)initWithAlgorithm:(CZHashAlgorithm)algorithm;
+
+/// 从 checkpoint 恢复
+///
+/// @param checkpoint -checkpoint 返回的数据，格式错误时返回 nil
+- (instancetype)initWithCheckpoint:(NSData *)checkpoint;
+
+/// 从 checkpoint 文件恢复，文件不存在或格式错误时返回 nil
++ (instancetype)hasherWithCheckpointFile:(NSString *)path;
+
+/// 追加数据
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length;
+- (void)appendData:(NSData *)data;
+
+/// 从 processedLength 处读取文件直到末尾
+///
+/// 文件仍在增长时可以反复调用，每次只读取新写入的部分
+///
+/// @return 文件无法读取，或文件比 processedLength 短时返回 NO
+- (BOOL)appendFileAtPath:(NSString *)path;
+
+/// 当前中间状态，可以写入磁盘，之后用 -initWithCheckpoint: 恢复
+- (NSData *)checkpoint;
+
+/// 原子地写入 checkpoint 文件
+- (BOOL)writeCheckpointToFile:(NSString *)path;
+
+/// 当前已追加数据的散列结果，不影响之后继续追加
+- (NSData *)finalHash;
+
+/// 当前已追加数据的散列结果 (十六进制字符串)
+- (NSString *)finalHashString;
+
+@end
@@ -0,0 +1,148 @@
+//
+//  CZResumableHasher.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/17.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "CZResumableHasher.h"
+#import "cz_digest.h"
+#import "cz_hex.h"
+#import <fcntl.h>
+#import <unistd.h>
+
+/// 每次从文件读取的字节数
+static const size_t CZResumableReadSize = 1 << 20;
+
+@implementation CZResumableHasher {
+    cz_digest_ctx _ctx;
+}
+
+- (instancetype)initWithAlgorithm:(CZHashAlgorithm)algorithm {
+    if (!cz_digest_resumable((CZDigestAlgorithm)algorithm)) {
+        return nil;
+    }
+    
+    self = [super init];
+    if (self) {
+        cz_digest_init(&_ctx, (CZDigestAlgorithm)algorithm);
+    }
+    return self;
+}
+
+- (instancetype)initWithCheckpoint:(NSData *)checkpoint {
+    self = [super init];
+    if (self) {
+        if (cz_digest_import(&_ctx, checkpoint.bytes, checkpoint.length) != 0) {
+            return nil;
+        }
+    }
+    return self;
+}
+
++ (instancetype)hasherWithCheckpointFile:(NSString *)path {
+    NSData *checkpoint = [NSData dataWithContentsOfFile:path];
+    
+    if (checkpoint == nil) {
+        return nil;
+    }
+    
+    return [[self alloc] initWithCheckpoint:checkpoint];
+}
+
+- (CZHashAlgorithm)algorithm {
+    return (CZHashAlgorithm)_ctx.alg;
+}
+
+- (unsigned long long)processedLength {
+    return cz_digest_processed(&_ctx);
+}
+
+#pragma mark - 追加数据
+
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    cz_digest_update(&_ctx, bytes, length);
+}
+
+- (void)appendData:(NSData *)data {
+    [data enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
+        cz_digest_update(&_ctx, bytes, byteRange.length);
+    }];
+}
+
+- (BOOL)appendFileAtPath:(NSString *)path {
+    int fd = open(path.fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) {
+        return NO;
+    }
+    
+    off_t end = lseek(fd, 0, SEEK_END);
+    off_t offset = (off_t)self.processedLength;
+    
+    if (end < offset) {
+        close(fd);
+        return NO;
+    }
+    
+    uint8_t *buffer = malloc(CZResumableReadSize);
+    BOOL success = YES;
+    
+    // 只读到打开时的文件末尾，之后写入的数据留给下一次调用
+    while (offset < end) {
+        size_t want = (size_t)MIN((off_t)CZResumableReadSize, end - offset);
+        ssize_t n = pread(fd, buffer, want, offset);
+        
+        if (n < 0) {
+            success = NO;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        
+        cz_digest_update(&_ctx, buffer, (size_t)n);
+        offset += n;
+    }
+    
+    free(buffer);
+    close(fd);
+    
+    return success;
+}
+
+#pragma mark - 保存状态
+
+- (NSData *)checkpoint {
+    uint8_t state[CZ_DIGEST_STATE_MAX_LENGTH];
+    size_t length = cz_digest_export(&_ctx, state);
+    
+    return [NSData dataWithBytes:state length:length];
+}
+
+- (BOOL)writeCheckpointToFile:(NSString *)path {
+    return [self.checkpoint writeToFile:path atomically:YES];
+}
+
+#pragma mark - 结果
+
+- (NSData *)finalHash {
+    // 在副本上结束计算，自身状态可以继续追加
+    cz_digest_ctx ctx = _ctx;
+    NSMutableData *result = [NSMutableData dataWithLength:cz_digest_length(ctx.alg)];
+    
+    cz_digest_final(&ctx, result.mutableBytes);
+    
+    return result.copy;
+}
+
+- (NSString *)finalHashString {
+    NSData *hash = self.finalHash;
+    char hex[2 * CZ_DIGEST_MAX_LENGTH];
+    
+    cz_hex_encode(hash.bytes, hash.length, hex);
+    
+    return [[NSString alloc] initWithBytes:hex length:2 * hash.length encoding:NSASCIIStringEncoding];
+}
+
+@end
@@ -0,0 +1,70 @@
+//
+//  CZTreeHash.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/13.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// 大文件的树形 SHA256 散列
+///
+/// 文件按 1MB 切块，各块在并发队列上同时计算叶子，再合并为根散列。
+/// 树的结构见 cz_tree_hash.h。单个块可以凭证明路径对照根散列校验，
+/// 不需要整个文件都下载完成
+@interface CZTreeHash : NSObject
+
+/// 切块大小
+@property (class, nonatomic, readonly) NSUInteger chunkSize;
+
+/// 根散列 (32 字节)
+@property (nonatomic, readonly) NSData *rootHash;
+
+/// 根散列的十六进制字符串
+@property (nonatomic, readonly) NSString *rootHashString;
+
+/// 块数
+@property (nonatomic, readonly) NSUInteger chunkCount;
+
+/// 计算文件的树形散列，叶子在全局并发队列上并行计算
+///
+/// 每块各自 pread，可用于仍在下载、写入的文件
+///
+/// @param path 文件路径
+///
+/// @return 文件无法读取返回 nil
++ (instancetype)treeHashWithFileAtPath:(NSString *)path;
+
+/// 同上，mapped 为 YES 时映射整个文件计算
+///
+/// 映射省去复制，但文件在计算过程中被截断会触发 SIGBUS，
+/// 只能用于已经下载完成、不会再修改的文件
+///
+/// @param path   文件路径
+/// @param mapped 是否映射文件
+///
+/// @return 文件无法读取返回 nil
++ (instancetype)treeHashWithFileAtPath:(NSString *)path mapped:(BOOL)mapped;
+
+/// 第 index 块的证明路径
+///
+/// @return 连续存放的兄弟节点，index 越界返回 nil
+- (NSData *)proofForChunkAtIndex:(NSUInteger)index;
+
+/// 校验单个块
+///
+/// @param chunk      块数据
+/// @param index      块序号
+/// @param chunkCount 文件总块数
+/// @param proof      证明路径
+/// @param rootHash   根散列
+///
+/// @return 块属于该根散列返回 YES
++ (BOOL)verifyChunk:(NSData *)chunk
+            atIndex:(NSUInteger)index
+         chunkCount:(NSUInteger)chunkCount
+              proof:(NSData *)proof
+           rootHash:(NSData *)rootHash;
+
+@end
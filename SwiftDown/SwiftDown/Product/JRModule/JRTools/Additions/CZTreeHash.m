@@ -0,0 +1,177 @@
+//
+//  CZTreeHash.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/13.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "CZTreeHash.h"
+#import "cz_tree_hash.h"
+#import "cz_file.h"
+#import "cz_hex.h"
+#import <errno.h>
+#import <fcntl.h>
+#import <sys/stat.h>
+#import <unistd.h>
+
+@interface CZTreeHash ()
+
+/// 全部叶子，用于生成证明路径
+@property (nonatomic, strong) NSData *leaves;
+
+@end
+
+@implementation CZTreeHash
+
++ (NSUInteger)chunkSize {
+    return CZ_TREE_CHUNK_SIZE;
+}
+
++ (instancetype)treeHashWithFileAtPath:(NSString *)path {
+    return [self treeHashWithFileAtPath:path mapped:NO];
+}
+
++ (instancetype)treeHashWithFileAtPath:(NSString *)path mapped:(BOOL)mapped {
+    NSData *leaves = [self leavesOfFileAtPath:path mapped:mapped];
+    if (leaves == nil) {
+        return nil;
+    }
+    
+    CZTreeHash *treeHash = [self new];
+    treeHash.leaves = leaves;
+    
+    return treeHash;
+}
+
+/// 并行计算所有叶子
++ (NSData *)leavesOfFileAtPath:(NSString *)path mapped:(BOOL)mapped {
+    const char *cPath = path.fileSystemRepresentation;
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    
+    // 1. 已完成的文件可以映射，各块直接从映射内存计算
+    cz_mapped_file file;
+    if (mapped && cz_mapped_file_open(&file, cPath) == 0) {
+        // 块数按映射长度计算，不能用之前 stat 的长度，文件可能已经变短
+        size_t count = cz_tree_chunk_count(file.length);
+        NSMutableData *leaves = [NSMutableData dataWithLength:count * CZ_TREE_HASH_LENGTH];
+        uint8_t *out = leaves.mutableBytes;
+        
+        dispatch_apply(count, queue, ^(size_t i) {
+            // 空文件只有一个空块，offset 不会超过映射长度
+            size_t offset = i * CZ_TREE_CHUNK_SIZE;
+            size_t len = MIN((size_t)CZ_TREE_CHUNK_SIZE, file.length - offset);
+            
+            cz_tree_leaf(file.bytes + offset, len, out + i * CZ_TREE_HASH_LENGTH);
+        });
+        cz_mapped_file_close(&file);
+        
+        return leaves.copy;
+    }
+    
+    // 2. 默认每块各自 pread，文件被截断时只是读到的块变短
+    int fd = open(cPath, O_RDONLY);
+    if (fd < 0) {
+        return nil;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return nil;
+    }
+    
+    size_t count = cz_tree_chunk_count((uint64_t)st.st_size);
+    NSMutableData *leaves = [NSMutableData dataWithLength:count * CZ_TREE_HASH_LENGTH];
+    uint8_t *out = leaves.mutableBytes;
+    
+    // 各块并发写入，用原子操作
+    __block int failed = 0;
+    
+    dispatch_apply(count, queue, ^(size_t i) {
+        uint8_t *buffer = malloc(CZ_TREE_CHUNK_SIZE);
+        off_t offset = (off_t)i * CZ_TREE_CHUNK_SIZE;
+        size_t len = 0;
+        
+        if (buffer == NULL) {
+            __atomic_store_n(&failed, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        
+        while (len < CZ_TREE_CHUNK_SIZE) {
+            ssize_t n = pread(fd, buffer + len, CZ_TREE_CHUNK_SIZE - len, offset + (off_t)len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // 读取出错不能当作文件结束，否则得到的是错误的根散列
+                __atomic_store_n(&failed, 1, __ATOMIC_RELAXED);
+                break;
+            }
+            if (n == 0) {
+                break;
+            }
+            len += (size_t)n;
+        }
+        
+        cz_tree_leaf(buffer, len, out + i * CZ_TREE_HASH_LENGTH);
+        free(buffer);
+    });
+    close(fd);
+    
+    return __atomic_load_n(&failed, __ATOMIC_RELAXED) ? nil : leaves.copy;
+}
+
+- (NSUInteger)chunkCount {
+    return self.leaves.length / CZ_TREE_HASH_LENGTH;
+}
+
+- (NSData *)rootHash {
+    uint8_t root[CZ_TREE_HASH_LENGTH];
+    
+    if (cz_tree_root(self.leaves.bytes, self.chunkCount, root) != 0) {
+        return nil;
+    }
+    
+    return [NSData dataWithBytes:root length:CZ_TREE_HASH_LENGTH];
+}
+
+- (NSString *)rootHashString {
+    NSData *root = self.rootHash;
+    char hex[2 * CZ_TREE_HASH_LENGTH];
+    
+    cz_hex_encode(root.bytes, root.length, hex);
+    
+    return [[NSString alloc] initWithBytes:hex length:2 * root.length encoding:NSASCIIStringEncoding];
+}
+
+- (NSData *)proofForChunkAtIndex:(NSUInteger)index {
+    uint8_t proof[CZ_TREE_MAX_PROOF * CZ_TREE_HASH_LENGTH];
+    
+    int count = cz_tree_proof(self.leaves.bytes, self.chunkCount, index, proof);
+    if (count < 0) {
+        return nil;
+    }
+    
+    return [NSData dataWithBytes:proof length:(NSUInteger)count * CZ_TREE_HASH_LENGTH];
+}
+
++ (BOOL)verifyChunk:(NSData *)chunk
+            atIndex:(NSUInteger)index
+         chunkCount:(NSUInteger)chunkCount
+              proof:(NSData *)proof
+           rootHash:(NSData *)rootHash {
+    
+    if (rootHash.length != CZ_TREE_HASH_LENGTH || proof.length % CZ_TREE_HASH_LENGTH != 0) {
+        return NO;
+    }
+    
+    uint8_t leaf[CZ_TREE_HASH_LENGTH];
+    cz_tree_leaf(chunk.bytes, chunk.length, leaf);
+    
+    return cz_tree_verify(leaf, index, chunkCount,
+                          proof.bytes, proof.length / CZ_TREE_HASH_LENGTH,
+                          rootHash.bytes) == 1;
+}
+
+@end
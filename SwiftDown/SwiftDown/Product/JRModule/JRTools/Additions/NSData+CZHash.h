@@ -0,0 +1,52 @@
+//
+//  NSData+CZHash.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/16.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "NSString+CZHash.h"
+
+/// 直接对二进制数据计算散列，不经过字符串转码
+@interface NSData (CZHash)
+
+/**
+ *  计算二进制散列结果
+ *
+ *  终端测试命令：
+ *  @code
+ *  openssl dgst -sha256 file.dat
+ *  @endcode
+ *
+ *  @param algorithm 散列算法
+ *
+ *  @return 二进制散列结果
+ */
+- (NSData *)cz_hashWithAlgorithm:(CZHashAlgorithm)algorithm;
+
+/**
+ *  计算散列字符串
+ *
+ *  @param algorithm 散列算法
+ *
+ *  @return 十六进制散列字符串
+ */
+- (NSString *)cz_hashStringWithAlgorithm:(CZHashAlgorithm)algorithm;
+
+/**
+ *  计算 64 位快速散列，不能用于签名和校验
+ *
+ *  @return 64 位散列值
+ */
+- (uint64_t)cz_fastHash;
+
+/**
+ *  计算 CRC32C 校验值，用于读取缓存时检查数据是否完整
+ *
+ *  @return CRC32C
+ */
+- (uint32_t)cz_crc32c;
+
+@end
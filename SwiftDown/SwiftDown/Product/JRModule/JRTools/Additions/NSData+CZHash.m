@@ -0,0 +1,70 @@
+//
+//  NSData+CZHash.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/16.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#import "NSData+CZHash.h"
+#import "cz_digest.h"
+#import "cz_hex.h"
+#import "cz_fasthash.h"
+#import "cz_crc32c.h"
+
+@implementation NSData (CZHash)
+
+- (NSData *)cz_hashWithAlgorithm:(CZHashAlgorithm)algorithm {
+    uint8_t buffer[CZ_DIGEST_MAX_LENGTH];
+    
+    [self cz_digest:(CZDigestAlgorithm)algorithm output:buffer];
+    
+    return [NSData dataWithBytes:buffer length:cz_digest_length((CZDigestAlgorithm)algorithm)];
+}
+
+- (NSString *)cz_hashStringWithAlgorithm:(CZHashAlgorithm)algorithm {
+    uint8_t buffer[CZ_DIGEST_MAX_LENGTH];
+    char hex[2 * CZ_DIGEST_MAX_LENGTH];
+    size_t length = cz_digest_length((CZDigestAlgorithm)algorithm);
+    
+    [self cz_digest:(CZDigestAlgorithm)algorithm output:buffer];
+    cz_hex_encode(buffer, length, hex);
+    
+    return [[NSString alloc] initWithBytes:hex length:2 * length encoding:NSASCIIStringEncoding];
+}
+
+- (uint64_t)cz_fastHash {
+    __block cz_fasthash_state state;
+    cz_fasthash_init(&state, 0);
+    
+    [self enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        cz_fasthash_update(&state, bytes, byteRange.length);
+    }];
+    
+    return cz_fasthash_final64(&state);
+}
+
+- (uint32_t)cz_crc32c {
+    __block uint32_t crc = 0;
+    
+    [self enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        crc = cz_crc32c(crc, bytes, byteRange.length);
+    }];
+    
+    return crc;
+}
+
+#pragma mark - 助手方法
+/// 逐段散列，不连续的 NSData (如 dispatch_data) 也不会被拼接复制
+- (void)cz_digest:(CZDigestAlgorithm)alg output:(uint8_t *)output {
+    __block cz_digest_ctx ctx;
+    cz_digest_init(&ctx, alg);
+    
+    [self enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        cz_digest_update(&ctx, bytes, byteRange.length);
+    }];
+    
+    cz_digest_final(&ctx, output);
+}
+
+@end
@@ -16,6 +16,23 @@
 /// @return 当前类对象的数组
 + (NSArray *)cz_objectsWithArray:(NSArray *)array;
 
+/// 多核并行使用字典数组创建当前类对象的数组，结果顺序与字典数组相同
+///
+/// 字典数组按 grainSize 分段，由 GCD 的全局队列在多个核心上并行创建对象；
+/// 元素不足两段时在当前线程创建。当前类的 init 和 setter 必须可以在后台线程调用
+///
+/// @param array     字典数组
+/// @param grainSize 每段的字典个数，0 表示按核心数自动选择
+///
+/// @return 当前类对象的数组
++ (NSArray *)cz_objectsWithArray:(NSArray *)array grainSize:(NSUInteger)grainSize;
+
+/// 字典转模型时数值属性是否直接写入成员变量，默认 NO (调用 setter)
+///
+/// 直接写入不经过 setter，重写的 setter、didSet、KVO 通知都不会触发；
+/// 确认数值属性没有这些副作用的模型在子类中重写并返回 YES
++ (BOOL)cz_mapsScalarsDirectly;
+
 /// 返回当前类的属性数组
 ///
 /// @return 属性数组
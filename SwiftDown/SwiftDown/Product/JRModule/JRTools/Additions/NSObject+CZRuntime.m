@@ -7,6 +7,8 @@
 //
 
 #import "NSObject+CZRuntime.h"
+#import "CZClassMapping.h"
+#import "cz_registry.h"
 #import <objc/runtime.h>
 
 @implementation NSObject (CZRuntime)
@@ -20,25 +22,18 @@
     // 断言是字典数组
     NSAssert([array[0] isKindOfClass:[NSDictionary class]], @"必须传入字典数组");
 
-    // 0. 获得属性数组
-    NSArray *list = [self cz_propertiesList];
+    // 0. 获得映射表，key 按散列查找，赋值使用缓存的 setter
+    CZClassMapping *mapping = [CZClassMapping mappingForClass:self];
     
     // 1. 遍历数组
-    NSMutableArray *arrayM = [NSMutableArray array];
+    NSMutableArray *arrayM = [NSMutableArray arrayWithCapacity:array.count];
     for (NSDictionary *dict in array) {
         
         // 2. 创建对象
         id obj = [self new];
         
-        // 3. 遍历字典
-        for (NSString *key in dict) {
-            // 判断字典中的 key 是否在成员变量中存在
-            if (![list containsObject:key]) {
-                continue;
-            }
-            
-            [obj setValue:dict[key] forKey:key];
-        }
+        // 3. 遍历字典，字典中的 key 在属性中不存在时忽略
+        [mapping setValuesWithDictionary:dict toObject:obj];
         
         // 4. 将对象添加到数组
         [arrayM addObject:obj];
@@ -47,12 +42,93 @@
     return arrayM.copy;
 }
 
-void *propertiesKey = "cn.itcast.propertiesList";
+/// 自动分段时每段的最少字典个数，太小时调度开销超过赋值本身
+static const NSUInteger CZMinimumGrainSize = 64;
+
++ (NSArray *)cz_objectsWithArray:(NSArray *)array grainSize:(NSUInteger)grainSize {
+    
+    NSUInteger count = array.count;
+    
+    if (count == 0) {
+        return nil;
+    }
+    
+    NSAssert([array[0] isKindOfClass:[NSDictionary class]], @"必须传入字典数组");
+    
+    // 1. 每个核心大约 4 段，耗时不均时空闲的线程可以继续取后面的段
+    if (grainSize == 0) {
+        NSUInteger cores = [NSProcessInfo processInfo].activeProcessorCount;
+        grainSize = MAX(count / (cores * 4), CZMinimumGrainSize);
+    }
+    
+    NSUInteger chunks = (count + grainSize - 1) / grainSize;
+    
+    if (chunks < 2) {
+        return [self cz_objectsWithArray:array];
+    }
+    
+    // 2. 映射表在当前线程创建，之后各线程只读
+    CZClassMapping *mapping = [CZClassMapping mappingForClass:self];
+    
+    // 3. 每段写入结果数组中自己的位置，不需要加锁，也保持原来的顺序
+    __strong id *objects = (__strong id *)calloc(count, sizeof(id));
+    Class cls = self;
+    
+    dispatch_apply(chunks, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t chunk) {
+        NSUInteger begin = chunk * grainSize;
+        NSUInteger end = MIN(begin + grainSize, count);
+        
+        @autoreleasepool {
+            for (NSUInteger i = begin; i < end; i++) {
+                id obj = [cls new];
+                [mapping setValuesWithDictionary:array[i] toObject:obj];
+                objects[i] = obj;
+            }
+        }
+    });
+    
+    NSArray *result = [NSArray arrayWithObjects:objects count:count];
+    
+    // 4. 释放临时数组持有的对象
+    for (NSUInteger i = 0; i < count; i++) {
+        objects[i] = nil;
+    }
+    free(objects);
+    
+    return result;
+}
+
++ (BOOL)cz_mapsScalarsDirectly {
+    return NO;
+}
+
+/// 注册表最多缓存的类
+static const size_t CZRegistryCapacity = 1024;
+
+/// 类 -> 属性名数组
+static cz_registry *CZPropertiesRegistry(void) {
+    static cz_registry *registry;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        registry = cz_registry_create(CZRegistryCapacity);
+    });
+    return registry;
+}
+
+/// 类 -> 成员变量名数组
+static cz_registry *CZIvarsRegistry(void) {
+    static cz_registry *registry;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        registry = cz_registry_create(CZRegistryCapacity);
+    });
+    return registry;
+}
 
 + (NSArray *)cz_propertiesList {
     
-    // 获取关联对象
-    NSArray *result = objc_getAssociatedObject(self, propertiesKey);
+    // 查找注册表，不加锁
+    NSArray *result = (__bridge NSArray *)cz_registry_get(CZPropertiesRegistry(), (__bridge const void *)self);
     
     if (result != nil) {
         return result;
@@ -77,18 +153,14 @@ void *propertiesKey = "cn.itcast.propertiesList";
     
     free(list);
     
-    // 设置关联对象
-    objc_setAssociatedObject(self, propertiesKey, arrayM, OBJC_ASSOCIATION_COPY_NONATOMIC);
-    
-    return objc_getAssociatedObject(self, propertiesKey);
+    // 发布到注册表，多个线程同时创建时都返回第一个发布的数组
+    return cz_registry_publish_object(CZPropertiesRegistry(), (__bridge const void *)self, arrayM.copy);
 }
 
-void *ivarsKey = "cn.itcast.ivarsList";
-
 + (NSArray *)cz_ivarsList {
     
-    // 获取关联对象
-    NSArray *result = objc_getAssociatedObject(self, ivarsKey);
+    // 查找注册表，不加锁
+    NSArray *result = (__bridge NSArray *)cz_registry_get(CZIvarsRegistry(), (__bridge const void *)self);
     
     if (result != nil) {
         return result;
@@ -113,10 +185,8 @@ void *ivarsKey = "cn.itcast.ivarsList";
     
     free(list);
     
-    // 设置关联对象
-    objc_setAssociatedObject(self, ivarsKey, arrayM, OBJC_ASSOCIATION_COPY_NONATOMIC);
-    
-    return objc_getAssociatedObject(self, ivarsKey);
+    // 发布到注册表
+    return cz_registry_publish_object(CZIvarsRegistry(), (__bridge const void *)self, arrayM.copy);
 }
 
 
@@ -6,6 +6,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "cz_base64.h"
 
 @interface NSString (CZBase64)
 
@@ -15,4 +16,25 @@
 /// 对当前字符串进行 BASE 64 解码，并且返回结果
 - (NSString *)cz_base64Decode;
 
+/// 对二进制数据进行 BASE 64 编码
+///
+/// @param data     二进制数据
+/// @param alphabet 字母表，URL 安全字母表不补 '='
++ (instancetype)cz_base64StringWithData:(NSData *)data alphabet:(CZBase64Alphabet)alphabet;
+
+/// 把当前字符串作为 BASE 64 解码为二进制数据，包含非法字符时返回 nil
+- (NSData *)cz_base64DecodedData;
+
+/// 把当前字符串作为 BASE 64 解码为二进制数据，包含非法字符时返回 nil
+///
+/// @param alphabet 字母表
+- (NSData *)cz_base64DecodedDataWithAlphabet:(CZBase64Alphabet)alphabet;
+
+/// 把当前字符串作为 BASE 64 解码后直接写入文件，不在内存中生成完整结果
+///
+/// @param path 文件路径
+///
+/// @return 包含非法字符或写入失败时返回 NO，已写入的文件会被删除
+- (BOOL)cz_base64DecodeToFile:(NSString *)path;
+
 @end
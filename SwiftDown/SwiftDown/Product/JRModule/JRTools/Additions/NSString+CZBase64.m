@@ -6,6 +6,7 @@
 //
 
 #import "NSString+CZBase64.h"
+#import "CZBase64Stream.h"
 
 @implementation NSString (CZBase64)
 
@@ -13,14 +14,102 @@
     
     NSData *data = [self dataUsingEncoding:NSUTF8StringEncoding];
     
-    return [data base64EncodedStringWithOptions:0];
+    return [NSString cz_base64StringWithData:data alphabet:CZBase64Standard];
 }
 
 - (NSString *)cz_base64Decode {
     
-    NSData *data = [[NSData alloc] initWithBase64EncodedString:self options:0];
+    size_t length = 0;
+    uint8_t *bytes = [self cz_base64DecodeWithAlphabet:CZBase64Standard length:&length];
+    if (bytes == NULL) {
+        return nil;
+    }
     
-    return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    // 解码结果直接交给字符串，不再经过 NSData 复制
+    NSString *result = [[NSString alloc] initWithBytesNoCopy:bytes length:length encoding:NSUTF8StringEncoding freeWhenDone:YES];
+    if (result == nil) {
+        free(bytes);
+    }
+    
+    return result;
+}
+
++ (instancetype)cz_base64StringWithData:(NSData *)data alphabet:(CZBase64Alphabet)alphabet {
+    
+    size_t capacity = CZ_BASE64_ENCODED_LENGTH(data.length);
+    char *chars = malloc(MAX(capacity, 1));
+    
+    size_t length = cz_base64_encode(data.bytes, data.length, chars, alphabet, alphabet == CZBase64Standard);
+    
+    return [[self alloc] initWithBytesNoCopy:chars length:length encoding:NSASCIIStringEncoding freeWhenDone:YES];
+}
+
+- (NSData *)cz_base64DecodedData {
+    return [self cz_base64DecodedDataWithAlphabet:CZBase64Standard];
+}
+
+- (NSData *)cz_base64DecodedDataWithAlphabet:(CZBase64Alphabet)alphabet {
+    
+    size_t length = 0;
+    uint8_t *bytes = [self cz_base64DecodeWithAlphabet:alphabet length:&length];
+    if (bytes == NULL) {
+        return nil;
+    }
+    
+    return [NSData dataWithBytesNoCopy:bytes length:length freeWhenDone:YES];
+}
+
+- (BOOL)cz_base64DecodeToFile:(NSString *)path {
+    
+    CZBase64Decoder *decoder = [[CZBase64Decoder alloc] initWithAlphabet:CZBase64Standard outputPath:path];
+    if (decoder == nil) {
+        return NO;
+    }
+    
+    BOOL success = [decoder appendString:self];
+    success = [decoder finish] && success;
+    
+    if (!success) {
+        [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    }
+    
+    return success;
+}
+
+#pragma mark - 助手方法
+/**
+ *  解码到新分配的缓冲区
+ *
+ *  @param alphabet 字母表
+ *  @param length   解码后的字节数
+ *
+ *  @return malloc 分配的缓冲区，由调用方释放；包含非法字符时返回 NULL
+ */
+- (uint8_t *)cz_base64DecodeWithAlphabet:(CZBase64Alphabet)alphabet length:(size_t *)length {
+    
+    // 1. 内部存储是 ASCII 时直接使用，否则转码 (非 ASCII 字符一定不合法)
+    NSUInteger count = self.length;
+    const char *chars = CFStringGetCStringPtr((__bridge CFStringRef)self, kCFStringEncodingASCII);
+    NSData *ascii = nil;
+    
+    if (chars == NULL) {
+        ascii = [self dataUsingEncoding:NSASCIIStringEncoding];
+        if (ascii == nil) {
+            return NULL;
+        }
+        chars = ascii.bytes;
+        count = ascii.length;
+    }
+    
+    // 2. 解码
+    uint8_t *bytes = malloc(MAX(CZ_BASE64_DECODED_MAX_LENGTH(count), 1));
+    
+    if (cz_base64_decode(chars, count, bytes, length, alphabet) != 0) {
+        free(bytes);
+        return NULL;
+    }
+    
+    return bytes;
 }
 
 @end
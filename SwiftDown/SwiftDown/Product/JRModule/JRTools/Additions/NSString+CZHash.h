@@ -7,6 +7,28 @@
 
 #import <Foundation/Foundation.h>
 
+/// 散列算法
+typedef NS_ENUM(NSUInteger, CZHashAlgorithm) {
+    CZHashAlgorithmMD5 = 0,
+    CZHashAlgorithmSHA1,
+    CZHashAlgorithmSHA224,
+    CZHashAlgorithmSHA256,
+    CZHashAlgorithmSHA384,
+    CZHashAlgorithmSHA512,
+};
+
+/// 文件散列算法，可以按位组合
+typedef NS_OPTIONS(NSUInteger, CZFileHashType) {
+    CZFileHashMD5       = 1 << 0,
+    CZFileHashSHA1      = 1 << 1,
+    CZFileHashSHA224    = 1 << 2,
+    CZFileHashSHA256    = 1 << 3,
+    CZFileHashSHA384    = 1 << 4,
+    CZFileHashSHA512    = 1 << 5,
+};
+
+@class CZHmac;
+
 @interface NSString (Hash)
 
 #pragma mark - 散列函数
@@ -84,6 +106,65 @@
  */
 - (NSString *)cz_sha512String;
 
+/**
+ *  计算二进制散列结果，不生成十六进制字符串
+ *
+ *  @param algorithm 散列算法
+ *
+ *  @return 二进制散列结果
+ */
+- (NSData *)cz_hashWithAlgorithm:(CZHashAlgorithm)algorithm;
+
+/**
+ *  计算散列结果，直接写入调用方的缓冲区
+ *
+ *  按字符串的完整 UTF8 字节计算，包含内嵌的 '\0'；
+ *  单独的代理项等不能转为 UTF8 的字符替换为 '?' (有损转换)
+ *
+ *  @param algorithm 散列算法
+ *  @param output    至少能容纳该算法的散列结果
+ */
+- (void)cz_hashWithAlgorithm:(CZHashAlgorithm)algorithm output:(uint8_t *)output;
+
+/**
+ *  计算散列字符串
+ *
+ *  @param algorithm 散列算法
+ *
+ *  @return 十六进制散列字符串
+ */
+- (NSString *)cz_hashStringWithAlgorithm:(CZHashAlgorithm)algorithm;
+
+/**
+ *  批量计算字符串的散列结果
+ *
+ *  MD5 / SHA1 / SHA256 会把多条字符串放进 SIMD 的不同通道同时计算，
+ *  适合一次性为大量章节、缓存 key 计算散列
+ *
+ *  @param strings   字符串数组
+ *  @param algorithm 散列算法
+ *
+ *  @return 二进制散列结果，第 i 个字符串的结果位于 [i * 长度, (i + 1) * 长度)
+ */
++ (NSData *)cz_batchHashes:(NSArray<NSString *> *)strings algorithm:(CZHashAlgorithm)algorithm;
+
+#pragma mark - 非加密散列函数
+/**
+ *  计算 64 位快速散列 (UTF8)
+ *
+ *  <p>提示：不抗碰撞攻击，只用于内存散列表等场景，不能用于签名和校验。<p>
+ *
+ *  @return 64 位散列值
+ */
+- (uint64_t)cz_fastHash;
+
+/**
+ *  计算 128 位快速散列 (UTF8)，适合作为缓存文件名
+ *
+ *  @return 32个字符的十六进制散列字符串，按大端输出，高 64 位在前
+ */
+- (NSString *)cz_fastHashString;
+
 #pragma mark - HMAC 散列函数
 /**
  *  计算HMAC MD5散列结果
@@ -133,6 +214,17 @@
  */
 - (NSString *)cz_hmacSHA512StringWithKey:(NSString *)key;
 
+/**
+ *  使用预先处理好密钥的计算器计算 HMAC 结果
+ *
+ *  同一个密钥反复签名时应持有一个 CZHmac，避免每次重新处理密钥
+ *
+ *  @param hmac 见 CZHmac
+ *
+ *  @return HMAC 散列字符串
+ */
+- (NSString *)cz_hmacStringWithHmac:(CZHmac *)hmac;
+
 #pragma mark - 文件散列函数
 
 /**
@@ -167,6 +259,8 @@
  *  openssl sha -sha256 file.dat
  *  @endcode
  *
+ *  每次都从头读取整个文件；边下载边校验请使用 CZResumableHasher
+ *
  *  @return 64个字符的SHA256散列字符串
  */
 - (NSString *)cz_fileSHA256Hash;
@@ -183,4 +277,41 @@
  */
 - (NSString *)cz_fileSHA512Hash;
 
+/**
+ *  只读取一遍文件，同时计算多个散列结果
+ *
+ *  终端测试命令：
+ *  @code
+ *  for alg in md5 sha1 sha256 sha512; do openssl dgst -$alg file.dat; done
+ *  @endcode
+ *
+ *  同步读取整个文件，不要在主线程调用大文件；异步计算请使用 CZHashService
+ *
+ *  大文件映射后直接散列，读取期间文件不能被截断；正在下载的文件请使用 CZHashService
+ *
+ *  @param types 散列算法组合
+ *
+ *  @return 以 @(CZFileHashType) 为 key 的散列字符串字典，文件无法读取返回 nil
+ */
+- (NSDictionary<NSNumber *, NSString *> *)cz_fileHashesWithTypes:(CZFileHashType)types;
+
+/**
+ *  把 cz_multi_digest_file 的结果转为 -cz_fileHashesWithTypes: 返回的字典，CZHashService 共用
+ *
+ *  @param types   散列算法组合
+ *  @param digests cz_multi_digest_file 的输出，每个算法 CZ_DIGEST_MAX_LENGTH 字节
+ *
+ *  @return 以 @(CZFileHashType) 为 key 的散列字符串字典
+ */
+FOUNDATION_EXPORT NSDictionary<NSNumber *, NSString *> *CZFileHashesDictionary(CZFileHashType types, const void *digests);
+
+/**
+ *  计算文件的 CRC32C 校验值
+ *
+ *  只用于发现缓存文件写入不完整，速度接近内存带宽，不能代替散列校验
+ *
+ *  @return uint32_t 校验值，文件无法读取返回 nil
+ */
+- (NSNumber *)cz_fileCRC32C;
+
 @end
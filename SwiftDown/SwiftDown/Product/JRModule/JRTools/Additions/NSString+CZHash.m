@@ -7,219 +7,271 @@
 
 #import "NSString+CZHash.h"
 #import <CommonCrypto/CommonCrypto.h>
+#import "cz_digest.h"
+#import "cz_batch.h"
+#import "CZHmac.h"
+#import "cz_hex.h"
+#import "cz_hmac.h"
+#import "cz_fasthash.h"
+#import "cz_crc32c.h"
 
 @implementation NSString (Hash)
 
-#pragma mark - 散列函数
-- (NSString *)cz_md5String {
-    const char *str = self.UTF8String;
-    uint8_t buffer[CC_MD5_DIGEST_LENGTH];
+#pragma mark - 字节遍历
+/**
+ *  把字符串的 UTF8 字节分段交给 fn，不生成完整的 UTF8 副本，也不需要 strlen
+ *
+ *  内嵌 '\0' 的字符串同样按完整长度处理；不能转为 UTF8 的字符 (单独的代理项)
+ *  按有损转换替换为 '?'，与 -dataUsingEncoding:allowLossyConversion:YES 相同，
+ *  不会只散列前面的一部分
+ */
+static void CZStringEnumerateUTF8(NSString *string, void (*fn)(void *ctx, const void *bytes, size_t len), void *ctx) {
     
-    CC_MD5(str, (CC_LONG)strlen(str), buffer);
+    // 1. 内部存储本身就是 ASCII 时直接使用，字节数就是字符数
+    const char *ptr = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if (ptr != NULL) {
+        fn(ctx, ptr, string.length);
+        return;
+    }
     
-    return [self stringFromBytes:buffer length:CC_MD5_DIGEST_LENGTH];
+    // 2. 否则分段转码到栈上的缓冲区
+    uint8_t buffer[4096];
+    NSRange range = NSMakeRange(0, string.length);
+    
+    while (range.length > 0) {
+        NSUInteger used = 0;
+        
+        BOOL converted = [string getBytes:buffer
+                                maxLength:sizeof(buffer)
+                               usedLength:&used
+                                 encoding:NSUTF8StringEncoding
+                                  options:NSStringEncodingConversionAllowLossy
+                                    range:range
+                           remainingRange:&range];
+        
+        // 有损转换下不会失败，缓冲区也足够放下任何一个字符
+        NSCAssert(converted && used > 0, @"UTF8 转码失败");
+        if (!converted || used == 0) {
+            break;
+        }
+        fn(ctx, buffer, used);
+    }
+}
+
+static void CZDigestUpdate(void *ctx, const void *bytes, size_t len) {
+    cz_digest_update(ctx, bytes, len);
+}
+
+static void CZFastHashUpdate(void *ctx, const void *bytes, size_t len) {
+    cz_fasthash_update(ctx, bytes, len);
+}
+
+static void CZHmacUpdate(void *ctx, const void *bytes, size_t len) {
+    cz_hmac_update(ctx, bytes, len);
+}
+
+#pragma mark - 散列函数
+- (NSString *)cz_md5String {
+    return [self cz_hashStringWithAlgorithm:CZHashAlgorithmMD5];
 }
 
 - (NSString *)cz_sha1String {
-    const char *str = self.UTF8String;
-    uint8_t buffer[CC_SHA1_DIGEST_LENGTH];
+    return [self cz_hashStringWithAlgorithm:CZHashAlgorithmSHA1];
+}
+
+- (NSString *)cz_sha224String {
+    return [self cz_hashStringWithAlgorithm:CZHashAlgorithmSHA224];
+}
+
+- (NSString *)cz_sha256String {
+    return [self cz_hashStringWithAlgorithm:CZHashAlgorithmSHA256];
+}
+
+- (NSString *)cz_sha384String {
+    return [self cz_hashStringWithAlgorithm:CZHashAlgorithmSHA384];
+}
+
+- (NSString *)cz_sha512String {
+    return [self cz_hashStringWithAlgorithm:CZHashAlgorithmSHA512];
+}
+
+- (NSData *)cz_hashWithAlgorithm:(CZHashAlgorithm)algorithm {
+    uint8_t buffer[CZ_DIGEST_MAX_LENGTH];
     
-    CC_SHA1(str, (CC_LONG)strlen(str), buffer);
+    [self cz_hashWithAlgorithm:algorithm output:buffer];
     
-    return [self stringFromBytes:buffer length:CC_SHA1_DIGEST_LENGTH];
+    return [NSData dataWithBytes:buffer length:cz_digest_length((CZDigestAlgorithm)algorithm)];
 }
 
-- (NSString *)cz_sha224String {
-    const char *str = self.UTF8String;
-    uint8_t buffer[CC_SHA224_DIGEST_LENGTH];
+- (NSString *)cz_hashStringWithAlgorithm:(CZHashAlgorithm)algorithm {
+    uint8_t buffer[CZ_DIGEST_MAX_LENGTH];
     
-    CC_SHA224(str, (CC_LONG)strlen(str), buffer);
+    [self cz_hashWithAlgorithm:algorithm output:buffer];
     
-    return [self stringFromBytes:buffer length:CC_SHA224_DIGEST_LENGTH];
+    return [self stringFromBytes:buffer length:(int)cz_digest_length((CZDigestAlgorithm)algorithm)];
 }
 
-- (NSString *)cz_sha256String {
-    const char *str = self.UTF8String;
-    uint8_t buffer[CC_SHA256_DIGEST_LENGTH];
+- (void)cz_hashWithAlgorithm:(CZHashAlgorithm)algorithm output:(uint8_t *)output {
+    cz_digest_ctx ctx;
+    
+    cz_digest_init(&ctx, (CZDigestAlgorithm)algorithm);
+    CZStringEnumerateUTF8(self, CZDigestUpdate, &ctx);
+    cz_digest_final(&ctx, output);
+}
+
++ (NSData *)cz_batchHashes:(NSArray<NSString *> *)strings algorithm:(CZHashAlgorithm)algorithm {
+    NSUInteger count = strings.count;
+    size_t length = cz_digest_length((CZDigestAlgorithm)algorithm);
     
-    CC_SHA256(str, (CC_LONG)strlen(str), buffer);
+    NSMutableData *result = [NSMutableData dataWithLength:count * length];
+    if (count == 0) {
+        return result;
+    }
     
-    return [self stringFromBytes:buffer length:CC_SHA256_DIGEST_LENGTH];
+    const void **msgs = malloc(count * sizeof(void *));
+    size_t *lens = malloc(count * sizeof(size_t));
+    
+    // UTF8String 返回的缓冲区在当前自动释放池内有效，长度不能用 strlen，内嵌 '\0' 会被截断；
+    // 不能转为 UTF8 时与单个字符串的散列一样使用有损转换，转换结果保留到散列结束
+    NSMutableArray<NSData *> *lossy = nil;
+    NSUInteger i = 0;
+    for (NSString *str in strings) {
+        msgs[i] = str.UTF8String;
+        lens[i] = [str lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        
+        if (msgs[i] == NULL) {
+            NSData *data = [str dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES];
+            msgs[i] = data.bytes;
+            lens[i] = data.length;
+            
+            if (lossy == nil) {
+                lossy = [NSMutableArray array];
+            }
+            [lossy addObject:data];
+        }
+        i++;
+    }
+    
+    cz_batch_digest((CZDigestAlgorithm)algorithm, msgs, lens, count, result.mutableBytes);
+    lossy = nil;
+    
+    free(msgs);
+    free(lens);
+    
+    return result.copy;
 }
 
-- (NSString *)cz_sha384String {
-    const char *str = self.UTF8String;
-    uint8_t buffer[CC_SHA384_DIGEST_LENGTH];
+#pragma mark - 非加密散列函数
+- (uint64_t)cz_fastHash {
+    cz_fasthash_state state;
     
-    CC_SHA384(str, (CC_LONG)strlen(str), buffer);
+    cz_fasthash_init(&state, 0);
+    CZStringEnumerateUTF8(self, CZFastHashUpdate, &state);
     
-    return [self stringFromBytes:buffer length:CC_SHA384_DIGEST_LENGTH];
+    return cz_fasthash_final64(&state);
 }
 
-- (NSString *)cz_sha512String {
-    const char *str = self.UTF8String;
-    uint8_t buffer[CC_SHA512_DIGEST_LENGTH];
+- (NSString *)cz_fastHashString {
+    cz_fasthash_state state;
     
-    CC_SHA512(str, (CC_LONG)strlen(str), buffer);
+    cz_fasthash_init(&state, 0);
+    CZStringEnumerateUTF8(self, CZFastHashUpdate, &state);
     
-    return [self stringFromBytes:buffer length:CC_SHA512_DIGEST_LENGTH];
+    uint8_t bytes[16];
+    cz_hash128_to_bytes(cz_fasthash_final128(&state), bytes);
+    
+    return [self stringFromBytes:bytes length:sizeof(bytes)];
 }
 
 #pragma mark - HMAC 散列函数
 - (NSString *)cz_hmacMD5StringWithKey:(NSString *)key {
-    const char *keyData = key.UTF8String;
-    const char *strData = self.UTF8String;
-    uint8_t buffer[CC_MD5_DIGEST_LENGTH];
-    
-    CCHmac(kCCHmacAlgMD5, keyData, strlen(keyData), strData, strlen(strData), buffer);
-    
-    return [self stringFromBytes:buffer length:CC_MD5_DIGEST_LENGTH];
+    return [self cz_hmacStringWithHmac:[CZHmac sharedHmacWithKey:key algorithm:CZHashAlgorithmMD5]];
 }
 
 - (NSString *)cz_hmacSHA1StringWithKey:(NSString *)key {
-    const char *keyData = key.UTF8String;
-    const char *strData = self.UTF8String;
-    uint8_t buffer[CC_SHA1_DIGEST_LENGTH];
-    
-    CCHmac(kCCHmacAlgSHA1, keyData, strlen(keyData), strData, strlen(strData), buffer);
-    
-    return [self stringFromBytes:buffer length:CC_SHA1_DIGEST_LENGTH];
+    return [self cz_hmacStringWithHmac:[CZHmac sharedHmacWithKey:key algorithm:CZHashAlgorithmSHA1]];
 }
 
 - (NSString *)cz_hmacSHA256StringWithKey:(NSString *)key {
-    const char *keyData = key.UTF8String;
-    const char *strData = self.UTF8String;
-    uint8_t buffer[CC_SHA256_DIGEST_LENGTH];
-    
-    CCHmac(kCCHmacAlgSHA256, keyData, strlen(keyData), strData, strlen(strData), buffer);
-    
-    return [self stringFromBytes:buffer length:CC_SHA256_DIGEST_LENGTH];
+    return [self cz_hmacStringWithHmac:[CZHmac sharedHmacWithKey:key algorithm:CZHashAlgorithmSHA256]];
 }
 
 - (NSString *)cz_hmacSHA512StringWithKey:(NSString *)key {
-    const char *keyData = key.UTF8String;
-    const char *strData = self.UTF8String;
-    uint8_t buffer[CC_SHA512_DIGEST_LENGTH];
+    return [self cz_hmacStringWithHmac:[CZHmac sharedHmacWithKey:key algorithm:CZHashAlgorithmSHA512]];
+}
+
+- (NSString *)cz_hmacStringWithHmac:(CZHmac *)hmac {
+    uint8_t buffer[CZ_DIGEST_MAX_LENGTH];
     
-    CCHmac(kCCHmacAlgSHA512, keyData, strlen(keyData), strData, strlen(strData), buffer);
+    cz_hmac_ctx ctx;
+    cz_hmac_begin(&ctx, hmac.key);
+    CZStringEnumerateUTF8(self, CZHmacUpdate, &ctx);
+    cz_hmac_final(&ctx, buffer);
     
-    return [self stringFromBytes:buffer length:CC_SHA512_DIGEST_LENGTH];
+    return [self stringFromBytes:buffer length:(int)hmac.digestLength];
 }
 
 #pragma mark - 文件散列函数
 
-#define FileHashDefaultChunkSizeForReadingData 4096
-
 - (NSString *)cz_fileMD5Hash {
-    NSFileHandle *fp = [NSFileHandle fileHandleForReadingAtPath:self];
-    if (fp == nil) {
-        return nil;
-    }
-    
-    CC_MD5_CTX hashCtx;
-    CC_MD5_Init(&hashCtx);
-    
-    while (YES) {
-        @autoreleasepool {
-            NSData *data = [fp readDataOfLength:FileHashDefaultChunkSizeForReadingData];
-            
-            CC_MD5_Update(&hashCtx, data.bytes, (CC_LONG)data.length);
-            
-            if (data.length == 0) {
-                break;
-            }
-        }
-    }
-    [fp closeFile];
-    
-    uint8_t buffer[CC_MD5_DIGEST_LENGTH];
-    CC_MD5_Final(buffer, &hashCtx);
-    
-    return [self stringFromBytes:buffer length:CC_MD5_DIGEST_LENGTH];
+    return [self cz_fileHashesWithTypes:CZFileHashMD5][@(CZFileHashMD5)];
 }
 
 - (NSString *)cz_fileSHA1Hash {
-    NSFileHandle *fp = [NSFileHandle fileHandleForReadingAtPath:self];
-    if (fp == nil) {
+    return [self cz_fileHashesWithTypes:CZFileHashSHA1][@(CZFileHashSHA1)];
+}
+
+- (NSString *)cz_fileSHA256Hash {
+    return [self cz_fileHashesWithTypes:CZFileHashSHA256][@(CZFileHashSHA256)];
+}
+
+- (NSString *)cz_fileSHA512Hash {
+    return [self cz_fileHashesWithTypes:CZFileHashSHA512][@(CZFileHashSHA512)];
+}
+
+- (NSDictionary<NSNumber *, NSString *> *)cz_fileHashesWithTypes:(CZFileHashType)types {
+    // CZFileHashType 的位与 CZDigestAlgorithm 一一对应
+    CZDigestMask mask = (CZDigestMask)types & CZDigestMaskAll;
+    if (mask == 0) {
         return nil;
     }
     
-    CC_SHA1_CTX hashCtx;
-    CC_SHA1_Init(&hashCtx);
+    uint8_t buffer[CZDigestCount][CZ_DIGEST_MAX_LENGTH];
     
-    while (YES) {
-        @autoreleasepool {
-            NSData *data = [fp readDataOfLength:FileHashDefaultChunkSizeForReadingData];
-            
-            CC_SHA1_Update(&hashCtx, data.bytes, (CC_LONG)data.length);
-            
-            if (data.length == 0) {
-                break;
-            }
-        }
+    if (cz_multi_digest_file(self.fileSystemRepresentation, mask, buffer) != 0) {
+        return nil;
     }
-    [fp closeFile];
     
-    uint8_t buffer[CC_SHA1_DIGEST_LENGTH];
-    CC_SHA1_Final(buffer, &hashCtx);
-    
-    return [self stringFromBytes:buffer length:CC_SHA1_DIGEST_LENGTH];
+    return CZFileHashesDictionary(types, buffer);
 }
 
-- (NSString *)cz_fileSHA256Hash {
-    NSFileHandle *fp = [NSFileHandle fileHandleForReadingAtPath:self];
-    if (fp == nil) {
-        return nil;
-    }
+NSDictionary<NSNumber *, NSString *> *CZFileHashesDictionary(CZFileHashType types, const void *digests) {
+    CZDigestMask mask = (CZDigestMask)types & CZDigestMaskAll;
+    const uint8_t (*buffer)[CZ_DIGEST_MAX_LENGTH] = digests;
     
-    CC_SHA256_CTX hashCtx;
-    CC_SHA256_Init(&hashCtx);
+    NSMutableDictionary *dictM = [NSMutableDictionary dictionary];
     
-    while (YES) {
-        @autoreleasepool {
-            NSData *data = [fp readDataOfLength:FileHashDefaultChunkSizeForReadingData];
-            
-            CC_SHA256_Update(&hashCtx, data.bytes, (CC_LONG)data.length);
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        if (mask & CZDigestMaskOf(alg)) {
+            size_t length = cz_digest_length(alg);
+            char hex[2 * CZ_DIGEST_MAX_LENGTH];
             
-            if (data.length == 0) {
-                break;
-            }
+            cz_hex_encode(buffer[alg], length, hex);
+            dictM[@(1 << alg)] = [[NSString alloc] initWithBytes:hex length:2 * length encoding:NSASCIIStringEncoding];
         }
     }
-    [fp closeFile];
     
-    uint8_t buffer[CC_SHA256_DIGEST_LENGTH];
-    CC_SHA256_Final(buffer, &hashCtx);
-    
-    return [self stringFromBytes:buffer length:CC_SHA256_DIGEST_LENGTH];
+    return dictM.copy;
 }
 
-- (NSString *)cz_fileSHA512Hash {
-    NSFileHandle *fp = [NSFileHandle fileHandleForReadingAtPath:self];
-    if (fp == nil) {
-        return nil;
-    }
-    
-    CC_SHA512_CTX hashCtx;
-    CC_SHA512_Init(&hashCtx);
+- (NSNumber *)cz_fileCRC32C {
+    uint32_t crc;
     
-    while (YES) {
-        @autoreleasepool {
-            NSData *data = [fp readDataOfLength:FileHashDefaultChunkSizeForReadingData];
-            
-            CC_SHA512_Update(&hashCtx, data.bytes, (CC_LONG)data.length);
-            
-            if (data.length == 0) {
-                break;
-            }
-        }
+    if (cz_crc32c_file(self.fileSystemRepresentation, &crc) != 0) {
+        return nil;
     }
-    [fp closeFile];
-    
-    uint8_t buffer[CC_SHA512_DIGEST_LENGTH];
-    CC_SHA512_Final(buffer, &hashCtx);
     
-    return [self stringFromBytes:buffer length:CC_SHA512_DIGEST_LENGTH];
+    return @(crc);
 }
 
 #pragma mark - 助手方法
@@ -232,13 +284,12 @@
  *  @return 字符串表示形式
  */
 - (NSString *)stringFromBytes:(uint8_t *)bytes length:(int)length {
-    NSMutableString *strM = [NSMutableString string];
+    NSAssert(length <= CZ_DIGEST_MAX_LENGTH, @"只用于散列结果");
+    char hex[2 * CZ_DIGEST_MAX_LENGTH];
     
-    for (int i = 0; i < length; i++) {
-        [strM appendFormat:@"%02x", bytes[i]];
-    }
+    cz_hex_encode(bytes, length, hex);
     
-    return strM.copy;
+    return [[NSString alloc] initWithBytes:hex length:2 * length encoding:NSASCIIStringEncoding];
 }
 
 @end
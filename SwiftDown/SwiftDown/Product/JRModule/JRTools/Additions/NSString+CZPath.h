@@ -15,6 +15,11 @@
 /// 给当前文件追加缓存路径
 - (NSString *)cz_appendCacheDir;
 
+/// 把当前字符串 (通常是 URL) 散列为文件名后追加缓存路径
+///
+/// 使用 128 位快速散列，比 MD5 快且不会因为 URL 中的 '/' 截断
+- (NSString *)cz_appendCacheDirWithHashedName;
+
 /// 给当前文件追加临时路径
 - (NSString *)cz_appendTempDir;
 
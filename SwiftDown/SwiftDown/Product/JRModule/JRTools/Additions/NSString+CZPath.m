@@ -6,6 +6,7 @@
 //
 
 #import "NSString+CZPath.h"
+#import "NSString+CZHash.h"
 
 @implementation NSString (CZPath)
 
@@ -21,6 +22,10 @@
     return [dir stringByAppendingPathComponent:self.lastPathComponent];
 }
 
+- (NSString *)cz_appendCacheDirWithHashedName {
+    return [self.cz_fastHashString cz_appendCacheDir];
+}
+
 - (NSString *)cz_appendTempDir {
     NSString *dir = NSTemporaryDirectory();
     
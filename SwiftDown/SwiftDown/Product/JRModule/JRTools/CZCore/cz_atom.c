@@ -0,0 +1,112 @@
+//
+//  cz_atom.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/26.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_atom.h"
+#include "cz_fasthash.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// 散列槽位数，装载率不超过 1 / 2
+#define CZ_ATOM_SLOTS       (CZ_ATOM_CAPACITY * 2)
+
+typedef struct {
+    uint64_t    hash;
+    const char *name;
+    size_t      len;
+} cz_atom_entry;
+
+/// 下标为 ID，0 不使用
+static cz_atom_entry cz_atom_entries[CZ_ATOM_CAPACITY + 1];
+
+/// 槽位保存 ID，0 表示空；ID 在对应的条目写完之后才发布
+static cz_atom cz_atom_slots[CZ_ATOM_SLOTS];
+
+static cz_atom cz_atom_count;
+
+static pthread_mutex_t cz_atom_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint64_t cz_atom_hash(const char *str, size_t len) {
+    return cz_fasthash64(str, len, 0);
+}
+
+/// 查找字符串，返回 ID 或 CZ_ATOM_NONE，*slot 为结束探测的空槽位
+static cz_atom cz_atom_find(const char *str, size_t len, uint64_t hash, size_t *slot) {
+    size_t i = (size_t)hash & (CZ_ATOM_SLOTS - 1);
+
+    for (;;) {
+        cz_atom atom = __atomic_load_n(&cz_atom_slots[i], __ATOMIC_ACQUIRE);
+
+        if (atom == CZ_ATOM_NONE) {
+            *slot = i;
+            return CZ_ATOM_NONE;
+        }
+
+        const cz_atom_entry *entry = &cz_atom_entries[atom];
+        if (entry->hash == hash && entry->len == len && memcmp(entry->name, str, len) == 0) {
+            return atom;
+        }
+        i = (i + 1) & (CZ_ATOM_SLOTS - 1);
+    }
+}
+
+cz_atom cz_atom_lookup(const char *str, size_t len) {
+    size_t slot;
+    return cz_atom_find(str, len, cz_atom_hash(str, len), &slot);
+}
+
+cz_atom cz_atom_intern(const char *str, size_t len) {
+    uint64_t hash = cz_atom_hash(str, len);
+    size_t slot;
+
+    cz_atom atom = cz_atom_find(str, len, hash, &slot);
+    if (atom != CZ_ATOM_NONE) {
+        return atom;
+    }
+
+    pthread_mutex_lock(&cz_atom_lock);
+
+    // 加锁后重新查找，其他线程可能刚刚登记
+    atom = cz_atom_find(str, len, hash, &slot);
+
+    if (atom == CZ_ATOM_NONE && cz_atom_count < CZ_ATOM_CAPACITY) {
+        char *name = malloc(len + 1);
+
+        if (name != NULL) {
+            memcpy(name, str, len);
+            name[len] = '\0';
+
+            atom = cz_atom_count + 1;
+            cz_atom_entries[atom].hash = hash;
+            cz_atom_entries[atom].name = name;
+            cz_atom_entries[atom].len = len;
+
+            __atomic_store_n(&cz_atom_count, atom, __ATOMIC_RELEASE);
+            __atomic_store_n(&cz_atom_slots[slot], atom, __ATOMIC_RELEASE);
+        }
+    }
+
+    pthread_mutex_unlock(&cz_atom_lock);
+
+    return atom;
+}
+
+const char *cz_atom_name(cz_atom atom, size_t *len) {
+    if (atom == CZ_ATOM_NONE || atom > __atomic_load_n(&cz_atom_count, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    if (len != NULL) {
+        *len = cz_atom_entries[atom].len;
+    }
+    return cz_atom_entries[atom].name;
+}
+
+cz_atom cz_atom_max(void) {
+    return __atomic_load_n(&cz_atom_count, __ATOMIC_ACQUIRE);
+}
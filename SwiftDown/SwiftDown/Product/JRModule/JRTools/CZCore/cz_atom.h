@@ -0,0 +1,54 @@
+//
+//  cz_atom.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/26.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_atom_h
+#define cz_atom_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 进程内共享的 key 原子表
+///
+/// 每个字符串只保存一次，并分配一个从 1 开始连续递增的整数 ID；
+/// 模型的属性名在创建映射表时登记，JSON 解析时按 key 的字节直接查到 ID，
+/// 之后按整数分派，不再创建 key 字符串、不再比较字符串
+typedef uint32_t cz_atom;
+
+/// 表示字符串不在表中
+#define CZ_ATOM_NONE        0
+
+/// 最多登记的字符串个数
+#define CZ_ATOM_CAPACITY    4096
+
+/// 登记字符串，已经存在时返回原来的 ID
+///
+/// 登记之间互斥，不影响并发的查找
+///
+/// @return 字符串的 ID，表已满时返回 CZ_ATOM_NONE
+cz_atom cz_atom_intern(const char *str, size_t len);
+
+/// 查找字符串的 ID，不加锁
+///
+/// @return 字符串的 ID，没有登记过时返回 CZ_ATOM_NONE
+cz_atom cz_atom_lookup(const char *str, size_t len);
+
+/// 返回 ID 对应的字符串 ('\0' 结尾)，ID 不存在时返回 NULL
+const char *cz_atom_name(cz_atom atom, size_t *len);
+
+/// 已经登记的最大 ID
+cz_atom cz_atom_max(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_atom_h */
@@ -0,0 +1,516 @@
+//
+//  cz_base64.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/21.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_base64.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define CZ_BASE64_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#define CZ_BASE64_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#pragma mark - 字母表
+
+static const char cz_base64_std_chars[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const char cz_base64_url_chars[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/// 非法字符为 -1
+static const int8_t cz_base64_std_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static const int8_t cz_base64_url_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+#pragma mark - 编码
+
+#if CZ_BASE64_NEON
+
+/// 每次 48 字节 -> 64 个字符
+static size_t cz_base64_encode_neon(const uint8_t *bytes, size_t len, char *out, const char *chars) {
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8((const uint8_t *)chars);
+    table.val[1] = vld1q_u8((const uint8_t *)chars + 16);
+    table.val[2] = vld1q_u8((const uint8_t *)chars + 32);
+    table.val[3] = vld1q_u8((const uint8_t *)chars + 48);
+
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    size_t i = 0;
+
+    for (; i + 48 <= len; i += 48) {
+        uint8x16x3_t in = vld3q_u8(bytes + i);
+        uint8x16x4_t idx;
+
+        idx.val[0] = vshrq_n_u8(in.val[0], 2);
+        idx.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        idx.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        idx.val[3] = vandq_u8(in.val[2], mask);
+
+        idx.val[0] = vqtbl4q_u8(table, idx.val[0]);
+        idx.val[1] = vqtbl4q_u8(table, idx.val[1]);
+        idx.val[2] = vqtbl4q_u8(table, idx.val[2]);
+        idx.val[3] = vqtbl4q_u8(table, idx.val[3]);
+
+        vst4q_u8((uint8_t *)out + i / 3 * 4, idx);
+    }
+    return i;
+}
+
+#elif CZ_BASE64_SSSE3
+
+/// 每次读取 16 字节、使用其中 12 字节 -> 16 个字符
+static size_t cz_base64_encode_ssse3(const uint8_t *bytes, size_t len, char *out, const char *chars) {
+    // 按 6 位索引所在的区间加上偏移：A-Z / a-z / 0-9 / 第 62、63 个字符
+    const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        chars[62] - 62, chars[63] - 63, 'A', 0, 0);
+    const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 12) {
+        __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(bytes + i)), spread);
+
+        // 把每 3 字节拆成 4 个 6 位索引
+        __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i idx = _mm_or_si128(t1, t3);
+
+        __m128i reduced = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+        __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+        reduced = _mm_or_si128(reduced, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+        __m128i result = _mm_add_epi8(_mm_shuffle_epi8(shift, reduced), idx);
+        _mm_storeu_si128((__m128i *)(out + i / 3 * 4), result);
+    }
+    return i;
+}
+
+#endif
+
+size_t cz_base64_encode(const uint8_t *bytes, size_t len, char *out, CZBase64Alphabet alphabet, int padding) {
+    const char *chars = alphabet == CZBase64URLSafe ? cz_base64_url_chars : cz_base64_std_chars;
+    size_t i = 0;
+
+#if CZ_BASE64_NEON
+    i = cz_base64_encode_neon(bytes, len, out, chars);
+#elif CZ_BASE64_SSSE3
+    i = cz_base64_encode_ssse3(bytes, len, out, chars);
+#endif
+
+    char *p = out + i / 3 * 4;
+
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = (uint32_t)bytes[i] << 16 | (uint32_t)bytes[i + 1] << 8 | bytes[i + 2];
+
+        p[0] = chars[v >> 18];
+        p[1] = chars[(v >> 12) & 63];
+        p[2] = chars[(v >> 6) & 63];
+        p[3] = chars[v & 63];
+        p += 4;
+    }
+
+    if (i < len) {
+        uint32_t v = (uint32_t)bytes[i] << 16;
+        if (i + 1 < len) {
+            v |= (uint32_t)bytes[i + 1] << 8;
+        }
+
+        *p++ = chars[v >> 18];
+        *p++ = chars[(v >> 12) & 63];
+        if (i + 1 < len) {
+            *p++ = chars[(v >> 6) & 63];
+        } else if (padding) {
+            *p++ = '=';
+        }
+        if (padding) {
+            *p++ = '=';
+        }
+    }
+
+    return (size_t)(p - out);
+}
+
+#pragma mark - 解码
+
+#if CZ_BASE64_NEON
+
+/// 每次 64 个字符 -> 48 字节
+///
+/// @return 已处理的字符数，遇到非法字符返回 (size_t)-1
+static size_t cz_base64_decode_neon(const uint8_t *in, size_t len, uint8_t *out, const int8_t *values) {
+    // 0 ~ 127 分两张表，127 以上查表结果为 0，另外用最高位判断
+    const uint8_t *v = (const uint8_t *)values;
+    uint8x16x4_t lo, hi;
+    for (int t = 0; t < 4; t++) {
+        lo.val[t] = vld1q_u8(v + 16 * t);
+        hi.val[t] = vld1q_u8(v + 64 + 16 * t);
+    }
+
+    const uint8x16_t flip = vdupq_n_u8(0x40);
+    const uint8x16_t check = vdupq_n_u8(0xc0);
+    const uint8x16_t high = vdupq_n_u8(0x80);
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        uint8x16x4_t c = vld4q_u8(in + i);
+        uint8x16_t bad = vdupq_n_u8(0);
+
+        for (int t = 0; t < 4; t++) {
+            uint8x16_t s = vorrq_u8(vqtbl4q_u8(lo, c.val[t]), vqtbl4q_u8(hi, veorq_u8(c.val[t], flip)));
+            // 合法值 < 64，非法为 0xff；非 ASCII 字符最高位为 1
+            bad = vorrq_u8(bad, vorrq_u8(vandq_u8(s, check), vandq_u8(c.val[t], high)));
+            c.val[t] = s;
+        }
+
+        if (vmaxvq_u8(bad) != 0) {
+            return (size_t)-1;
+        }
+
+        uint8x16x3_t o;
+        o.val[0] = vorrq_u8(vshlq_n_u8(c.val[0], 2), vshrq_n_u8(c.val[1], 4));
+        o.val[1] = vorrq_u8(vshlq_n_u8(c.val[1], 4), vshrq_n_u8(c.val[2], 2));
+        o.val[2] = vorrq_u8(vshlq_n_u8(c.val[2], 6), c.val[3]);
+        vst3q_u8(out + i / 4 * 3, o);
+    }
+    return i;
+}
+
+#elif CZ_BASE64_SSSE3
+
+static inline __m128i cz_base64_range(__m128i c, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8(hi + 1)));
+}
+
+/// 每次 16 个字符 -> 12 字节 (写入 16 字节)
+///
+/// @return 已处理的字符数，遇到非法字符返回 (size_t)-1
+static size_t cz_base64_decode_ssse3(const uint8_t *in, size_t len, uint8_t *out, const char *chars) {
+    const __m128i c62 = _mm_set1_epi8(chars[62]);
+    const __m128i c63 = _mm_set1_epi8(chars[63]);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t i = 0;
+
+    // 每次多写 4 字节，保证不越过输出缓冲区
+    for (; i + 24 <= len; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(in + i));
+
+        // 有符号比较，非 ASCII 字符为负数，不会落在任何区间
+        __m128i upper = cz_base64_range(c, 'A', 'Z');
+        __m128i lower = cz_base64_range(c, 'a', 'z');
+        __m128i digit = cz_base64_range(c, '0', '9');
+        __m128i is62 = _mm_cmpeq_epi8(c, c62);
+        __m128i is63 = _mm_cmpeq_epi8(c, c63);
+
+        __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+        if (_mm_movemask_epi8(valid) != 0xffff) {
+            return (size_t)-1;
+        }
+
+        __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+        shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+        shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+        shift = _mm_or_si128(shift, _mm_and_si128(is62, _mm_set1_epi8((char)(62 - chars[62]))));
+        shift = _mm_or_si128(shift, _mm_and_si128(is63, _mm_set1_epi8((char)(63 - chars[63]))));
+
+        __m128i s = _mm_add_epi8(c, shift);
+
+        // 合并 6 位 -> 12 位 -> 24 位，再取出每组的 3 字节
+        __m128i merged = _mm_maddubs_epi16(s, _mm_set1_epi32(0x01400140));
+        merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i *)(out + i / 4 * 3), _mm_shuffle_epi8(merged, pack));
+    }
+    return i;
+}
+
+#endif
+
+int cz_base64_decode(const char *in, size_t len, uint8_t *out, size_t *out_len, CZBase64Alphabet alphabet) {
+    const uint8_t *p = (const uint8_t *)in;
+    const int8_t *values = alphabet == CZBase64URLSafe ? cz_base64_url_values : cz_base64_std_values;
+
+    // 去掉末尾的补位，只允许补在 4 字符一组的末尾
+    if (len > 0 && p[len - 1] == '=') {
+        if (len % 4 != 0) {
+            return -1;
+        }
+        len--;
+        if (p[len - 1] == '=') {
+            len--;
+        }
+    }
+    if (len % 4 == 1) {
+        return -1;
+    }
+
+    size_t i = 0;
+
+#if CZ_BASE64_NEON
+    i = cz_base64_decode_neon(p, len, out, values);
+#elif CZ_BASE64_SSSE3
+    i = cz_base64_decode_ssse3(p, len, out, alphabet == CZBase64URLSafe ? cz_base64_url_chars : cz_base64_std_chars);
+#endif
+
+    if (i == (size_t)-1) {
+        return -1;
+    }
+
+    uint8_t *o = out + i / 4 * 3;
+    int bad = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        int32_t a = values[p[i]], b = values[p[i + 1]], c = values[p[i + 2]], d = values[p[i + 3]];
+        uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | (uint32_t)d;
+
+        bad |= a | b | c | d;
+        o[0] = (uint8_t)(v >> 16);
+        o[1] = (uint8_t)(v >> 8);
+        o[2] = (uint8_t)v;
+        o += 3;
+    }
+
+    // 剩下 2 或 3 个字符
+    if (i < len) {
+        int32_t a = values[p[i]], b = values[p[i + 1]];
+        int32_t c = i + 2 < len ? values[p[i + 2]] : 0;
+
+        // 非法字符为 -1，按无符号数移位
+        bad |= a | b | c;
+        *o++ = (uint8_t)((uint32_t)a << 2 | (uint32_t)b >> 4);
+        if (i + 2 < len) {
+            *o++ = (uint8_t)((uint32_t)b << 4 | (uint32_t)c >> 2);
+        }
+    }
+
+    if (bad < 0) {
+        return -1;
+    }
+
+    *out_len = (size_t)(o - out);
+    return 0;
+}
+
+#pragma mark - 流式编码
+
+void cz_base64_encoder_init(cz_base64_encoder *enc, CZBase64Alphabet alphabet, int padding,
+                            cz_base64_sink_fn sink, void *ctx) {
+    enc->alphabet = alphabet;
+    enc->padding = padding;
+    enc->sink = sink;
+    enc->ctx = ctx;
+    enc->carry_len = 0;
+}
+
+int cz_base64_encoder_update(cz_base64_encoder *enc, const void *bytes, size_t len) {
+    const uint8_t *p = bytes;
+
+    // 1. 先补齐上次剩下的字节
+    if (enc->carry_len > 0) {
+        while (enc->carry_len < 3 && len > 0) {
+            enc->carry[enc->carry_len++] = *p++;
+            len--;
+        }
+        if (enc->carry_len < 3) {
+            return 0;
+        }
+
+        size_t n = cz_base64_encode(enc->carry, 3, enc->out, enc->alphabet, 0);
+        enc->carry_len = 0;
+        if (enc->sink(enc->ctx, enc->out, n) != 0) {
+            return 1;
+        }
+    }
+
+    // 2. 整组数据分块编码，每块输出填满缓冲区
+    const size_t window = CZ_BASE64_STREAM_CHUNK / 4 * 3;
+
+    while (len >= 3) {
+        size_t take = len < window ? len / 3 * 3 : window;
+        size_t n = cz_base64_encode(p, take, enc->out, enc->alphabet, 0);
+
+        p += take;
+        len -= take;
+        if (enc->sink(enc->ctx, enc->out, n) != 0) {
+            return 1;
+        }
+    }
+
+    // 3. 剩下不足一组的字节
+    memcpy(enc->carry, p, len);
+    enc->carry_len = (uint32_t)len;
+
+    return 0;
+}
+
+int cz_base64_encoder_final(cz_base64_encoder *enc) {
+    if (enc->carry_len == 0) {
+        return 0;
+    }
+
+    size_t n = cz_base64_encode(enc->carry, enc->carry_len, enc->out, enc->alphabet, enc->padding);
+    enc->carry_len = 0;
+
+    return enc->sink(enc->ctx, enc->out, n) != 0 ? 1 : 0;
+}
+
+#pragma mark - 流式解码
+
+void cz_base64_decoder_init(cz_base64_decoder *dec, CZBase64Alphabet alphabet,
+                            cz_base64_sink_fn sink, void *ctx) {
+    dec->alphabet = alphabet;
+    dec->sink = sink;
+    dec->ctx = ctx;
+    dec->carry_len = 0;
+    dec->pad_len = 0;
+}
+
+/// 解码不含 '=' 的字符，长度必须是 4 的倍数
+static int cz_base64_decoder_emit(cz_base64_decoder *dec, const char *chars, size_t len) {
+    size_t n;
+
+    if (cz_base64_decode(chars, len, dec->out, &n, dec->alphabet) != 0) {
+        return -1;
+    }
+    return dec->sink(dec->ctx, dec->out, n) != 0 ? 1 : 0;
+}
+
+/// 补位之后只允许继续出现 '='，最多 2 个
+static int cz_base64_decoder_padding(cz_base64_decoder *dec, const char *chars, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (chars[i] != '=' || ++dec->pad_len > 2) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int cz_base64_decoder_update(cz_base64_decoder *dec, const char *chars, size_t len) {
+    if (dec->pad_len > 0) {
+        return cz_base64_decoder_padding(dec, chars, len);
+    }
+
+    // 遇到 '=' 时截断，之后的部分按补位处理
+    const char *pad = memchr(chars, '=', len);
+    size_t data_len = pad != NULL ? (size_t)(pad - chars) : len;
+    const char *p = chars;
+    size_t left = data_len;
+    int result;
+
+    // 1. 先补齐上次剩下的字符
+    if (dec->carry_len > 0) {
+        while (dec->carry_len < 4 && left > 0) {
+            dec->carry[dec->carry_len++] = *p++;
+            left--;
+        }
+        if (dec->carry_len == 4) {
+            dec->carry_len = 0;
+            if ((result = cz_base64_decoder_emit(dec, dec->carry, 4)) != 0) {
+                return result;
+            }
+        }
+    }
+
+    // 2. 整组字符分块解码
+    while (left >= 4) {
+        size_t take = left < CZ_BASE64_STREAM_CHUNK ? left / 4 * 4 : CZ_BASE64_STREAM_CHUNK;
+
+        if ((result = cz_base64_decoder_emit(dec, p, take)) != 0) {
+            return result;
+        }
+        p += take;
+        left -= take;
+    }
+
+    // 3. 剩下不足一组的字符
+    memcpy(dec->carry + dec->carry_len, p, left);
+    dec->carry_len += (uint32_t)left;
+
+    if (pad != NULL) {
+        return cz_base64_decoder_padding(dec, pad, len - data_len);
+    }
+    return 0;
+}
+
+int cz_base64_decoder_final(cz_base64_decoder *dec) {
+    uint32_t n = dec->carry_len;
+
+    // 最后一组：2 或 3 个字符；有补位时必须正好补满 4 个
+    if (n == 1 || (dec->pad_len > 0 && (n == 0 || n + dec->pad_len != 4))) {
+        return -1;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    size_t len;
+    if (cz_base64_decode(dec->carry, n, dec->out, &len, dec->alphabet) != 0) {
+        return -1;
+    }
+    dec->carry_len = 0;
+
+    return dec->sink(dec->ctx, dec->out, len) != 0 ? 1 : 0;
+}
+
+int cz_base64_fd_sink(void *ctx, const void *bytes, size_t len) {
+    int fd = *(int *)ctx;
+    const uint8_t *p = bytes;
+
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+//
+//  cz_base64.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/21.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_base64_h
+#define cz_base64_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// BASE 64 字母表
+typedef enum {
+    CZBase64Standard = 0,   // A-Z a-z 0-9 + /
+    CZBase64URLSafe,        // A-Z a-z 0-9 - _
+} CZBase64Alphabet;
+
+/// 编码结果的长度 (带 '=' 补位)
+#define CZ_BASE64_ENCODED_LENGTH(len)       (((len) + 2) / 3 * 4)
+
+/// 解码结果的最大长度
+#define CZ_BASE64_DECODED_MAX_LENGTH(len)   (((len) + 3) / 4 * 3)
+
+/// BASE 64 编码，直接写入调用方提供的缓冲区
+///
+/// ARMv8 使用 NEON 每次 48 字节，x86 有 SSSE3 时每次 12 字节，其余查表
+///
+/// @param bytes    二进制数据
+/// @param len      数据长度
+/// @param out      至少 CZ_BASE64_ENCODED_LENGTH(len) 字节，不追加 '\0'
+/// @param alphabet 字母表
+/// @param padding  是否补 '='
+///
+/// @return 写入的字符数
+size_t cz_base64_encode(const uint8_t *bytes, size_t len, char *out, CZBase64Alphabet alphabet, int padding);
+
+/// BASE 64 解码
+///
+/// 末尾的 '=' 可有可无；空白、换行、其他字母表的字符、中间的 '=' 都视为非法
+///
+/// @param in       BASE 64 字符
+/// @param len      字符个数
+/// @param out      至少 CZ_BASE64_DECODED_MAX_LENGTH(len) 字节
+/// @param out_len  解码后的字节数
+/// @param alphabet 字母表
+///
+/// @return 0 成功，-1 包含非法字符或长度不正确
+int cz_base64_decode(const char *in, size_t len, uint8_t *out, size_t *out_len, CZBase64Alphabet alphabet);
+
+#pragma mark - 流式编解码
+
+/// 结果输出函数，返回非 0 时停止
+typedef int (*cz_base64_sink_fn)(void *ctx, const void *bytes, size_t len);
+
+/// 流式处理每次输出的最大字节数，内存占用与输入大小无关
+#define CZ_BASE64_STREAM_CHUNK  4096
+
+/// 流式编码上下文
+typedef struct {
+    CZBase64Alphabet  alphabet;
+    int               padding;
+    cz_base64_sink_fn sink;
+    void             *ctx;
+    uint8_t           carry[3];     // 不足 3 字节的剩余输入
+    uint32_t          carry_len;
+    char              out[CZ_BASE64_STREAM_CHUNK];
+} cz_base64_encoder;
+
+/// 流式解码上下文
+typedef struct {
+    CZBase64Alphabet  alphabet;
+    cz_base64_sink_fn sink;
+    void             *ctx;
+    char              carry[4];     // 不足 4 个字符的剩余输入
+    uint32_t          carry_len;
+    uint32_t          pad_len;      // 已经读到的 '=' 个数，之后只允许 '='
+    uint8_t           out[CZ_BASE64_STREAM_CHUNK / 4 * 3];
+} cz_base64_decoder;
+
+void cz_base64_encoder_init(cz_base64_encoder *enc, CZBase64Alphabet alphabet, int padding,
+                            cz_base64_sink_fn sink, void *ctx);
+
+/// 输入任意长度的数据
+///
+/// @return 0 成功，1 被输出函数停止
+int cz_base64_encoder_update(cz_base64_encoder *enc, const void *bytes, size_t len);
+
+/// 输出剩余字节和补位
+///
+/// @return 0 成功，1 被输出函数停止
+int cz_base64_encoder_final(cz_base64_encoder *enc);
+
+void cz_base64_decoder_init(cz_base64_decoder *dec, CZBase64Alphabet alphabet,
+                            cz_base64_sink_fn sink, void *ctx);
+
+/// 输入任意长度的字符，4 个字符一组可以跨越两次调用
+///
+/// @return 0 成功，-1 非法字符，1 被输出函数停止
+int cz_base64_decoder_update(cz_base64_decoder *dec, const char *chars, size_t len);
+
+/// 检查结尾并输出最后一组
+///
+/// @return 0 成功，-1 长度或补位不正确，1 被输出函数停止
+int cz_base64_decoder_final(cz_base64_decoder *dec);
+
+/// 写入文件的输出函数，ctx 为指向文件描述符的 int *
+int cz_base64_fd_sink(void *ctx, const void *bytes, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_base64_h */
@@ -0,0 +1,293 @@
+//
+//  cz_batch.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/12.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_batch.h"
+#include "cz_sha.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || defined(__GNUC__))
+#define CZ_BATCH_AVX2 1
+#include <cpuid.h>
+#endif
+
+#pragma mark - 常量
+
+static const uint32_t cz_batch_md5_iv[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+static const uint32_t cz_batch_md5_k[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+static const int cz_batch_md5_r[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+};
+
+static const uint32_t cz_batch_sha1_iv[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+static const uint32_t cz_batch_sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static const uint32_t cz_batch_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#pragma mark - 通道
+
+/// 一个通道负责一条消息
+typedef struct {
+    const uint8_t *msg;
+    size_t         full;            // 消息中完整分组的个数
+    size_t         nblocks;         // 补位后的分组总数，空通道为 0
+    uint8_t        tail[128];       // 最后不完整的分组 + 补位
+    uint8_t       *out;             // 结果地址，空通道为 NULL
+} cz_batch_lane;
+
+static const uint8_t cz_batch_zero_block[64];
+
+static inline uint32_t cz_batch_load_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint32_t cz_batch_load_le32(const uint8_t *p) {
+    return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+static inline void cz_batch_store_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline void cz_batch_store_le32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/// 准备通道：完整分组直接引用原消息，剩余部分和补位放进 tail
+///
+/// @param big_endian SHA 系列长度为大端，MD5 为小端
+static void cz_batch_lane_init(cz_batch_lane *lane, const uint8_t *msg, size_t len, uint8_t *out, int big_endian) {
+    size_t rest = len & 63;
+    uint64_t bits = (uint64_t)len << 3;
+
+    lane->msg = msg;
+    lane->full = len >> 6;
+    lane->out = out;
+
+    size_t tail_len = rest + 9 <= 64 ? 64 : 128;
+    lane->nblocks = lane->full + tail_len / 64;
+
+    memset(lane->tail, 0, tail_len);
+    if (rest > 0) {
+        memcpy(lane->tail, msg + (len - rest), rest);
+    }
+    lane->tail[rest] = 0x80;
+
+    for (int i = 0; i < 8; i++) {
+        int shift = big_endian ? 56 - 8 * i : 8 * i;
+        lane->tail[tail_len - 8 + i] = (uint8_t)(bits >> shift);
+    }
+}
+
+static void cz_batch_lane_empty(cz_batch_lane *lane) {
+    lane->msg = NULL;
+    lane->full = 0;
+    lane->nblocks = 0;
+    lane->out = NULL;
+}
+
+static inline const uint8_t *cz_batch_block(const cz_batch_lane *lane, size_t b) {
+    if (b < lane->full) {
+        return lane->msg + 64 * b;
+    }
+    if (b < lane->nblocks) {
+        return lane->tail + 64 * (b - lane->full);
+    }
+    return cz_batch_zero_block;
+}
+
+#pragma mark - 压缩函数
+
+// 轮函数完全展开后，消息字下标、移位数和 K 都变成常量
+#if defined(__clang__)
+#define CZ_BATCH_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define CZ_BATCH_UNROLL _Pragma("GCC unroll 80")
+#else
+#define CZ_BATCH_UNROLL
+#endif
+
+#define CZ_LANES 4
+#define CZ_TARGET
+#include "cz_batch_lanes.h"
+#undef CZ_TARGET
+#undef CZ_LANES
+
+#if CZ_BATCH_AVX2
+#define CZ_LANES 8
+#define CZ_TARGET __attribute__((target("avx2")))
+#include "cz_batch_lanes.h"
+#undef CZ_TARGET
+#undef CZ_LANES
+
+static int cz_cpu_has_avx2(void) {
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    // OSXSAVE + AVX，并且系统保存了 YMM 寄存器
+    if (!(ecx & (1u << 27)) || !(ecx & (1u << 28))) {
+        return 0;
+    }
+    unsigned int xcr0_lo, xcr0_hi;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 0x6) != 0x6) {
+        return 0;
+    }
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return 0;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    return (ebx & (1u << 5)) != 0;
+}
+#endif
+
+#pragma mark - 运行时选择
+
+typedef void (*cz_batch_fn)(cz_batch_lane *lanes);
+
+static int cz_batch_width = 4;
+static cz_batch_fn cz_batch_md5_fn = cz_batch_md5_4;
+static cz_batch_fn cz_batch_sha1_fn = cz_batch_sha1_4;
+static cz_batch_fn cz_batch_sha256_fn = cz_batch_sha256_4;
+static pthread_once_t cz_batch_once = PTHREAD_ONCE_INIT;
+
+static void cz_batch_select(void) {
+#if CZ_BATCH_AVX2
+    if (cz_cpu_has_avx2()) {
+        cz_batch_width = 8;
+        cz_batch_md5_fn = cz_batch_md5_8;
+        cz_batch_sha1_fn = cz_batch_sha1_8;
+        cz_batch_sha256_fn = cz_batch_sha256_8;
+    }
+#endif
+}
+
+int cz_batch_lanes(void) {
+    pthread_once(&cz_batch_once, cz_batch_select);
+    return cz_batch_width;
+}
+
+#pragma mark - 批量接口
+
+/// 按分组数分桶，超过的消息都放进最后一个桶
+#define CZ_BATCH_BUCKETS 16
+
+static size_t cz_batch_bucket(size_t len) {
+    size_t nblocks = (len + 9 + 63) >> 6;
+
+    return nblocks < CZ_BATCH_BUCKETS ? nblocks : CZ_BATCH_BUCKETS - 1;
+}
+
+static void cz_batch_digest_serial(CZDigestAlgorithm alg,
+                                   const void *const *msgs, const size_t *lens, size_t count,
+                                   uint8_t *out) {
+    size_t dlen = cz_digest_length(alg);
+
+    for (size_t i = 0; i < count; i++) {
+        cz_digest_ctx ctx;
+        cz_digest_init(&ctx, alg);
+        cz_digest_update(&ctx, msgs[i], lens[i]);
+        cz_digest_final(&ctx, out + i * dlen);
+    }
+}
+
+void cz_batch_digest(CZDigestAlgorithm alg,
+                     const void *const *msgs, const size_t *lens, size_t count,
+                     uint8_t *out) {
+    int width = cz_batch_lanes();
+    cz_batch_fn fn;
+
+    // SHA 指令逐条计算比通用向量通道快，只有标量 SHA 时才走通道
+    int sha_hardware = strcmp(cz_sha_kernel_name(), "scalar") != 0;
+
+    switch (alg) {
+        case CZDigestMD5:    fn = cz_batch_md5_fn;                              break;
+        case CZDigestSHA1:   fn = sha_hardware ? NULL : cz_batch_sha1_fn;       break;
+        case CZDigestSHA256: fn = sha_hardware ? NULL : cz_batch_sha256_fn;     break;
+        default:             fn = NULL;                                         break;
+    }
+
+    size_t *order = NULL;
+    if (fn != NULL && count >= 2) {
+        order = malloc(count * sizeof(size_t));
+    }
+    if (order == NULL) {
+        cz_batch_digest_serial(alg, msgs, lens, count, out);
+        return;
+    }
+
+    // 分组数相同的消息放进同一组，减少空转的通道。
+    // 计数排序是稳定的，桶内保持原来的顺序，读消息和写结果仍然大致连续
+    size_t starts[CZ_BATCH_BUCKETS] = { 0 };
+    for (size_t i = 0; i < count; i++) {
+        starts[cz_batch_bucket(lens[i])]++;
+    }
+    for (size_t b = 0, sum = 0; b < CZ_BATCH_BUCKETS; b++) {
+        size_t n = starts[b];
+        starts[b] = sum;
+        sum += n;
+    }
+    for (size_t i = 0; i < count; i++) {
+        order[starts[cz_batch_bucket(lens[i])]++] = i;
+    }
+
+    size_t dlen = cz_digest_length(alg);
+    int big_endian = alg != CZDigestMD5;
+    cz_batch_lane lanes[8];
+
+    for (size_t i = 0; i < count; i += width) {
+        for (int l = 0; l < width; l++) {
+            if (i + l < count) {
+                size_t index = order[i + l];
+                cz_batch_lane_init(&lanes[l], msgs[index], lens[index], out + index * dlen, big_endian);
+            } else {
+                cz_batch_lane_empty(&lanes[l]);
+            }
+        }
+        fn(lanes);
+    }
+
+    free(order);
+}
@@ -0,0 +1,43 @@
+//
+//  cz_batch.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/12.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_batch_h
+#define cz_batch_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cz_digest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 批量散列多条互不相关的短消息
+///
+/// MD5 / SHA1 / SHA256 把多条消息放进 SIMD 的不同通道同时压缩
+/// (x86 AVX2 为 8 路，其余 4 路)；其他算法逐条计算。
+/// 当前 SHA 实现使用硬件指令 (cz_sha_kernel_name() 不是 "scalar") 时，
+/// SHA1 / SHA256 也逐条计算，单条的 SHA 指令比多通道更快
+///
+/// @param alg   散列算法
+/// @param msgs  消息数组
+/// @param lens  每条消息的字节数
+/// @param count 消息条数
+/// @param out   结果依次连续写入，需要 count * cz_digest_length(alg) 字节
+void cz_batch_digest(CZDigestAlgorithm alg,
+                     const void *const *msgs, const size_t *lens, size_t count,
+                     uint8_t *out);
+
+/// 当前批量散列的通道数
+int cz_batch_lanes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_batch_h */
@@ -0,0 +1,260 @@
+//
+//  cz_batch_lanes.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/12.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+// 多通道压缩函数模板，只由 cz_batch.c 包含
+//
+// 包含前定义：
+//   CZ_LANES   通道数
+//   CZ_TARGET  函数的目标指令集属性，可以为空
+
+#define CZ_BATCH_CAT2(a, b)     a##_##b
+#define CZ_BATCH_CAT(a, b)      CZ_BATCH_CAT2(a, b)
+#define CZ_BATCH_FN(name)       CZ_BATCH_CAT(name, CZ_LANES)
+#define CZ_VEC                  CZ_BATCH_FN(cz_batch_vec)
+
+typedef uint32_t CZ_VEC __attribute__((vector_size(4 * CZ_LANES)));
+
+#define CZ_VROTL(x, n)          (((x) << (n)) | ((x) >> (32 - (n))))
+#define CZ_VROTR(x, n)          (((x) >> (n)) | ((x) << (32 - (n))))
+
+/// 第 b 个分组时仍在计算的通道为全 1，其余为 0
+CZ_TARGET
+static inline CZ_VEC CZ_BATCH_FN(cz_batch_active)(const cz_batch_lane *lanes, size_t b) {
+    CZ_VEC mask;
+
+    for (int l = 0; l < CZ_LANES; l++) {
+        mask[l] = b < lanes[l].nblocks ? 0xffffffffu : 0;
+    }
+    return mask;
+}
+
+CZ_TARGET
+static inline size_t CZ_BATCH_FN(cz_batch_max_blocks)(const cz_batch_lane *lanes) {
+    size_t max = 0;
+
+    for (int l = 0; l < CZ_LANES; l++) {
+        if (lanes[l].nblocks > max) {
+            max = lanes[l].nblocks;
+        }
+    }
+    return max;
+}
+
+/// 取各通道第 b 个分组的 16 个字，先按字转置到数组再整体载入向量
+#define CZ_BATCH_LOAD(name, load)                                                   \
+CZ_TARGET                                                                           \
+static inline void CZ_BATCH_FN(name)(const cz_batch_lane *lanes, size_t b, CZ_VEC w[16]) { \
+    uint32_t words[16][CZ_LANES];                                                   \
+                                                                                    \
+    for (int l = 0; l < CZ_LANES; l++) {                                            \
+        const uint8_t *p = cz_batch_block(&lanes[l], b);                            \
+        for (int j = 0; j < 16; j++) {                                              \
+            words[j][l] = load(p + 4 * j);                                          \
+        }                                                                           \
+    }                                                                               \
+    memcpy(w, words, sizeof(words));                                                \
+}
+
+CZ_BATCH_LOAD(cz_batch_load_le, cz_batch_load_le32)
+CZ_BATCH_LOAD(cz_batch_load_be, cz_batch_load_be32)
+
+#undef CZ_BATCH_LOAD
+
+#pragma mark - MD5
+
+CZ_TARGET
+static void CZ_BATCH_FN(cz_batch_md5)(cz_batch_lane *lanes) {
+    CZ_VEC h[4], m[16];
+
+    for (int i = 0; i < 4; i++) {
+        h[i] = (CZ_VEC){ 0 } + cz_batch_md5_iv[i];
+    }
+
+    size_t nblocks = CZ_BATCH_FN(cz_batch_max_blocks)(lanes);
+
+    for (size_t b = 0; b < nblocks; b++) {
+        CZ_BATCH_FN(cz_batch_load_le)(lanes, b, m);
+
+        CZ_VEC a = h[0], bb = h[1], c = h[2], d = h[3];
+
+        CZ_BATCH_UNROLL
+        for (int i = 0; i < 64; i++) {
+            CZ_VEC f;
+            int g;
+
+            if (i < 16) {
+                f = (bb & c) | (~bb & d);
+                g = i;
+            } else if (i < 32) {
+                f = (d & bb) | (~d & c);
+                g = (5 * i + 1) & 15;
+            } else if (i < 48) {
+                f = bb ^ c ^ d;
+                g = (3 * i + 5) & 15;
+            } else {
+                f = c ^ (bb | ~d);
+                g = (7 * i) & 15;
+            }
+            f = f + a + cz_batch_md5_k[i] + m[g];
+            a = d;
+            d = c;
+            c = bb;
+            bb = bb + CZ_VROTL(f, cz_batch_md5_r[i]);
+        }
+
+        CZ_VEC active = CZ_BATCH_FN(cz_batch_active)(lanes, b);
+        h[0] = ((h[0] + a) & active) | (h[0] & ~active);
+        h[1] = ((h[1] + bb) & active) | (h[1] & ~active);
+        h[2] = ((h[2] + c) & active) | (h[2] & ~active);
+        h[3] = ((h[3] + d) & active) | (h[3] & ~active);
+    }
+
+    for (int l = 0; l < CZ_LANES; l++) {
+        if (lanes[l].out != NULL) {
+            for (int i = 0; i < 4; i++) {
+                cz_batch_store_le32(lanes[l].out + 4 * i, h[i][l]);
+            }
+        }
+    }
+}
+
+#pragma mark - SHA1
+
+CZ_TARGET
+static void CZ_BATCH_FN(cz_batch_sha1)(cz_batch_lane *lanes) {
+    CZ_VEC h[5], w[16];
+
+    for (int i = 0; i < 5; i++) {
+        h[i] = (CZ_VEC){ 0 } + cz_batch_sha1_iv[i];
+    }
+
+    size_t nblocks = CZ_BATCH_FN(cz_batch_max_blocks)(lanes);
+
+    for (size_t b = 0; b < nblocks; b++) {
+        CZ_BATCH_FN(cz_batch_load_be)(lanes, b, w);
+
+        CZ_VEC a = h[0], bb = h[1], c = h[2], d = h[3], e = h[4];
+
+        CZ_BATCH_UNROLL
+        for (int i = 0; i < 80; i++) {
+            if (i >= 16) {
+                CZ_VEC x = w[(i - 3) & 15] ^ w[(i - 8) & 15] ^ w[(i - 14) & 15] ^ w[i & 15];
+                w[i & 15] = CZ_VROTL(x, 1);
+            }
+
+            CZ_VEC f;
+            uint32_t k;
+
+            if (i < 20) {
+                f = (bb & c) | (~bb & d);
+                k = 0x5a827999;
+            } else if (i < 40) {
+                f = bb ^ c ^ d;
+                k = 0x6ed9eba1;
+            } else if (i < 60) {
+                f = (bb & c) | (bb & d) | (c & d);
+                k = 0x8f1bbcdc;
+            } else {
+                f = bb ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+
+            CZ_VEC t = CZ_VROTL(a, 5) + f + e + k + w[i & 15];
+            e = d;
+            d = c;
+            c = CZ_VROTL(bb, 30);
+            bb = a;
+            a = t;
+        }
+
+        CZ_VEC active = CZ_BATCH_FN(cz_batch_active)(lanes, b);
+        h[0] = ((h[0] + a) & active) | (h[0] & ~active);
+        h[1] = ((h[1] + bb) & active) | (h[1] & ~active);
+        h[2] = ((h[2] + c) & active) | (h[2] & ~active);
+        h[3] = ((h[3] + d) & active) | (h[3] & ~active);
+        h[4] = ((h[4] + e) & active) | (h[4] & ~active);
+    }
+
+    for (int l = 0; l < CZ_LANES; l++) {
+        if (lanes[l].out != NULL) {
+            for (int i = 0; i < 5; i++) {
+                cz_batch_store_be32(lanes[l].out + 4 * i, h[i][l]);
+            }
+        }
+    }
+}
+
+#pragma mark - SHA256
+
+CZ_TARGET
+static void CZ_BATCH_FN(cz_batch_sha256)(cz_batch_lane *lanes) {
+    CZ_VEC h[8], w[16];
+
+    for (int i = 0; i < 8; i++) {
+        h[i] = (CZ_VEC){ 0 } + cz_batch_sha256_iv[i];
+    }
+
+    size_t nblocks = CZ_BATCH_FN(cz_batch_max_blocks)(lanes);
+
+    for (size_t b = 0; b < nblocks; b++) {
+        CZ_BATCH_FN(cz_batch_load_be)(lanes, b, w);
+
+        CZ_VEC a = h[0], bb = h[1], c = h[2], d = h[3];
+        CZ_VEC e = h[4], f = h[5], g = h[6], hh = h[7];
+
+        CZ_BATCH_UNROLL
+        for (int i = 0; i < 64; i++) {
+            if (i >= 16) {
+                CZ_VEC w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+                CZ_VEC s0 = CZ_VROTR(w15, 7) ^ CZ_VROTR(w15, 18) ^ (w15 >> 3);
+                CZ_VEC s1 = CZ_VROTR(w2, 17) ^ CZ_VROTR(w2, 19) ^ (w2 >> 10);
+                w[i & 15] = w[i & 15] + s0 + w[(i - 7) & 15] + s1;
+            }
+
+            CZ_VEC S1 = CZ_VROTR(e, 6) ^ CZ_VROTR(e, 11) ^ CZ_VROTR(e, 25);
+            CZ_VEC ch = (e & f) ^ (~e & g);
+            CZ_VEC t1 = hh + S1 + ch + cz_batch_sha256_k[i] + w[i & 15];
+            CZ_VEC S0 = CZ_VROTR(a, 2) ^ CZ_VROTR(a, 13) ^ CZ_VROTR(a, 22);
+            CZ_VEC maj = (a & bb) ^ (a & c) ^ (bb & c);
+
+            hh = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = bb;
+            bb = a;
+            a = t1 + S0 + maj;
+        }
+
+        CZ_VEC active = CZ_BATCH_FN(cz_batch_active)(lanes, b);
+        h[0] = ((h[0] + a) & active) | (h[0] & ~active);
+        h[1] = ((h[1] + bb) & active) | (h[1] & ~active);
+        h[2] = ((h[2] + c) & active) | (h[2] & ~active);
+        h[3] = ((h[3] + d) & active) | (h[3] & ~active);
+        h[4] = ((h[4] + e) & active) | (h[4] & ~active);
+        h[5] = ((h[5] + f) & active) | (h[5] & ~active);
+        h[6] = ((h[6] + g) & active) | (h[6] & ~active);
+        h[7] = ((h[7] + hh) & active) | (h[7] & ~active);
+    }
+
+    for (int l = 0; l < CZ_LANES; l++) {
+        if (lanes[l].out != NULL) {
+            for (int i = 0; i < 8; i++) {
+                cz_batch_store_be32(lanes[l].out + 4 * i, h[i][l]);
+            }
+        }
+    }
+}
+
+#undef CZ_VROTR
+#undef CZ_VROTL
+#undef CZ_VEC
+#undef CZ_BATCH_FN
+#undef CZ_BATCH_CAT
+#undef CZ_BATCH_CAT2
@@ -0,0 +1,292 @@
+//
+//  cz_crc32c.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/20.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_crc32c.h"
+#include "cz_file.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define CZ_CRC32C_ARMV8 1
+#include <arm_acle.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || defined(__GNUC__))
+#define CZ_CRC32C_SSE42 1
+#include <cpuid.h>
+#include <nmmintrin.h>
+#define CZ_SSE42_TARGET __attribute__((target("sse4.2")))
+#endif
+
+/// 反射后的 Castagnoli 多项式
+#define CZ_CRC32C_POLY          0x82f63b78u
+
+/// 硬件路径每段的长度，3 段交替计算
+#define CZ_CRC32C_LANE          4096
+
+/// 内部函数都处理未取反的寄存器值
+typedef uint32_t (*cz_crc32c_fn)(uint32_t crc, const uint8_t *p, size_t len);
+
+#pragma mark - GF(2) 运算
+
+/// a * b mod P (反射表示)
+static uint32_t cz_crc32c_multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = 1u << 31, p = 0;
+
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CZ_CRC32C_POLY : b >> 1;
+    }
+    return p;
+}
+
+/// x^(2^k) mod P，k = 0 ~ 31
+static uint32_t cz_crc32c_x2n[32];
+
+/// x^(8 * CZ_CRC32C_LANE) mod P，把一段的寄存器值移过后一段
+static uint32_t cz_crc32c_lane_shift;
+
+/// x^(n * 2^k) mod P
+static uint32_t cz_crc32c_x2nmodp(uint64_t n, unsigned k) {
+    uint32_t p = 1u << 31;
+
+    while (n) {
+        if (n & 1) {
+            p = cz_crc32c_multmodp(cz_crc32c_x2n[k & 31], p);
+        }
+        n >>= 1;
+        k++;
+    }
+    return p;
+}
+
+#pragma mark - 查表
+
+static uint32_t cz_crc32c_table[8][256];
+
+static uint32_t cz_crc32c_sw(uint32_t crc, const uint8_t *p, size_t len) {
+    // 对齐到 8 字节
+    while (len > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = cz_crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+        len--;
+    }
+
+    while (len >= 8) {
+        uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+        uint32_t hi = (uint32_t)p[4] | (uint32_t)p[5] << 8 | (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+
+        crc = cz_crc32c_table[7][lo & 0xff] ^ cz_crc32c_table[6][(lo >> 8) & 0xff] ^
+              cz_crc32c_table[5][(lo >> 16) & 0xff] ^ cz_crc32c_table[4][lo >> 24] ^
+              cz_crc32c_table[3][hi & 0xff] ^ cz_crc32c_table[2][(hi >> 8) & 0xff] ^
+              cz_crc32c_table[1][(hi >> 16) & 0xff] ^ cz_crc32c_table[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+
+    while (len > 0) {
+        crc = cz_crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+        len--;
+    }
+    return crc;
+}
+
+#pragma mark - ARMv8
+
+#if CZ_CRC32C_ARMV8
+
+static inline uint32_t cz_crc32c_armv8_run(uint32_t crc, const uint8_t *p, size_t len) {
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len > 0) {
+        crc = __crc32cb(crc, *p++);
+        len--;
+    }
+    return crc;
+}
+
+static uint32_t cz_crc32c_armv8(uint32_t crc, const uint8_t *p, size_t len) {
+    while (len >= 3 * CZ_CRC32C_LANE) {
+        uint32_t c0 = crc, c1 = 0, c2 = 0;
+
+        for (size_t i = 0; i < CZ_CRC32C_LANE; i += 8) {
+            uint64_t v0, v1, v2;
+            memcpy(&v0, p + i, 8);
+            memcpy(&v1, p + CZ_CRC32C_LANE + i, 8);
+            memcpy(&v2, p + 2 * CZ_CRC32C_LANE + i, 8);
+            c0 = __crc32cd(c0, v0);
+            c1 = __crc32cd(c1, v1);
+            c2 = __crc32cd(c2, v2);
+        }
+
+        crc = cz_crc32c_multmodp(cz_crc32c_lane_shift, c0) ^ c1;
+        crc = cz_crc32c_multmodp(cz_crc32c_lane_shift, crc) ^ c2;
+        p += 3 * CZ_CRC32C_LANE;
+        len -= 3 * CZ_CRC32C_LANE;
+    }
+    return cz_crc32c_armv8_run(crc, p, len);
+}
+
+#endif
+
+#pragma mark - SSE4.2
+
+#if CZ_CRC32C_SSE42
+
+#if defined(__x86_64__)
+#define CZ_CRC32C_SSE42_WORD    8
+#define CZ_CRC32C_SSE42_STEP(c, p) \
+    ((uint32_t)_mm_crc32_u64((c), cz_crc32c_load64(p)))
+#else
+#define CZ_CRC32C_SSE42_WORD    4
+#define CZ_CRC32C_SSE42_STEP(c, p) \
+    _mm_crc32_u32((c), cz_crc32c_load32(p))
+#endif
+
+static inline uint64_t cz_crc32c_load64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint32_t cz_crc32c_load32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+CZ_SSE42_TARGET
+static uint32_t cz_crc32c_sse42(uint32_t crc, const uint8_t *p, size_t len) {
+    while (len >= 3 * CZ_CRC32C_LANE) {
+        uint32_t c0 = crc, c1 = 0, c2 = 0;
+
+        for (size_t i = 0; i < CZ_CRC32C_LANE; i += CZ_CRC32C_SSE42_WORD) {
+            c0 = CZ_CRC32C_SSE42_STEP(c0, p + i);
+            c1 = CZ_CRC32C_SSE42_STEP(c1, p + CZ_CRC32C_LANE + i);
+            c2 = CZ_CRC32C_SSE42_STEP(c2, p + 2 * CZ_CRC32C_LANE + i);
+        }
+
+        crc = cz_crc32c_multmodp(cz_crc32c_lane_shift, c0) ^ c1;
+        crc = cz_crc32c_multmodp(cz_crc32c_lane_shift, crc) ^ c2;
+        p += 3 * CZ_CRC32C_LANE;
+        len -= 3 * CZ_CRC32C_LANE;
+    }
+
+    while (len >= CZ_CRC32C_SSE42_WORD) {
+        crc = CZ_CRC32C_SSE42_STEP(crc, p);
+        p += CZ_CRC32C_SSE42_WORD;
+        len -= CZ_CRC32C_SSE42_WORD;
+    }
+    while (len > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        len--;
+    }
+    return crc;
+}
+
+static int cz_cpu_has_sse42(void) {
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    return (ecx & (1u << 20)) != 0;
+}
+
+#endif
+
+#pragma mark - 运行时选择
+
+static cz_crc32c_fn cz_crc32c_selected = cz_crc32c_sw;
+static const char *cz_crc32c_selected_name = "table";
+static pthread_once_t cz_crc32c_once = PTHREAD_ONCE_INIT;
+
+static void cz_crc32c_select(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ CZ_CRC32C_POLY : c >> 1;
+        }
+        cz_crc32c_table[0][n] = c;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = cz_crc32c_table[0][n];
+        for (int t = 1; t < 8; t++) {
+            c = cz_crc32c_table[0][c & 0xff] ^ (c >> 8);
+            cz_crc32c_table[t][n] = c;
+        }
+    }
+
+    // x^1，之后逐次平方
+    uint32_t p = 1u << 30;
+    for (int k = 0; k < 32; k++) {
+        cz_crc32c_x2n[k] = p;
+        p = cz_crc32c_multmodp(p, p);
+    }
+    cz_crc32c_lane_shift = cz_crc32c_x2nmodp(CZ_CRC32C_LANE, 3);
+
+#if CZ_CRC32C_ARMV8
+    cz_crc32c_selected = cz_crc32c_armv8;
+    cz_crc32c_selected_name = "armv8";
+#elif CZ_CRC32C_SSE42
+    if (cz_cpu_has_sse42()) {
+        cz_crc32c_selected = cz_crc32c_sse42;
+        cz_crc32c_selected_name = "sse4.2";
+    }
+#endif
+}
+
+const char *cz_crc32c_kernel_name(void) {
+    pthread_once(&cz_crc32c_once, cz_crc32c_select);
+    return cz_crc32c_selected_name;
+}
+
+#pragma mark - 接口
+
+uint32_t cz_crc32c(uint32_t crc, const void *data, size_t len) {
+    pthread_once(&cz_crc32c_once, cz_crc32c_select);
+    return ~cz_crc32c_selected(~crc, data, len);
+}
+
+uint32_t cz_crc32c_ref(uint32_t crc, const void *data, size_t len) {
+    pthread_once(&cz_crc32c_once, cz_crc32c_select);
+    return ~cz_crc32c_sw(~crc, data, len);
+}
+
+uint32_t cz_crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t len2) {
+    pthread_once(&cz_crc32c_once, cz_crc32c_select);
+    return cz_crc32c_multmodp(cz_crc32c_x2nmodp(len2, 3), crc1) ^ crc2;
+}
+
+static int cz_crc32c_chunk(void *ctx, const uint8_t *bytes, size_t len) {
+    uint32_t *crc = ctx;
+    *crc = cz_crc32c(*crc, bytes, len);
+    return 0;
+}
+
+int cz_crc32c_file(const char *path, uint32_t *crc) {
+    uint32_t value = 0;
+
+    if (cz_file_read_chunks(path, cz_crc32c_chunk, &value) != 0) {
+        return -1;
+    }
+    *crc = value;
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+//
+//  cz_crc32c.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/20.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_crc32c_h
+#define cz_crc32c_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// CRC32C (Castagnoli) 校验，用于发现缓存文件的写入撕裂
+///
+/// ARMv8 使用 CRC32 指令，x86 运行时检测 SSE4.2，其余使用 slicing-by-8 查表；
+/// 硬件路径把大块数据分成 3 段交替计算，隐藏指令延迟
+
+/// 累加计算
+///
+/// @param crc  上一段的结果，第一段传 0
+/// @param data 数据
+/// @param len  数据长度
+///
+/// @return 到当前为止的 CRC32C
+uint32_t cz_crc32c(uint32_t crc, const void *data, size_t len);
+
+/// 查表参考实现，与 cz_crc32c 的接口相同，用于对照测试
+uint32_t cz_crc32c_ref(uint32_t crc, const void *data, size_t len);
+
+/// 合并两段的结果：crc(A || B) = cz_crc32c_combine(crc(A), crc(B), len(B))
+///
+/// 多线程分块计算后按顺序合并，耗时与 len2 的位数成正比
+uint32_t cz_crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t len2);
+
+/// 计算整个文件的 CRC32C
+///
+/// @return 0 成功，-1 文件无法读取 (errno 保留)
+int cz_crc32c_file(const char *path, uint32_t *crc);
+
+/// 当前使用的实现："armv8" / "sse4.2" / "table"
+const char *cz_crc32c_kernel_name(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_crc32c_h */
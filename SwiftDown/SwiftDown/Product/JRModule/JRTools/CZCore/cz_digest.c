@@ -0,0 +1,282 @@
+//
+//  cz_digest.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/9.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_digest.h"
+#include "cz_file.h"
+
+#include <string.h>
+
+/// CC_LONG 是 32 位，超长输入需要分段
+#define CZ_DIGEST_MAX_UPDATE ((size_t)1 << 30)
+
+size_t cz_digest_length(CZDigestAlgorithm alg) {
+    switch (alg) {
+        case CZDigestMD5:    return CC_MD5_DIGEST_LENGTH;
+        case CZDigestSHA1:   return CC_SHA1_DIGEST_LENGTH;
+        case CZDigestSHA224: return CC_SHA224_DIGEST_LENGTH;
+        case CZDigestSHA256: return CC_SHA256_DIGEST_LENGTH;
+        case CZDigestSHA384: return CC_SHA384_DIGEST_LENGTH;
+        case CZDigestSHA512: return CC_SHA512_DIGEST_LENGTH;
+        default:             return 0;
+    }
+}
+
+#pragma mark - 单个算法
+
+void cz_digest_init(cz_digest_ctx *ctx, CZDigestAlgorithm alg) {
+    ctx->alg = alg;
+
+    switch (alg) {
+        case CZDigestMD5:    CC_MD5_Init(&ctx->ctx.md5);       break;
+        case CZDigestSHA1:   cz_sha1_init(&ctx->ctx.sha1);     break;
+        case CZDigestSHA224: cz_sha224_init(&ctx->ctx.sha256); break;
+        case CZDigestSHA256: cz_sha256_init(&ctx->ctx.sha256); break;
+        case CZDigestSHA384: CC_SHA384_Init(&ctx->ctx.sha512); break;
+        case CZDigestSHA512: CC_SHA512_Init(&ctx->ctx.sha512); break;
+        default: break;
+    }
+}
+
+void cz_digest_update(cz_digest_ctx *ctx, const void *data, size_t len) {
+    switch (ctx->alg) {
+        case CZDigestSHA1:
+            cz_sha1_update(&ctx->ctx.sha1, data, len);
+            return;
+        case CZDigestSHA224:
+        case CZDigestSHA256:
+            cz_sha256_update(&ctx->ctx.sha256, data, len);
+            return;
+        default:
+            break;
+    }
+
+    const uint8_t *p = data;
+
+    while (len > 0) {
+        CC_LONG n = (CC_LONG)(len < CZ_DIGEST_MAX_UPDATE ? len : CZ_DIGEST_MAX_UPDATE);
+
+        switch (ctx->alg) {
+            case CZDigestMD5:    CC_MD5_Update(&ctx->ctx.md5, p, n);       break;
+            case CZDigestSHA384: CC_SHA384_Update(&ctx->ctx.sha512, p, n); break;
+            case CZDigestSHA512: CC_SHA512_Update(&ctx->ctx.sha512, p, n); break;
+            default: break;
+        }
+        p += n;
+        len -= n;
+    }
+}
+
+void cz_digest_final(cz_digest_ctx *ctx, uint8_t *out) {
+    switch (ctx->alg) {
+        case CZDigestMD5:    CC_MD5_Final(out, &ctx->ctx.md5);       break;
+        case CZDigestSHA1:   cz_sha1_final(&ctx->ctx.sha1, out);     break;
+        case CZDigestSHA224: cz_sha256_final(&ctx->ctx.sha256, out); break;
+        case CZDigestSHA256: cz_sha256_final(&ctx->ctx.sha256, out); break;
+        case CZDigestSHA384: CC_SHA384_Final(out, &ctx->ctx.sha512); break;
+        case CZDigestSHA512: CC_SHA512_Final(out, &ctx->ctx.sha512); break;
+        default: break;
+    }
+}
+
+void cz_digest(CZDigestAlgorithm alg, const void *data, size_t len, uint8_t *out) {
+    cz_digest_ctx ctx;
+
+    cz_digest_init(&ctx, alg);
+    cz_digest_update(&ctx, data, len);
+    cz_digest_final(&ctx, out);
+}
+
+#pragma mark - 状态保存
+
+static const uint8_t cz_digest_state_magic[4] = { 'C', 'Z', 'H', '1' };
+
+#define CZ_DIGEST_STATE_HEADER 16
+
+static void cz_state_store_le(uint8_t *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint64_t cz_state_load_le(const uint8_t *p, int bytes) {
+    uint64_t v = 0;
+
+    for (int i = 0; i < bytes; i++) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+int cz_digest_resumable(CZDigestAlgorithm alg) {
+    return alg == CZDigestSHA1 || alg == CZDigestSHA224 || alg == CZDigestSHA256;
+}
+
+uint64_t cz_digest_processed(const cz_digest_ctx *ctx) {
+    switch (ctx->alg) {
+        case CZDigestSHA1:   return ctx->ctx.sha1.length;
+        case CZDigestSHA224:
+        case CZDigestSHA256: return ctx->ctx.sha256.length;
+        default:             return 0;
+    }
+}
+
+size_t cz_digest_export(const cz_digest_ctx *ctx, uint8_t *out) {
+    const uint32_t *h;
+    const uint8_t *buffer;
+    uint32_t buffered;
+    int words;
+
+    switch (ctx->alg) {
+        case CZDigestSHA1:
+            h = ctx->ctx.sha1.h;
+            buffer = ctx->ctx.sha1.buffer;
+            buffered = ctx->ctx.sha1.buffered;
+            words = 5;
+            break;
+        case CZDigestSHA224:
+        case CZDigestSHA256:
+            h = ctx->ctx.sha256.h;
+            buffer = ctx->ctx.sha256.buffer;
+            buffered = ctx->ctx.sha256.buffered;
+            words = 8;
+            break;
+        default:
+            return 0;
+    }
+
+    memcpy(out, cz_digest_state_magic, 4);
+    out[4] = (uint8_t)ctx->alg;
+    out[5] = (uint8_t)buffered;
+    out[6] = 0;
+    out[7] = 0;
+    cz_state_store_le(out + 8, cz_digest_processed(ctx), 8);
+
+    uint8_t *p = out + CZ_DIGEST_STATE_HEADER;
+    for (int i = 0; i < words; i++) {
+        cz_state_store_le(p + 4 * i, h[i], 4);
+    }
+    p += 4 * words;
+
+    memcpy(p, buffer, buffered);
+
+    return (size_t)(p - out) + buffered;
+}
+
+int cz_digest_import(cz_digest_ctx *ctx, const uint8_t *data, size_t len) {
+    if (len < CZ_DIGEST_STATE_HEADER || memcmp(data, cz_digest_state_magic, 4) != 0) {
+        return -1;
+    }
+
+    CZDigestAlgorithm alg = (CZDigestAlgorithm)data[4];
+    uint32_t buffered = data[5];
+    uint64_t length = cz_state_load_le(data + 8, 8);
+
+    if (!cz_digest_resumable(alg) || buffered >= CZ_SHA_BLOCK_LENGTH || (length & 63) != buffered) {
+        return -1;
+    }
+
+    int words = alg == CZDigestSHA1 ? 5 : 8;
+    if (len != CZ_DIGEST_STATE_HEADER + 4 * (size_t)words + buffered) {
+        return -1;
+    }
+
+    // 先按算法初始化，保留 digest_length 等固定字段
+    cz_digest_init(ctx, alg);
+
+    uint32_t *h;
+    uint8_t *buffer;
+
+    if (alg == CZDigestSHA1) {
+        ctx->ctx.sha1.length = length;
+        ctx->ctx.sha1.buffered = buffered;
+        h = ctx->ctx.sha1.h;
+        buffer = ctx->ctx.sha1.buffer;
+    } else {
+        ctx->ctx.sha256.length = length;
+        ctx->ctx.sha256.buffered = buffered;
+        h = ctx->ctx.sha256.h;
+        buffer = ctx->ctx.sha256.buffer;
+    }
+
+    const uint8_t *p = data + CZ_DIGEST_STATE_HEADER;
+    for (int i = 0; i < words; i++) {
+        h[i] = (uint32_t)cz_state_load_le(p + 4 * i, 4);
+    }
+    p += 4 * words;
+
+    memcpy(buffer, p, buffered);
+
+    return 0;
+}
+
+#pragma mark - 多个算法
+
+void cz_multi_digest_init(cz_multi_digest *md, CZDigestMask mask) {
+    md->mask = mask & CZDigestMaskAll;
+
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        if (md->mask & CZDigestMaskOf(alg)) {
+            cz_digest_init(&md->ctx[alg], (CZDigestAlgorithm)alg);
+        }
+    }
+}
+
+void cz_multi_digest_update(cz_multi_digest *md, const void *data, size_t len) {
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        if (md->mask & CZDigestMaskOf(alg)) {
+            cz_digest_update(&md->ctx[alg], data, len);
+        }
+    }
+}
+
+void cz_multi_digest_final(cz_multi_digest *md, uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]) {
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        if (md->mask & CZDigestMaskOf(alg)) {
+            cz_digest_final(&md->ctx[alg], out[alg]);
+        }
+    }
+}
+
+typedef struct {
+    cz_multi_digest md;
+    const int      *cancelled;
+} cz_multi_digest_job;
+
+static int cz_multi_digest_chunk(void *ctx, const uint8_t *bytes, size_t len) {
+    cz_multi_digest_job *job = ctx;
+
+    if (job->cancelled != NULL && __atomic_load_n(job->cancelled, __ATOMIC_RELAXED)) {
+        return 1;
+    }
+    cz_multi_digest_update(&job->md, bytes, len);
+    return 0;
+}
+
+int cz_multi_digest_file(const char *path, CZDigestMask mask, uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]) {
+    return cz_multi_digest_file_mode(path, mask, CZFileReadMapped, NULL, out);
+}
+
+int cz_multi_digest_file_cancellable(const char *path, CZDigestMask mask, const int *cancelled,
+                                     uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]) {
+    return cz_multi_digest_file_mode(path, mask, CZFileReadStream, cancelled, out);
+}
+
+int cz_multi_digest_file_mode(const char *path, CZDigestMask mask, CZFileReadMode mode, const int *cancelled,
+                              uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]) {
+    cz_multi_digest_job job;
+    cz_multi_digest_init(&job.md, mask);
+    job.cancelled = cancelled;
+
+    int result = cz_file_read_chunks_mode(path, mode, cz_multi_digest_chunk, &job);
+    if (result != 0) {
+        return result;
+    }
+    cz_multi_digest_final(&job.md, out);
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+//
+//  cz_digest.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/9.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_digest_h
+#define cz_digest_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <CommonCrypto/CommonCrypto.h>
+#include "cz_file.h"
+#include "cz_sha.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 散列算法
+typedef enum {
+    CZDigestMD5 = 0,
+    CZDigestSHA1,
+    CZDigestSHA224,
+    CZDigestSHA256,
+    CZDigestSHA384,
+    CZDigestSHA512,
+    CZDigestCount
+} CZDigestAlgorithm;
+
+/// 算法集合，每个算法占一位
+typedef uint32_t CZDigestMask;
+
+#define CZDigestMaskOf(alg)     ((CZDigestMask)1 << (alg))
+#define CZDigestMaskAll         (CZDigestMaskOf(CZDigestCount) - 1)
+
+/// 最长的散列结果 (SHA512)
+#define CZ_DIGEST_MAX_LENGTH    CC_SHA512_DIGEST_LENGTH
+
+/// 单个算法的增量散列上下文
+///
+/// SHA1 / SHA224 / SHA256 使用 cz_sha 的硬件加速实现，其余使用 CommonCrypto
+typedef struct {
+    CZDigestAlgorithm alg;
+    union {
+        CC_MD5_CTX    md5;
+        cz_sha1_ctx   sha1;
+        cz_sha256_ctx sha256;
+        CC_SHA512_CTX sha512;
+    } ctx;
+} cz_digest_ctx;
+
+/// 多个算法共用一次输入的散列上下文
+typedef struct {
+    CZDigestMask  mask;
+    cz_digest_ctx ctx[CZDigestCount];
+} cz_multi_digest;
+
+/// 返回算法的散列结果长度 (字节)
+size_t cz_digest_length(CZDigestAlgorithm alg);
+
+void cz_digest_init(cz_digest_ctx *ctx, CZDigestAlgorithm alg);
+void cz_digest_update(cz_digest_ctx *ctx, const void *data, size_t len);
+void cz_digest_final(cz_digest_ctx *ctx, uint8_t *out);
+
+/// 一次性计算二进制散列结果，不分配内存
+///
+/// @param out 至少 cz_digest_length(alg) 字节
+void cz_digest(CZDigestAlgorithm alg, const void *data, size_t len, uint8_t *out);
+
+#pragma mark - 状态保存
+
+/// 序列化状态的最大长度
+#define CZ_DIGEST_STATE_MAX_LENGTH  112
+
+/// 是否支持保存、恢复中间状态 (SHA1 / SHA224 / SHA256)
+int cz_digest_resumable(CZDigestAlgorithm alg);
+
+/// 已输入的字节数，不支持的算法返回 0
+uint64_t cz_digest_processed(const cz_digest_ctx *ctx);
+
+/// 把中间状态序列化为与平台无关的格式
+///
+/// 格式：'C' 'Z' 'H' '1'、算法 (1)、缓冲字节数 (1)、保留 (2)、
+/// 已输入字节数 (8, 小端)、状态字 (4 * 5 或 4 * 8, 小端)、缓冲区内容
+///
+/// @param out 至少 CZ_DIGEST_STATE_MAX_LENGTH 字节
+///
+/// @return 写入的字节数，不支持的算法返回 0
+size_t cz_digest_export(const cz_digest_ctx *ctx, uint8_t *out);
+
+/// 从序列化数据恢复中间状态
+///
+/// @return 0 成功，-1 格式错误或算法不支持
+int cz_digest_import(cz_digest_ctx *ctx, const uint8_t *data, size_t len);
+
+#pragma mark - 多个算法
+
+/// 初始化 mask 中的所有算法
+void cz_multi_digest_init(cz_multi_digest *md, CZDigestMask mask);
+
+/// 同一块数据依次喂给 mask 中的每个算法
+void cz_multi_digest_update(cz_multi_digest *md, const void *data, size_t len);
+
+/// 结果写入 out[alg]，未选中的算法不写
+void cz_multi_digest_final(cz_multi_digest *md, uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]);
+
+/// 只读取一遍文件，同时计算 mask 中的所有散列
+///
+/// 使用 CZFileReadMapped：大文件映射后直接散列，少一次复制；
+/// 读取期间文件不能被截断，正在下载的文件使用 cz_multi_digest_file_cancellable
+///
+/// @return 0 成功，-1 文件无法读取 (errno 保留)
+int cz_multi_digest_file(const char *path, CZDigestMask mask, uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]);
+
+/// 可以取消的 cz_multi_digest_file，每读完一段检查一次 *cancelled
+///
+/// 使用 CZFileReadStream，可以用于正在变化的文件
+///
+/// @param cancelled 其他线程置为非 0 时停止读取，可以为 NULL
+///
+/// @return 0 成功，1 已取消，-1 文件无法读取 (errno 保留)
+int cz_multi_digest_file_cancellable(const char *path, CZDigestMask mask, const int *cancelled,
+                                     uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]);
+
+/// 按指定方式读取文件的 cz_multi_digest_file_cancellable
+///
+/// @return 0 成功，1 已取消，-1 文件无法读取 (errno 保留)
+int cz_multi_digest_file_mode(const char *path, CZDigestMask mask, CZFileReadMode mode, const int *cancelled,
+                              uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_digest_h */
@@ -0,0 +1,350 @@
+//
+//  cz_fasthash.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/18.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_fasthash.h"
+
+#include <string.h>
+
+#define CZ_FASTHASH_STRIPE      64
+#define CZ_FASTHASH_BUFFER      256
+#define CZ_FASTHASH_BLOCK       16      // 每 16 个条带打散一次累加器
+
+#pragma mark - 常量
+
+/// 密钥，由 splitmix64 生成
+static const uint64_t cz_fasthash_secret[24] = {
+    0xc584133ac916ab3cull, 0x3ee5789041c98ac3ull, 0xf3b8488c368cb0a6ull, 0x657eecdd3cb13d09ull,
+    0xc2d326e0055bdef6ull, 0x8621a03fe0bbdb7bull, 0x8e1f7555983aa92full, 0xb54e0f1600cc4d19ull,
+    0x84bb3f97971d80abull, 0x7d29825c75521255ull, 0xc3cf17102b7f7f86ull, 0x3466e9a083914f64ull,
+    0xd81a8d2b5a4485acull, 0xdb01602b100b9ed7ull, 0xa9038a921825f10dull, 0xedf5f1d90dca2f6aull,
+    0x54496ad67bd2634cull, 0xdd7c01d4f5407269ull, 0x935e82f1db4c4f7bull, 0x69b82ebc92233300ull,
+    0x40d29eb57de1d510ull, 0xa2f09dabb45c6316ull, 0xee521d7a0f4d3872ull, 0xf16952ee72f3454full,
+};
+
+static const uint64_t cz_fasthash_acc_init[8] = {
+    0x00000000c2b2ae3dull, 0x9e3779b185ebca87ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull,
+    0x85ebca77c2b2ae63ull, 0x0000000085ebca77ull, 0x27d4eb2f165667c5ull, 0x000000009e3779b1ull,
+};
+
+/// 最后一个条带使用错开的密钥，避免与普通条带相同
+#define CZ_FASTHASH_LAST_KEY    ((const uint8_t *)cz_fasthash_secret + 8 * 13 + 3)
+
+#pragma mark - 标量工具
+
+/// 只在小端平台上使用，memcpy 由编译器优化为一次非对齐读取
+static inline uint64_t cz_fasthash_r8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t cz_fasthash_r4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+/// 64 x 64 -> 128 位乘法，结果分别写回 a (低位) / b (高位)
+static inline void cz_fasthash_mum(uint64_t *a, uint64_t *b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t cz_fasthash_mix(uint64_t a, uint64_t b) {
+    cz_fasthash_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t cz_fasthash_avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9ull;
+    h ^= h >> 32;
+    return h;
+}
+
+#pragma mark - 短数据
+
+/// 不超过 CZ_FASTHASH_BUFFER 字节，s 为 2 个密钥字
+static uint64_t cz_fasthash_short(const uint8_t *p, size_t len, uint64_t seed, const uint64_t *s) {
+    uint64_t a, b;
+
+    seed ^= cz_fasthash_mix(seed ^ s[0], s[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t shift = (len >> 3) << 2;
+            a = (cz_fasthash_r4(p) << 32) | cz_fasthash_r4(p + shift);
+            b = (cz_fasthash_r4(p + len - 4) << 32) | cz_fasthash_r4(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        const uint8_t *q = p;
+
+        while (i > 16) {
+            seed = cz_fasthash_mix(cz_fasthash_r8(q) ^ s[1], cz_fasthash_r8(q + 8) ^ seed);
+            q += 16;
+            i -= 16;
+        }
+        a = cz_fasthash_r8(p + len - 16);
+        b = cz_fasthash_r8(p + len - 8);
+    }
+
+    a ^= s[1];
+    b ^= seed;
+    cz_fasthash_mum(&a, &b);
+
+    return cz_fasthash_mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+#pragma mark - 条带累加
+
+/// 两个 64 位通道，NEON / SSE2 的原生宽度
+typedef uint64_t cz_fasthash_vec __attribute__((vector_size(16)));
+
+#if defined(__clang__)
+#define CZ_FASTHASH_SWAP(v)     __builtin_shufflevector(v, v, 1, 0)
+#else
+#define CZ_FASTHASH_SWAP(v)     __builtin_shuffle(v, (cz_fasthash_vec){ 1, 0 })
+#endif
+
+/// acc[i] += (d ^ k) 的低 32 位 * 高 32 位，相邻通道互相加上原始数据
+static inline void cz_fasthash_accumulate(cz_fasthash_vec acc[4], const uint8_t *p, const uint8_t *key) {
+    for (int i = 0; i < 4; i++) {
+        cz_fasthash_vec d, k;
+        memcpy(&d, p + 16 * i, 16);
+        memcpy(&k, key + 16 * i, 16);
+
+        cz_fasthash_vec dk = d ^ k;
+        acc[i] += CZ_FASTHASH_SWAP(d) + (dk & 0xffffffffu) * (dk >> 32);
+    }
+}
+
+static inline void cz_fasthash_scramble(cz_fasthash_vec acc[4]) {
+    const uint8_t *key = (const uint8_t *)(cz_fasthash_secret + 16);
+
+    for (int i = 0; i < 4; i++) {
+        cz_fasthash_vec k;
+        memcpy(&k, key + 16 * i, 16);
+
+        acc[i] ^= acc[i] >> 47;
+        acc[i] ^= k;
+        acc[i] *= 0x9e3779b1u;
+    }
+}
+
+/// 依次累加 count 个条带，stripes 为当前块内已累加的条带数
+static void cz_fasthash_stripes(uint64_t state[8], uint32_t *stripes, const uint8_t *p, size_t count) {
+    cz_fasthash_vec acc[4];
+    uint32_t n = *stripes;
+
+    memcpy(acc, state, sizeof(acc));
+
+    for (size_t i = 0; i < count; i++) {
+        cz_fasthash_accumulate(acc, p, (const uint8_t *)(cz_fasthash_secret + n));
+        p += CZ_FASTHASH_STRIPE;
+
+        if (++n == CZ_FASTHASH_BLOCK) {
+            cz_fasthash_scramble(acc);
+            n = 0;
+        }
+    }
+
+    memcpy(state, acc, sizeof(acc));
+    *stripes = n;
+}
+
+static void cz_fasthash_last(uint64_t state[8], const uint8_t *p) {
+    cz_fasthash_vec acc[4];
+
+    memcpy(acc, state, sizeof(acc));
+    cz_fasthash_accumulate(acc, p, CZ_FASTHASH_LAST_KEY);
+    memcpy(state, acc, sizeof(acc));
+}
+
+static void cz_fasthash_acc_reset(uint64_t acc[8], uint64_t seed) {
+    for (int i = 0; i < 8; i++) {
+        acc[i] = cz_fasthash_acc_init[i] + ((i & 1) ? 0 - seed : seed);
+    }
+}
+
+/// 合并累加器，s 为 8 个密钥字
+static uint64_t cz_fasthash_merge(const uint64_t acc[8], uint64_t start, const uint64_t *s) {
+    uint64_t r = start;
+
+    for (int i = 0; i < 4; i++) {
+        r += cz_fasthash_mix(acc[2 * i] ^ s[2 * i], acc[2 * i + 1] ^ s[2 * i + 1]);
+    }
+    return cz_fasthash_avalanche(r);
+}
+
+static uint64_t cz_fasthash_merge64(const uint64_t acc[8], uint64_t len) {
+    return cz_fasthash_merge(acc, len * 0x9e3779b185ebca87ull, cz_fasthash_secret + 11);
+}
+
+static cz_hash128 cz_fasthash_merge128(const uint64_t acc[8], uint64_t len) {
+    cz_hash128 h;
+
+    h.low = cz_fasthash_merge64(acc, len);
+    h.high = cz_fasthash_merge(acc, ~(len * 0xc2b2ae3d27d4eb4full), cz_fasthash_secret + 3);
+    return h;
+}
+
+/// 累加超过 CZ_FASTHASH_BUFFER 字节的数据，最后一个条带与前面的重叠
+static void cz_fasthash_long(uint64_t acc[8], const uint8_t *p, size_t len, uint64_t seed) {
+    uint32_t stripes = 0;
+
+    cz_fasthash_acc_reset(acc, seed);
+    cz_fasthash_stripes(acc, &stripes, p, (len - 1) / CZ_FASTHASH_STRIPE);
+    cz_fasthash_last(acc, p + len - CZ_FASTHASH_STRIPE);
+}
+
+#pragma mark - 一次性计算
+
+uint64_t cz_fasthash64(const void *data, size_t len, uint64_t seed) {
+    const uint8_t *p = data;
+
+    if (len <= CZ_FASTHASH_BUFFER) {
+        return cz_fasthash_short(p, len, seed, cz_fasthash_secret);
+    }
+
+    uint64_t acc[8];
+    cz_fasthash_long(acc, p, len, seed);
+
+    return cz_fasthash_merge64(acc, len);
+}
+
+cz_hash128 cz_fasthash128(const void *data, size_t len, uint64_t seed) {
+    const uint8_t *p = data;
+
+    if (len <= CZ_FASTHASH_BUFFER) {
+        cz_hash128 h;
+        h.low = cz_fasthash_short(p, len, seed, cz_fasthash_secret);
+        h.high = cz_fasthash_short(p, len, seed, cz_fasthash_secret + 2);
+        return h;
+    }
+
+    uint64_t acc[8];
+    cz_fasthash_long(acc, p, len, seed);
+
+    return cz_fasthash_merge128(acc, len);
+}
+
+#pragma mark - 流式计算
+
+void cz_fasthash_init(cz_fasthash_state *state, uint64_t seed) {
+    memset(state, 0, sizeof(*state));
+    state->seed = seed;
+    cz_fasthash_acc_reset(state->acc, seed);
+}
+
+void cz_fasthash_update(cz_fasthash_state *state, const void *data, size_t len) {
+    const uint8_t *p = data;
+
+    state->length += len;
+
+    // 缓冲区满了也先不累加，总长度不超过 CZ_FASTHASH_BUFFER 时要走短数据算法
+    if (state->buffered + len <= CZ_FASTHASH_BUFFER) {
+        memcpy(state->buffer + state->buffered, p, len);
+        state->buffered += (uint32_t)len;
+        return;
+    }
+
+    // 1. 补满缓冲区后累加，后面还有数据，所以这 4 个条带都不是最后一个
+    if (state->buffered > 0) {
+        size_t fill = CZ_FASTHASH_BUFFER - state->buffered;
+
+        memcpy(state->buffer + state->buffered, p, fill);
+        p += fill;
+        len -= fill;
+
+        cz_fasthash_stripes(state->acc, &state->stripes, state->buffer, CZ_FASTHASH_BUFFER / CZ_FASTHASH_STRIPE);
+        memcpy(state->last, state->buffer + CZ_FASTHASH_BUFFER - CZ_FASTHASH_STRIPE, CZ_FASTHASH_STRIPE);
+        state->buffered = 0;
+    }
+
+    // 2. 直接累加输入，至少留下 1 个字节给收尾
+    if (len > CZ_FASTHASH_BUFFER) {
+        size_t count = (len - 1) / CZ_FASTHASH_BUFFER * (CZ_FASTHASH_BUFFER / CZ_FASTHASH_STRIPE);
+        size_t bytes = count * CZ_FASTHASH_STRIPE;
+
+        cz_fasthash_stripes(state->acc, &state->stripes, p, count);
+        memcpy(state->last, p + bytes - CZ_FASTHASH_STRIPE, CZ_FASTHASH_STRIPE);
+        p += bytes;
+        len -= bytes;
+    }
+
+    memcpy(state->buffer, p, len);
+    state->buffered = (uint32_t)len;
+}
+
+/// 在副本上累加剩余数据
+static void cz_fasthash_finish(const cz_fasthash_state *state, uint64_t acc[8]) {
+    uint32_t stripes = state->stripes;
+    uint32_t buffered = state->buffered;
+
+    memcpy(acc, state->acc, sizeof(state->acc));
+    cz_fasthash_stripes(acc, &stripes, state->buffer, (buffered - 1) / CZ_FASTHASH_STRIPE);
+
+    if (buffered >= CZ_FASTHASH_STRIPE) {
+        cz_fasthash_last(acc, state->buffer + buffered - CZ_FASTHASH_STRIPE);
+    } else {
+        // 不足一个条带，用上一次累加的条带补足
+        uint8_t last[CZ_FASTHASH_STRIPE];
+        size_t keep = CZ_FASTHASH_STRIPE - buffered;
+
+        memcpy(last, state->last + buffered, keep);
+        memcpy(last + keep, state->buffer, buffered);
+        cz_fasthash_last(acc, last);
+    }
+}
+
+uint64_t cz_fasthash_final64(const cz_fasthash_state *state) {
+    if (state->length <= CZ_FASTHASH_BUFFER) {
+        return cz_fasthash64(state->buffer, (size_t)state->length, state->seed);
+    }
+
+    uint64_t acc[8];
+    cz_fasthash_finish(state, acc);
+
+    return cz_fasthash_merge64(acc, state->length);
+}
+
+cz_hash128 cz_fasthash_final128(const cz_fasthash_state *state) {
+    if (state->length <= CZ_FASTHASH_BUFFER) {
+        return cz_fasthash128(state->buffer, (size_t)state->length, state->seed);
+    }
+
+    uint64_t acc[8];
+    cz_fasthash_finish(state, acc);
+
+    return cz_fasthash_merge128(acc, state->length);
+}
+
+void cz_hash128_to_bytes(cz_hash128 hash, uint8_t out[16]) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(hash.high >> (56 - 8 * i));
+        out[8 + i] = (uint8_t)(hash.low >> (56 - 8 * i));
+    }
+}
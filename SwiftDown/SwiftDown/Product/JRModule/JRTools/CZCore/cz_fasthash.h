@@ -0,0 +1,68 @@
+//
+//  cz_fasthash.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/18.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_fasthash_h
+#define cz_fasthash_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 快速非加密散列 (xxHash3 / wyhash 同类)
+///
+/// 用于缓存文件名、内存散列表等不需要抗碰撞攻击的场景，不能用于签名和校验
+///
+/// - 不超过 16 字节：两次 64 位乘法
+/// - 17 ~ 256 字节：每 16 字节一次 64 位乘法
+/// - 超过 256 字节：8 个 64 位累加器按 64 字节条带并行累加，由编译器映射到 NEON / SSE2
+///
+/// 输入按本机字节序读取，散列值只在小端平台 (iOS / x86) 上有定义；
+/// 128 位结果写成字节时使用 cz_hash128_to_bytes，不要直接复制结构体
+
+/// 128 位结果
+typedef struct {
+    uint64_t low;
+    uint64_t high;
+} cz_hash128;
+
+/// 流式计算的上下文
+typedef struct {
+    uint64_t acc[8];
+    uint64_t seed;
+    uint64_t length;
+    uint32_t stripes;       // 当前块内已累加的条带数
+    uint32_t buffered;
+    uint8_t  buffer[256];
+    uint8_t  last[64];      // 最近一次累加的条带，收尾时补足重叠的最后 64 字节
+} cz_fasthash_state;
+
+/// 一次性计算 64 位散列
+uint64_t cz_fasthash64(const void *data, size_t len, uint64_t seed);
+
+/// 一次性计算 128 位散列
+cz_hash128 cz_fasthash128(const void *data, size_t len, uint64_t seed);
+
+/// 按大端写出 16 字节，high 在前，十六进制字符串与 128 位整数的写法相同
+void cz_hash128_to_bytes(cz_hash128 hash, uint8_t out[16]);
+
+/// 流式计算，结果与一次性计算完全相同
+void cz_fasthash_init(cz_fasthash_state *state, uint64_t seed);
+void cz_fasthash_update(cz_fasthash_state *state, const void *data, size_t len);
+
+/// 不修改上下文，之后可以继续 update
+uint64_t cz_fasthash_final64(const cz_fasthash_state *state);
+cz_hash128 cz_fasthash_final128(const cz_fasthash_state *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_fasthash_h */
@@ -0,0 +1,194 @@
+//
+//  cz_file.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/10.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#pragma mark - 映射
+
+static int cz_file_map_fd(int fd, size_t length, cz_mapped_file *file) {
+    file->bytes = NULL;
+    file->length = 0;
+
+    if (length == 0) {
+        return 0;
+    }
+
+    void *addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        return -1;
+    }
+    madvise(addr, length, MADV_SEQUENTIAL);
+
+    file->bytes = addr;
+    file->length = length;
+
+    return 0;
+}
+
+int cz_mapped_file_open(cz_mapped_file *file, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    int ret = -1;
+
+    if (fstat(fd, &st) == 0) {
+        if (S_ISREG(st.st_mode) && (uint64_t)st.st_size <= SIZE_MAX) {
+            ret = cz_file_map_fd(fd, (size_t)st.st_size, file);
+        } else {
+            errno = EINVAL;
+        }
+    }
+
+    // 映射建立后文件描述符就可以关闭了
+    int err = errno;
+    close(fd);
+    errno = err;
+
+    return ret;
+}
+
+void cz_mapped_file_close(cz_mapped_file *file) {
+    if (file->bytes != NULL) {
+        munmap((void *)file->bytes, file->length);
+    }
+    file->bytes = NULL;
+    file->length = 0;
+}
+
+#pragma mark - 分块读取
+
+/// 留一块读取缓冲区给下一次读取
+///
+/// 按页对齐的大块分配每次都是新的匿名映射，写入时逐页缺页、清零，小文件的读取时间会翻倍；
+/// 同时读取的其他线程各自分配
+static void *cz_file_spare_buffer;
+
+static void *cz_file_buffer_take(void) {
+    void *buffer = __atomic_exchange_n(&cz_file_spare_buffer, NULL, __ATOMIC_ACQUIRE);
+    if (buffer != NULL) {
+        return buffer;
+    }
+
+    // 按页对齐，内核可以整页复制
+    int err = posix_memalign(&buffer, CZ_FILE_STREAM_ALIGNMENT, CZ_FILE_STREAM_CHUNK_SIZE);
+    if (err != 0) {
+        errno = err;
+        return NULL;
+    }
+    return buffer;
+}
+
+static void cz_file_buffer_give_back(void *buffer) {
+    void *expected = NULL;
+
+    if (!__atomic_compare_exchange_n(&cz_file_spare_buffer, &expected, buffer, 0,
+                                     __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        free(buffer);
+    }
+}
+
+static int cz_file_stream_fd(int fd, cz_file_chunk_fn fn, void *ctx) {
+#if defined(F_RDAHEAD)
+    fcntl(fd, F_RDAHEAD, 1);
+#elif defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    void *buffer = cz_file_buffer_take();
+    if (buffer == NULL) {
+        return -1;
+    }
+
+    int ret = 0;
+    off_t offset = 0;
+
+    while (1) {
+        ssize_t n = pread(fd, buffer, CZ_FILE_STREAM_CHUNK_SIZE, offset);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ret = -1;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        offset += n;
+
+        if (fn(ctx, buffer, (size_t)n) != 0) {
+            ret = 1;
+            break;
+        }
+    }
+
+    int err = errno;
+    cz_file_buffer_give_back(buffer);
+    errno = err;
+
+    return ret;
+}
+
+int cz_file_read_chunks(const char *path, cz_file_chunk_fn fn, void *ctx) {
+    return cz_file_read_chunks_mode(path, CZFileReadStream, fn, ctx);
+}
+
+int cz_file_read_chunks_mode(const char *path, CZFileReadMode mode, cz_file_chunk_fn fn, void *ctx) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    cz_mapped_file file = { NULL, 0 };
+
+    int mapped = mode == CZFileReadMapped
+        && fstat(fd, &st) == 0
+        && S_ISREG(st.st_mode)
+        && st.st_size >= CZ_FILE_MAP_MIN_SIZE
+        && (uint64_t)st.st_size <= SIZE_MAX
+        && cz_file_map_fd(fd, (size_t)st.st_size, &file) == 0;
+
+    if (!mapped) {
+        int ret = cz_file_stream_fd(fd, fn, ctx);
+
+        int err = errno;
+        close(fd);
+        errno = err;
+
+        return ret;
+    }
+    close(fd);
+
+    int ret = 0;
+
+    for (size_t offset = 0; offset < file.length; offset += CZ_FILE_MAPPED_SLICE_SIZE) {
+        size_t len = file.length - offset;
+        if (len > CZ_FILE_MAPPED_SLICE_SIZE) {
+            len = CZ_FILE_MAPPED_SLICE_SIZE;
+        }
+        if (fn(ctx, file.bytes + offset, len) != 0) {
+            ret = 1;
+            break;
+        }
+    }
+    cz_mapped_file_close(&file);
+
+    return ret;
+}
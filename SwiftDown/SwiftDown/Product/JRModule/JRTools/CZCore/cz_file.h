@@ -0,0 +1,75 @@
+//
+//  cz_file.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/10.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_file_h
+#define cz_file_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 流式读取的块大小
+#define CZ_FILE_STREAM_CHUNK_SIZE   (1 << 20)
+
+/// 流式读取缓冲区的对齐
+#define CZ_FILE_STREAM_ALIGNMENT    4096
+
+/// 小于这个大小的文件不映射，建立、撤销映射的开销超过少复制一次的收益
+#define CZ_FILE_MAP_MIN_SIZE        (4 << 20)
+
+/// 映射模式下每次回调的切片大小，让调用方有机会中途取消
+#define CZ_FILE_MAPPED_SLICE_SIZE   (8 << 20)
+
+/// 分块回调，返回非 0 停止读取
+typedef int (*cz_file_chunk_fn)(void *ctx, const uint8_t *bytes, size_t len);
+
+/// 读取方式
+typedef enum {
+    /// 页对齐的缓冲区大块 pread，提示内核顺序预读；读取期间文件被截断、追加只会影响结果，不会崩溃
+    CZFileReadStream = 0,
+    /// 不小于 CZ_FILE_MAP_MIN_SIZE 的普通文件只读映射，直接把映射内存交给回调，少一次复制；
+    /// 读取期间文件被截断时访问映射会触发 SIGBUS，只用于读取期间不会被修改的文件
+    CZFileReadMapped,
+} CZFileReadMode;
+
+/// 只读映射的文件
+typedef struct {
+    const uint8_t *bytes;
+    size_t         length;
+} cz_mapped_file;
+
+/// 只读映射整个文件，空文件 bytes 为 NULL
+///
+/// 映射长度在打开时固定，之后文件被截断时访问超出部分会触发 SIGBUS，
+/// 正在下载、可能被其他线程 / 进程修改的文件不要使用
+///
+/// @return 0 成功，-1 失败 (errno 保留)
+int cz_mapped_file_open(cz_mapped_file *file, const char *path);
+
+void cz_mapped_file_close(cz_mapped_file *file);
+
+/// 顺序读取整个文件，使用 CZFileReadStream，可以用于正在变化的文件
+///
+/// @return 0 读完，1 被回调停止，-1 读取失败 (errno 保留)
+int cz_file_read_chunks(const char *path, cz_file_chunk_fn fn, void *ctx);
+
+/// 按指定方式顺序读取整个文件
+///
+/// CZFileReadMapped 遇到小文件或无法映射 (管道、32 位地址空间不足等) 时退回大块 pread
+///
+/// @return 0 读完，1 被回调停止，-1 读取失败 (errno 保留)
+int cz_file_read_chunks_mode(const char *path, CZFileReadMode mode, cz_file_chunk_fn fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_file_h */
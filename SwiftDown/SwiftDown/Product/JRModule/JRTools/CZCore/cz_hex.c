@@ -0,0 +1,105 @@
+//
+//  cz_hex.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/15.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_hex.h"
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define CZ_HEX_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#define CZ_HEX_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+static const char cz_hex_digits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+};
+
+#pragma mark - 编码
+
+/// 标量部分，处理 SIMD 剩下的尾部
+static void cz_hex_encode_scalar(const uint8_t *bytes, size_t len, char *out) {
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = cz_hex_digits[bytes[i] >> 4];
+        out[2 * i + 1] = cz_hex_digits[bytes[i] & 15];
+    }
+}
+
+void cz_hex_encode(const uint8_t *bytes, size_t len, char *out) {
+    size_t i = 0;
+
+#if CZ_HEX_NEON
+    const uint8x16_t digits = vld1q_u8((const uint8_t *)cz_hex_digits);
+    const uint8x16_t low_mask = vdupq_n_u8(0x0f);
+
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(bytes + i);
+        uint8x16x2_t pair;
+        pair.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+        pair.val[1] = vqtbl1q_u8(digits, vandq_u8(v, low_mask));
+        // 交错存储：高位字符在前
+        vst2q_u8((uint8_t *)out + 2 * i, pair);
+    }
+#elif CZ_HEX_SSSE3
+    const __m128i digits = _mm_loadu_si128((const __m128i *)cz_hex_digits);
+    const __m128i low_mask = _mm_set1_epi8(0x0f);
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), low_mask));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, low_mask));
+        _mm_storeu_si128((__m128i *)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+
+    cz_hex_encode_scalar(bytes + i, len - i, out + 2 * i);
+}
+
+#pragma mark - 解码
+
+/// 非法字符为 -1
+static const int8_t cz_hex_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+int cz_hex_decode(const char *hex, size_t len, uint8_t *out) {
+    if (len & 1) {
+        return -1;
+    }
+
+    const uint8_t *p = (const uint8_t *)hex;
+    int bad = 0;
+
+    // 先全部解码，最后统一判断，循环里没有分支
+    for (size_t i = 0; i < len / 2; i++) {
+        int hi = cz_hex_values[p[2 * i]];
+        int lo = cz_hex_values[p[2 * i + 1]];
+
+        // 非法字符为 -1，按无符号数移位
+        bad |= hi | lo;
+        out[i] = (uint8_t)((unsigned)hi << 4 | (lo & 15));
+    }
+
+    return bad < 0 ? -1 : 0;
+}
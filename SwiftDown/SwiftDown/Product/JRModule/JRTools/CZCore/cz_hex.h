@@ -0,0 +1,39 @@
+//
+//  cz_hex.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/15.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_hex_h
+#define cz_hex_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 十六进制编码 (小写)，一次写完调用方提供的缓冲区
+///
+/// @param bytes 二进制数据
+/// @param len   数据长度
+/// @param out   至少 2 * len 字节，不追加 '\0'
+void cz_hex_encode(const uint8_t *bytes, size_t len, char *out);
+
+/// 十六进制解码，大小写均可
+///
+/// @param hex 十六进制字符
+/// @param len 字符个数，必须是偶数
+/// @param out 至少 len / 2 字节
+///
+/// @return 0 成功，-1 长度为奇数或包含非法字符
+int cz_hex_decode(const char *hex, size_t len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_hex_h */
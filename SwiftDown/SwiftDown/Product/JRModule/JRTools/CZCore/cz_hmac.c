@@ -0,0 +1,82 @@
+//
+//  cz_hmac.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/14.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_hmac.h"
+
+#include <string.h>
+
+#define CZ_HMAC_MAX_BLOCK 128
+
+size_t cz_hmac_block_length(CZDigestAlgorithm alg) {
+    switch (alg) {
+        case CZDigestSHA384:
+        case CZDigestSHA512:
+            return 128;
+        default:
+            return 64;
+    }
+}
+
+void cz_hmac_key_init(cz_hmac_key *key, CZDigestAlgorithm alg, const void *secret, size_t len) {
+    size_t block = cz_hmac_block_length(alg);
+    uint8_t k[CZ_HMAC_MAX_BLOCK] = { 0 };
+    uint8_t pad[CZ_HMAC_MAX_BLOCK];
+
+    // 超过分组长度的密钥先散列
+    if (len > block) {
+        cz_digest_ctx ctx;
+        cz_digest_init(&ctx, alg);
+        cz_digest_update(&ctx, secret, len);
+        cz_digest_final(&ctx, k);
+    } else if (len > 0) {
+        memcpy(k, secret, len);
+    }
+
+    key->alg = alg;
+
+    for (size_t i = 0; i < block; i++) {
+        pad[i] = k[i] ^ 0x36;
+    }
+    cz_digest_init(&key->inner, alg);
+    cz_digest_update(&key->inner, pad, block);
+
+    for (size_t i = 0; i < block; i++) {
+        pad[i] = k[i] ^ 0x5c;
+    }
+    cz_digest_init(&key->outer, alg);
+    cz_digest_update(&key->outer, pad, block);
+
+    memset(k, 0, sizeof(k));
+    memset(pad, 0, sizeof(pad));
+}
+
+void cz_hmac_begin(cz_hmac_ctx *ctx, const cz_hmac_key *key) {
+    ctx->key = key;
+    ctx->inner = key->inner;
+}
+
+void cz_hmac_update(cz_hmac_ctx *ctx, const void *data, size_t len) {
+    cz_digest_update(&ctx->inner, data, len);
+}
+
+void cz_hmac_final(cz_hmac_ctx *ctx, uint8_t *out) {
+    uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+    cz_digest_final(&ctx->inner, digest);
+
+    cz_digest_ctx outer = ctx->key->outer;
+    cz_digest_update(&outer, digest, cz_digest_length(ctx->key->alg));
+    cz_digest_final(&outer, out);
+}
+
+void cz_hmac(const cz_hmac_key *key, const void *data, size_t len, uint8_t *out) {
+    cz_hmac_ctx ctx;
+
+    cz_hmac_begin(&ctx, key);
+    cz_hmac_update(&ctx, data, len);
+    cz_hmac_final(&ctx, out);
+}
@@ -0,0 +1,55 @@
+//
+//  cz_hmac.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/14.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_hmac_h
+#define cz_hmac_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cz_digest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 预先计算好的 HMAC 密钥
+///
+/// inner / outer 是已经吸收了 key ^ ipad、key ^ opad 分组的散列状态，
+/// 同一个密钥签名任意多条消息时只需要复制状态，不再重复处理密钥
+typedef struct {
+    CZDigestAlgorithm alg;
+    cz_digest_ctx     inner;
+    cz_digest_ctx     outer;
+} cz_hmac_key;
+
+/// 单条消息的 HMAC 上下文
+typedef struct {
+    const cz_hmac_key *key;
+    cz_digest_ctx      inner;
+} cz_hmac_ctx;
+
+/// 算法的分组长度，MD5 / SHA1 / SHA2-256 为 64，SHA2-512 为 128
+size_t cz_hmac_block_length(CZDigestAlgorithm alg);
+
+/// 处理密钥，每个密钥只需要调用一次
+void cz_hmac_key_init(cz_hmac_key *key, CZDigestAlgorithm alg, const void *secret, size_t len);
+
+void cz_hmac_begin(cz_hmac_ctx *ctx, const cz_hmac_key *key);
+void cz_hmac_update(cz_hmac_ctx *ctx, const void *data, size_t len);
+
+/// 输出 cz_digest_length(key->alg) 个字节
+void cz_hmac_final(cz_hmac_ctx *ctx, uint8_t *out);
+
+/// 一次性计算
+void cz_hmac(const cz_hmac_key *key, const void *data, size_t len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_hmac_h */
@@ -0,0 +1,478 @@
+//
+//  cz_json.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/24.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_json.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/// 下一个 token 的期望
+enum {
+    CZ_JSON_VALUE,          // 值 (开头、':' 或数组的 ',' 之后)
+    CZ_JSON_FIRST_VALUE,    // 数组的第一个值，或 ']'
+    CZ_JSON_KEY,            // 对象的 ',' 之后
+    CZ_JSON_FIRST_KEY,      // 对象的第一个 key，或 '}'
+    CZ_JSON_COLON,          // key 之后
+    CZ_JSON_NEXT,           // 值之后：',' 或容器结束
+    CZ_JSON_DONE,           // 顶层值已经结束
+};
+
+#define CZ_JSON_IN_OBJECT   1
+#define CZ_JSON_IN_ARRAY    2
+
+void cz_json_init(cz_json_parser *parser, const void *data, size_t len) {
+    parser->p = data;
+    parser->end = (const char *)data + len;
+    parser->depth = 0;
+    parser->state = CZ_JSON_VALUE;
+    parser->str = NULL;
+    parser->str_len = 0;
+    parser->str_escaped = 0;
+    parser->integer = 0;
+    parser->number = 0;
+}
+
+const char *cz_json_position(const cz_json_parser *parser) {
+    return parser->p;
+}
+
+#pragma mark - 扫描
+
+static inline const char *cz_json_skip_space(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+        p++;
+    }
+    return p;
+}
+
+#define CZ_JSON_ONES    0x0101010101010101ull
+#define CZ_JSON_HIGHS   0x8080808080808080ull
+
+/// 8 字节中是否有等于 c 的字节
+static inline uint64_t cz_json_has_byte(uint64_t v, uint8_t c) {
+    uint64_t x = v ^ (CZ_JSON_ONES * c);
+    return (x - CZ_JSON_ONES) & ~x & CZ_JSON_HIGHS;
+}
+
+/// 找到字符串的结束引号，p 指向开始引号之后
+///
+/// 每次检查 8 字节，没有 '"' 和 '\' 时整段跳过
+static const char *cz_json_scan_string(const char *p, const char *end, int *escaped) {
+    while (p < end) {
+        while (p + 8 <= end) {
+            uint64_t v;
+            memcpy(&v, p, 8);
+            if (cz_json_has_byte(v, '"') | cz_json_has_byte(v, '\\')) {
+                break;
+            }
+            p += 8;
+        }
+        if (p >= end) {
+            break;
+        }
+
+        if (*p == '"') {
+            return p;
+        }
+        if (*p == '\\') {
+            *escaped = 1;
+            if (p + 1 >= end) {
+                return NULL;
+            }
+            p += 2;
+            continue;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/// 超出 int64 范围的 double 直接转换是未定义行为，先限制在范围内 (1e999 之类溢出为 ±inf)
+static inline int64_t cz_json_clamp_integer(double number) {
+    // 2^63，可以用 double 精确表示
+    const double limit = 9223372036854775808.0;
+
+    if (number >= limit) {
+        return INT64_MAX;
+    }
+    if (number >= -limit) {
+        return (int64_t)number;
+    }
+    // 小于 -2^63，以及 NaN
+    return number < 0 ? INT64_MIN : 0;
+}
+
+/// 解析数字，成功返回结束位置
+static const char *cz_json_scan_number(cz_json_parser *parser, const char *p, const char *end, CZJSONToken *token) {
+    const char *start = p;
+    int negative = 0;
+    uint64_t value = 0;
+    int overflow = 0;
+    int fraction = 0;
+
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+    if (p >= end || *p < '0' || *p > '9') {
+        return NULL;
+    }
+    if (*p == '0' && p + 1 < end && p[1] >= '0' && p[1] <= '9') {
+        return NULL;
+    }
+    while (p < end && *p >= '0' && *p <= '9') {
+        uint64_t digit = (uint64_t)(*p - '0');
+        if (value > (UINT64_MAX - digit) / 10) {
+            overflow = 1;
+        } else {
+            value = value * 10 + digit;
+        }
+        p++;
+    }
+    if (p < end && *p == '.') {
+        fraction = 1;
+        p++;
+        if (p >= end || *p < '0' || *p > '9') {
+            return NULL;
+        }
+        while (p < end && *p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        fraction = 1;
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p >= end || *p < '0' || *p > '9') {
+            return NULL;
+        }
+        while (p < end && *p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    // 整数：不超过 int64 范围时不经过 strtod
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    if (!fraction && !overflow && value <= limit) {
+        parser->integer = negative ? (int64_t)(0 - value) : (int64_t)value;
+        parser->number = (double)parser->integer;
+        *token = CZJSONInteger;
+        return p;
+    }
+
+    // strtod 需要 '\0' 结尾，复制到栈上
+    char buffer[64];
+    size_t len = (size_t)(p - start);
+    char *copy = len < sizeof(buffer) ? buffer : malloc(len + 1);
+    memcpy(copy, start, len);
+    copy[len] = '\0';
+    parser->number = strtod(copy, NULL);
+    if (copy != buffer) {
+        free(copy);
+    }
+
+    parser->integer = cz_json_clamp_integer(parser->number);
+    *token = CZJSONDouble;
+    return p;
+}
+
+static inline int cz_json_literal(const char *p, const char *end, const char *word, size_t len) {
+    return (size_t)(end - p) >= len && memcmp(p, word, len) == 0;
+}
+
+#pragma mark - token
+
+/// 值结束后的状态
+static inline int cz_json_after_value(const cz_json_parser *parser) {
+    return parser->depth == 0 ? CZ_JSON_DONE : CZ_JSON_NEXT;
+}
+
+CZJSONToken cz_json_next(cz_json_parser *parser) {
+    const char *p = cz_json_skip_space(parser->p, parser->end);
+    const char *end = parser->end;
+
+    // 1. 值之后：逗号或容器结束
+    if (parser->state == CZ_JSON_NEXT) {
+        if (p >= end) {
+            return CZJSONError;
+        }
+        uint8_t container = parser->stack[parser->depth - 1];
+
+        if (*p == ',') {
+            parser->state = container == CZ_JSON_IN_OBJECT ? CZ_JSON_KEY : CZ_JSON_VALUE;
+            p = cz_json_skip_space(p + 1, end);
+        } else if ((*p == '}' && container == CZ_JSON_IN_OBJECT) || (*p == ']' && container == CZ_JSON_IN_ARRAY)) {
+            parser->depth--;
+            parser->state = cz_json_after_value(parser);
+            parser->p = p + 1;
+            return container == CZ_JSON_IN_OBJECT ? CZJSONObjectEnd : CZJSONArrayEnd;
+        } else {
+            return CZJSONError;
+        }
+    }
+
+    if (parser->state == CZ_JSON_DONE) {
+        parser->p = p;
+        return p == end ? CZJSONEnd : CZJSONError;
+    }
+
+    if (p >= end) {
+        return CZJSONError;
+    }
+
+    // 2. 对象的 key
+    if (parser->state == CZ_JSON_KEY || parser->state == CZ_JSON_FIRST_KEY) {
+        if (*p == '}' && parser->state == CZ_JSON_FIRST_KEY) {
+            parser->depth--;
+            parser->state = cz_json_after_value(parser);
+            parser->p = p + 1;
+            return CZJSONObjectEnd;
+        }
+        if (*p != '"') {
+            return CZJSONError;
+        }
+
+        int escaped = 0;
+        const char *close = cz_json_scan_string(p + 1, end, &escaped);
+        if (close == NULL) {
+            return CZJSONError;
+        }
+        parser->str = p + 1;
+        parser->str_len = (size_t)(close - p - 1);
+        parser->str_escaped = escaped;
+
+        // key 之后必须是 ':'
+        p = cz_json_skip_space(close + 1, end);
+        if (p >= end || *p != ':') {
+            return CZJSONError;
+        }
+        parser->state = CZ_JSON_VALUE;
+        parser->p = p + 1;
+        return CZJSONKey;
+    }
+
+    // 3. 值
+    if (parser->state == CZ_JSON_FIRST_VALUE && *p == ']') {
+        parser->depth--;
+        parser->state = cz_json_after_value(parser);
+        parser->p = p + 1;
+        return CZJSONArrayEnd;
+    }
+
+    CZJSONToken token;
+
+    switch (*p) {
+        case '{':
+        case '[':
+            if (parser->depth >= CZ_JSON_MAX_DEPTH) {
+                return CZJSONError;
+            }
+            if (*p == '{') {
+                parser->stack[parser->depth++] = CZ_JSON_IN_OBJECT;
+                parser->state = CZ_JSON_FIRST_KEY;
+                token = CZJSONObjectBegin;
+            } else {
+                parser->stack[parser->depth++] = CZ_JSON_IN_ARRAY;
+                parser->state = CZ_JSON_FIRST_VALUE;
+                token = CZJSONArrayBegin;
+            }
+            parser->p = p + 1;
+            return token;
+
+        case '"': {
+            int escaped = 0;
+            const char *close = cz_json_scan_string(p + 1, end, &escaped);
+            if (close == NULL) {
+                return CZJSONError;
+            }
+            parser->str = p + 1;
+            parser->str_len = (size_t)(close - p - 1);
+            parser->str_escaped = escaped;
+            p = close + 1;
+            token = CZJSONString;
+            break;
+        }
+
+        case 't':
+            if (!cz_json_literal(p, end, "true", 4)) {
+                return CZJSONError;
+            }
+            p += 4;
+            token = CZJSONTrue;
+            break;
+
+        case 'f':
+            if (!cz_json_literal(p, end, "false", 5)) {
+                return CZJSONError;
+            }
+            p += 5;
+            token = CZJSONFalse;
+            break;
+
+        case 'n':
+            if (!cz_json_literal(p, end, "null", 4)) {
+                return CZJSONError;
+            }
+            p += 4;
+            token = CZJSONNull;
+            break;
+
+        default:
+            p = cz_json_scan_number(parser, p, end, &token);
+            if (p == NULL) {
+                return CZJSONError;
+            }
+            break;
+    }
+
+    parser->state = cz_json_after_value(parser);
+    parser->p = p;
+    return token;
+}
+
+int cz_json_skip(cz_json_parser *parser, CZJSONToken token) {
+    if (token == CZJSONError || token == CZJSONObjectEnd || token == CZJSONArrayEnd || token == CZJSONEnd) {
+        return -1;
+    }
+    if (token != CZJSONObjectBegin && token != CZJSONArrayBegin) {
+        return 0;
+    }
+
+    int depth = parser->depth - 1;
+
+    while (parser->depth > depth) {
+        if (cz_json_next(parser) == CZJSONError) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+#pragma mark - 原子
+
+cz_atom cz_json_key_atom(const cz_json_parser *parser) {
+    if (!parser->str_escaped) {
+        return cz_atom_lookup(parser->str, parser->str_len);
+    }
+
+    // 转义后不会变长
+    char buffer[128];
+    char *out = parser->str_len <= sizeof(buffer) ? buffer : malloc(parser->str_len);
+    if (out == NULL) {
+        return CZ_ATOM_NONE;
+    }
+
+    size_t len = cz_json_unescape(parser->str, parser->str_len, out);
+    cz_atom atom = len != (size_t)-1 ? cz_atom_lookup(out, len) : CZ_ATOM_NONE;
+
+    if (out != buffer) {
+        free(out);
+    }
+    return atom;
+}
+
+#pragma mark - 转义
+
+static int cz_json_hex4(const char *p, uint32_t *out) {
+    uint32_t v = 0;
+
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') {
+            v |= (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            v |= (uint32_t)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            v |= (uint32_t)(c - 'A' + 10);
+        } else {
+            return -1;
+        }
+    }
+    *out = v;
+    return 0;
+}
+
+size_t cz_json_unescape(const char *str, size_t len, char *out) {
+    const char *p = str;
+    const char *end = str + len;
+    char *o = out;
+
+    while (p < end) {
+        const char *slash = memchr(p, '\\', (size_t)(end - p));
+        size_t plain = slash != NULL ? (size_t)(slash - p) : (size_t)(end - p);
+
+        memmove(o, p, plain);
+        o += plain;
+        p += plain;
+        if (slash == NULL) {
+            break;
+        }
+
+        if (p + 1 >= end) {
+            return (size_t)-1;
+        }
+        char c = p[1];
+        p += 2;
+
+        switch (c) {
+            case '"':  *o++ = '"';  break;
+            case '\\': *o++ = '\\'; break;
+            case '/':  *o++ = '/';  break;
+            case 'b':  *o++ = '\b'; break;
+            case 'f':  *o++ = '\f'; break;
+            case 'n':  *o++ = '\n'; break;
+            case 'r':  *o++ = '\r'; break;
+            case 't':  *o++ = '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (end - p < 4 || cz_json_hex4(p, &cp) != 0) {
+                    return (size_t)-1;
+                }
+                p += 4;
+
+                // 代理对
+                if (cp >= 0xd800 && cp <= 0xdbff) {
+                    uint32_t low;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || cz_json_hex4(p + 2, &low) != 0 ||
+                        low < 0xdc00 || low > 0xdfff) {
+                        return (size_t)-1;
+                    }
+                    p += 6;
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                } else if (cp >= 0xdc00 && cp <= 0xdfff) {
+                    return (size_t)-1;
+                }
+
+                // \uXXXX 占 6 字节，UTF8 最多 3 字节；代理对 12 字节 -> 4 字节，不会超过输入长度
+                if (cp < 0x80) {
+                    *o++ = (char)cp;
+                } else if (cp < 0x800) {
+                    *o++ = (char)(0xc0 | (cp >> 6));
+                    *o++ = (char)(0x80 | (cp & 0x3f));
+                } else if (cp < 0x10000) {
+                    *o++ = (char)(0xe0 | (cp >> 12));
+                    *o++ = (char)(0x80 | ((cp >> 6) & 0x3f));
+                    *o++ = (char)(0x80 | (cp & 0x3f));
+                } else {
+                    *o++ = (char)(0xf0 | (cp >> 18));
+                    *o++ = (char)(0x80 | ((cp >> 12) & 0x3f));
+                    *o++ = (char)(0x80 | ((cp >> 6) & 0x3f));
+                    *o++ = (char)(0x80 | (cp & 0x3f));
+                }
+                break;
+            }
+            default:
+                return (size_t)-1;
+        }
+    }
+
+    return (size_t)(o - out);
+}
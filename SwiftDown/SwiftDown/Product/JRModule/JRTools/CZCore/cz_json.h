@@ -0,0 +1,88 @@
+//
+//  cz_json.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/24.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_json_h
+#define cz_json_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cz_atom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// JSON 拉取式解析器
+///
+/// 直接扫描响应数据，逐个返回 token，不构建中间的字典 / 数组；
+/// 字符串以指针 + 长度返回，不复制，只有包含转义时才需要 cz_json_unescape
+
+/// 最大嵌套层数
+#define CZ_JSON_MAX_DEPTH   64
+
+typedef enum {
+    CZJSONError = -1,
+    CZJSONEnd = 0,          // 数据结束
+    CZJSONObjectBegin,
+    CZJSONObjectEnd,
+    CZJSONArrayBegin,
+    CZJSONArrayEnd,
+    CZJSONKey,              // 对象的 key，内容在 str / str_len
+    CZJSONString,
+    CZJSONInteger,          // 在 int64 范围内的整数，值在 integer
+    CZJSONDouble,           // 其他数字，值在 number；integer 为向零取整并限制在 int64 范围内的值
+    CZJSONTrue,
+    CZJSONFalse,
+    CZJSONNull,
+} CZJSONToken;
+
+typedef struct {
+    const char *p;
+    const char *end;
+    int         depth;
+    int         state;
+    uint8_t     stack[CZ_JSON_MAX_DEPTH];
+
+    /// 当前 token 的值
+    const char *str;            // 不含引号
+    size_t      str_len;
+    int         str_escaped;    // 是否包含 '\'
+    int64_t     integer;
+    double      number;
+} cz_json_parser;
+
+void cz_json_init(cz_json_parser *parser, const void *data, size_t len);
+
+/// 读取下一个 token，语法错误返回 CZJSONError
+CZJSONToken cz_json_next(cz_json_parser *parser);
+
+/// 跳过以 token 开始的整个值，token 为容器开始时跳到对应的结束
+///
+/// @return 0 成功，-1 语法错误
+int cz_json_skip(cz_json_parser *parser, CZJSONToken token);
+
+/// 当前读取位置，配合 cz_json_skip 取出一个值的原始数据
+const char *cz_json_position(const cz_json_parser *parser);
+
+/// 当前 key 在原子表中的 ID，只在 cz_json_next 返回 CZJSONKey 之后调用
+///
+/// 直接按 key 的原始字节查找，包含转义时先解码；没有登记过的 key 返回 CZ_ATOM_NONE
+cz_atom cz_json_key_atom(const cz_json_parser *parser);
+
+/// 解码字符串中的转义 (含 \uXXXX 和代理对) 为 UTF8
+///
+/// @param out 至少 len 字节
+///
+/// @return 写入的字节数，转义不合法返回 (size_t)-1
+size_t cz_json_unescape(const char *str, size_t len, char *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_json_h */
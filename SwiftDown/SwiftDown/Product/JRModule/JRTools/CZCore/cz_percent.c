@@ -0,0 +1,197 @@
+//
+//  cz_percent.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/29.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_percent.h"
+
+#include <string.h>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define CZ_PERCENT_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#define CZ_PERCENT_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#pragma mark - 分类表
+
+/// 不需要编码的字符：字母、数字和 !$&'()*+,-./:;=?@_~
+static const uint8_t cz_percent_table[256] = {
+    ['!'] = 1, ['$'] = 1, ['&'] = 1, ['\''] = 1, ['('] = 1, [')'] = 1, ['*'] = 1, ['+'] = 1,
+    [','] = 1, ['-'] = 1, ['.'] = 1, ['/'] = 1, [':'] = 1, [';'] = 1, ['='] = 1, ['?'] = 1,
+    ['@'] = 1, ['_'] = 1, ['~'] = 1,
+    ['0'] = 1, ['1'] = 1, ['2'] = 1, ['3'] = 1, ['4'] = 1, ['5'] = 1, ['6'] = 1, ['7'] = 1,
+    ['8'] = 1, ['9'] = 1,
+    ['A'] = 1, ['B'] = 1, ['C'] = 1, ['D'] = 1, ['E'] = 1, ['F'] = 1, ['G'] = 1, ['H'] = 1,
+    ['I'] = 1, ['J'] = 1, ['K'] = 1, ['L'] = 1, ['M'] = 1, ['N'] = 1, ['O'] = 1, ['P'] = 1,
+    ['Q'] = 1, ['R'] = 1, ['S'] = 1, ['T'] = 1, ['U'] = 1, ['V'] = 1, ['W'] = 1, ['X'] = 1,
+    ['Y'] = 1, ['Z'] = 1,
+    ['a'] = 1, ['b'] = 1, ['c'] = 1, ['d'] = 1, ['e'] = 1, ['f'] = 1, ['g'] = 1, ['h'] = 1,
+    ['i'] = 1, ['j'] = 1, ['k'] = 1, ['l'] = 1, ['m'] = 1, ['n'] = 1, ['o'] = 1, ['p'] = 1,
+    ['q'] = 1, ['r'] = 1, ['s'] = 1, ['t'] = 1, ['u'] = 1, ['v'] = 1, ['w'] = 1, ['x'] = 1,
+    ['y'] = 1, ['z'] = 1,
+};
+
+int cz_percent_allowed(uint8_t c) {
+    return cz_percent_table[c];
+}
+
+#if CZ_PERCENT_NEON || CZ_PERCENT_SSSE3
+
+/// 按高低 4 位查表：字符 c 不需要编码当且仅当 lo[c & 15] & hi[c >> 4] 不为 0
+///
+/// 高 4 位为 2 ~ 7 时分别对应第 0 ~ 5 位，其余为 0
+static const uint8_t cz_percent_hi_nibble[16] = {
+    0, 0, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+/// 由 cz_percent_table 生成：第 h - 2 位表示字符 (h << 4 | lo) 不需要编码
+static const uint8_t cz_percent_lo_nibble[16] = {
+    //  0     1     2     3     4     5     6     7     8     9     a     b     c     d     e     f
+    0x2e, 0x3f, 0x3e, 0x3e, 0x3f, 0x3e, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x17, 0x15, 0x17, 0x35, 0x1f,
+};
+
+#endif
+
+#if CZ_PERCENT_NEON
+
+/// 从 bytes 开始、不需要编码的连续 16 字节组的总长度
+static size_t cz_percent_span(const uint8_t *bytes, size_t len) {
+    const uint8x16_t lo = vld1q_u8(cz_percent_lo_nibble);
+    const uint8x16_t hi = vld1q_u8(cz_percent_hi_nibble);
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t in = vld1q_u8(bytes + i);
+        uint8x16_t cls = vandq_u8(vqtbl1q_u8(lo, vandq_u8(in, vdupq_n_u8(0x0f))),
+                                  vqtbl1q_u8(hi, vshrq_n_u8(in, 4)));
+
+        // 有任何一个字节分类为 0 就停止
+        if (vminvq_u8(vtstq_u8(cls, cls)) == 0) {
+            break;
+        }
+    }
+    return i;
+}
+
+#elif CZ_PERCENT_SSSE3
+
+static size_t cz_percent_span(const uint8_t *bytes, size_t len) {
+    const __m128i lo = _mm_loadu_si128((const __m128i *)cz_percent_lo_nibble);
+    const __m128i hi = _mm_loadu_si128((const __m128i *)cz_percent_hi_nibble);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(bytes + i));
+        // 最高位为 1 的字节 pshufb 结果为 0，正好是需要编码的非 ASCII 字节
+        __m128i cls = _mm_and_si128(_mm_shuffle_epi8(lo, _mm_and_si128(in, nibble)),
+                                    _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(cls, _mm_setzero_si128())) != 0) {
+            break;
+        }
+    }
+    return i;
+}
+
+#else
+
+/// 没有向量指令时每次检查 8 字节
+static size_t cz_percent_span(const uint8_t *bytes, size_t len) {
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        const uint8_t *p = bytes + i;
+        if (!(cz_percent_table[p[0]] & cz_percent_table[p[1]] & cz_percent_table[p[2]] & cz_percent_table[p[3]] &
+              cz_percent_table[p[4]] & cz_percent_table[p[5]] & cz_percent_table[p[6]] & cz_percent_table[p[7]])) {
+            break;
+        }
+    }
+    return i;
+}
+
+#endif
+
+#pragma mark - 编码
+
+size_t cz_percent_encode(const uint8_t *bytes, size_t len, char *out) {
+    static const char hex[16] = "0123456789ABCDEF";
+    char *o = out;
+    size_t i = 0;
+
+    while (i < len) {
+        // 1. 整组复制
+        size_t span = cz_percent_span(bytes + i, len - i);
+        memcpy(o, bytes + i, span);
+        o += span;
+        i += span;
+
+        // 2. 逐字节处理到下一组的开始
+        size_t end = i + 16 < len ? i + 16 : len;
+
+        for (; i < end; i++) {
+            uint8_t c = bytes[i];
+
+            if (cz_percent_table[c]) {
+                *o++ = (char)c;
+            } else {
+                o[0] = '%';
+                o[1] = hex[c >> 4];
+                o[2] = hex[c & 15];
+                o += 3;
+            }
+        }
+    }
+    return (size_t)(o - out);
+}
+
+#pragma mark - 解码
+
+static inline int cz_percent_hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+size_t cz_percent_decode(const char *str, size_t len, uint8_t *out) {
+    const char *p = str;
+    const char *end = str + len;
+    uint8_t *o = out;
+
+    while (p < end) {
+        // memchr 本身按向量查找，'%' 之间的部分整段复制
+        const char *percent = memchr(p, '%', (size_t)(end - p));
+        size_t plain = percent != NULL ? (size_t)(percent - p) : (size_t)(end - p);
+
+        memmove(o, p, plain);
+        o += plain;
+        p += plain;
+
+        if (percent == NULL) {
+            break;
+        }
+        if (end - p < 3) {
+            return (size_t)-1;
+        }
+
+        int h = cz_percent_hex_value(p[1]);
+        int l = cz_percent_hex_value(p[2]);
+        if (h < 0 || l < 0) {
+            return (size_t)-1;
+        }
+        *o++ = (uint8_t)(h << 4 | l);
+        p += 3;
+    }
+    return (size_t)(o - out);
+}
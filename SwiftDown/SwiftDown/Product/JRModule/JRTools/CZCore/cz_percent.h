@@ -0,0 +1,45 @@
+//
+//  cz_percent.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/29.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_percent_h
+#define cz_percent_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 百分号编码后的最大长度
+#define CZ_PERCENT_ENCODED_MAX_LENGTH(len)  ((len) * 3)
+
+/// 百分号编码，保留字符与 NSCharacterSet.URLQueryAllowedCharacterSet 相同
+///
+/// 按 16 字节一组分类，整组都不需要编码时直接复制；其余字节编码为 %XX (大写)
+///
+/// @param out 至少 CZ_PERCENT_ENCODED_MAX_LENGTH(len) 字节，不追加 '\0'
+///
+/// @return 写入的字符数
+size_t cz_percent_encode(const uint8_t *bytes, size_t len, char *out);
+
+/// 百分号解码，与 -[NSString stringByRemovingPercentEncoding] 相同，'+' 不转换为空格
+///
+/// @param out 至少 len 字节，可以与 str 相同 (原地解码)
+///
+/// @return 写入的字节数，'%' 之后不是两位十六进制时返回 (size_t)-1
+size_t cz_percent_decode(const char *str, size_t len, uint8_t *out);
+
+/// 字节是否不需要编码
+int cz_percent_allowed(uint8_t c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_percent_h */
@@ -0,0 +1,112 @@
+//
+//  cz_registry.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/25.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_registry.h"
+
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// 一个槽位，key 为 NULL 表示空
+///
+/// key 只会从 NULL 变为非 NULL 一次，value 在 key 之后写入
+typedef struct {
+    const void *key;
+    const void *value;
+} cz_registry_slot;
+
+struct cz_registry {
+    size_t           mask;
+    size_t           count;
+    cz_registry_slot slots[];
+};
+
+cz_registry *cz_registry_create(size_t capacity) {
+    size_t size = 16;
+
+    // 装载率不超过 1 / 2，探测长度保持很短
+    while (size < capacity * 2) {
+        size <<= 1;
+    }
+
+    cz_registry *registry = calloc(1, sizeof(cz_registry) + size * sizeof(cz_registry_slot));
+    if (registry != NULL) {
+        registry->mask = size - 1;
+    }
+    return registry;
+}
+
+/// 对象指针的低位总是 0，乘法散列让高位参与
+static inline size_t cz_registry_hash(const void *key) {
+    uint64_t h = (uint64_t)(uintptr_t)key * 0x9e3779b97f4a7c15ull;
+    return (size_t)(h >> 32 ^ h);
+}
+
+/// 等待抢到槽位的线程写入 value
+static const void *cz_registry_wait_value(cz_registry_slot *slot) {
+    const void *value;
+
+    while ((value = __atomic_load_n(&slot->value, __ATOMIC_ACQUIRE)) == NULL) {
+        sched_yield();
+    }
+    return value;
+}
+
+const void *cz_registry_get(cz_registry *registry, const void *key) {
+    size_t i = cz_registry_hash(key) & registry->mask;
+
+    for (size_t n = 0; n <= registry->mask; n++) {
+        cz_registry_slot *slot = &registry->slots[i];
+        const void *k = __atomic_load_n(&slot->key, __ATOMIC_ACQUIRE);
+
+        if (k == key) {
+            return __atomic_load_n(&slot->value, __ATOMIC_ACQUIRE);
+        }
+        if (k == NULL) {
+            return NULL;
+        }
+        i = (i + 1) & registry->mask;
+    }
+    return NULL;
+}
+
+const void *cz_registry_publish(cz_registry *registry, const void *key, const void *value) {
+    size_t i = cz_registry_hash(key) & registry->mask;
+
+    for (size_t n = 0; n <= registry->mask; n++) {
+        cz_registry_slot *slot = &registry->slots[i];
+        const void *k = __atomic_load_n(&slot->key, __ATOMIC_ACQUIRE);
+
+        if (k == NULL) {
+            // 已经达到容量时不再占用新的槽位，保持装载率
+            size_t count = __atomic_load_n(&registry->count, __ATOMIC_RELAXED);
+            if (count * 2 >= registry->mask + 1) {
+                return NULL;
+            }
+
+            const void *expected = NULL;
+            if (__atomic_compare_exchange_n(&slot->key, &expected, key, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                __atomic_store_n(&slot->value, value, __ATOMIC_RELEASE);
+                __atomic_fetch_add(&registry->count, 1, __ATOMIC_RELAXED);
+                return value;
+            }
+            // 被其他线程抢先，检查抢到的是不是同一个 key
+            k = expected;
+        }
+
+        if (k == key) {
+            return cz_registry_wait_value(slot);
+        }
+        i = (i + 1) & registry->mask;
+    }
+    return NULL;
+}
+
+size_t cz_registry_count(cz_registry *registry) {
+    return __atomic_load_n(&registry->count, __ATOMIC_RELAXED);
+}
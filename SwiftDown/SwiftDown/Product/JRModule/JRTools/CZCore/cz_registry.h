@@ -0,0 +1,67 @@
+//
+//  cz_registry.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/25.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_registry_h
+#define cz_registry_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 以指针为 key 的全局注册表，每个 key 只发布一次
+///
+/// 开放寻址，读取不加锁、不写共享内存；插入使用 CAS 抢占槽位，
+/// 同一个 key 同时发布时只有第一个值生效，其余调用方得到这个值。
+/// 条目不会删除，适合按 Class 缓存的元数据这类只增不减、读多写少的数据
+typedef struct cz_registry cz_registry;
+
+/// 创建注册表
+///
+/// @param capacity 至少可以保存的条目数
+cz_registry *cz_registry_create(size_t capacity);
+
+/// 查找 key 已发布的值，不存在 (或正在发布) 时返回 NULL
+const void *cz_registry_get(cz_registry *registry, const void *key);
+
+/// 发布 key 的值
+///
+/// @param value 不能为 NULL
+///
+/// @return 注册表中最终的值：发布成功时为 value，key 已经存在时为先发布的值；
+///         注册表已满时不保存，返回 NULL
+const void *cz_registry_publish(cz_registry *registry, const void *key, const void *value);
+
+/// 已发布的条目数
+size_t cz_registry_count(cz_registry *registry);
+
+#ifdef __OBJC__
+
+#include <CoreFoundation/CoreFoundation.h>
+
+/// 发布 ObjC 对象，注册表持有发布成功的对象
+///
+/// @return 注册表中最终的对象；注册表已满时返回 object 本身 (不缓存)
+static inline id cz_registry_publish_object(cz_registry *registry, const void *key, id object) {
+    const void *value = (__bridge_retained const void *)object;
+    const void *stored = cz_registry_publish(registry, key, value);
+
+    if (stored != value) {
+        CFRelease(value);
+    }
+    return stored != NULL ? (__bridge id)stored : object;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_registry_h */
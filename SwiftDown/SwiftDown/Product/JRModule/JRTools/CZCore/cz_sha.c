@@ -0,0 +1,574 @@
+//
+//  cz_sha.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/11.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_sha.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define CZ_SHA_ARMV8 1
+#include <arm_neon.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || defined(__GNUC__))
+#define CZ_SHA_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#define CZ_SHANI_TARGET __attribute__((target("sha,sse4.1")))
+#endif
+
+#pragma mark - 常量
+
+static const uint32_t cz_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t cz_sha1_k[4] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+#define CZ_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define CZ_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static inline uint32_t cz_load_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void cz_store_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+#pragma mark - 标量实现
+
+void cz_sha256_blocks_ref(uint32_t h[8], const uint8_t *data, size_t nblocks) {
+    uint32_t w[64];
+
+    while (nblocks--) {
+        for (int i = 0; i < 16; i++) {
+            w[i] = cz_load_be32(data + 4 * i);
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = CZ_ROTR(w[i - 15], 7) ^ CZ_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = CZ_ROTR(w[i - 2], 17) ^ CZ_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+        uint32_t e = h[4], f = h[5], g = h[6], hh = h[7];
+
+        for (int i = 0; i < 64; i++) {
+            uint32_t S1 = CZ_ROTR(e, 6) ^ CZ_ROTR(e, 11) ^ CZ_ROTR(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = hh + S1 + ch + cz_sha256_k[i] + w[i];
+            uint32_t S0 = CZ_ROTR(a, 2) ^ CZ_ROTR(a, 13) ^ CZ_ROTR(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = S0 + maj;
+
+            hh = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+
+        data += CZ_SHA_BLOCK_LENGTH;
+    }
+}
+
+void cz_sha1_blocks_ref(uint32_t h[5], const uint8_t *data, size_t nblocks) {
+    uint32_t w[80];
+
+    while (nblocks--) {
+        for (int i = 0; i < 16; i++) {
+            w[i] = cz_load_be32(data + 4 * i);
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = CZ_ROTL(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+
+        for (int i = 0; i < 80; i++) {
+            uint32_t f;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+            } else if (i < 40 || i >= 60) {
+                f = b ^ c ^ d;
+            } else {
+                f = (b & c) | (b & d) | (c & d);
+            }
+            uint32_t t = CZ_ROTL(a, 5) + f + e + cz_sha1_k[i / 20] + w[i];
+
+            e = d; d = c; c = CZ_ROTL(b, 30); b = a; a = t;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+
+        data += CZ_SHA_BLOCK_LENGTH;
+    }
+}
+
+#pragma mark - ARMv8 SHA 指令
+
+#if CZ_SHA_ARMV8
+
+static void cz_sha256_blocks_armv8(uint32_t h[8], const uint8_t *data, size_t nblocks) {
+    uint32x4_t state0 = vld1q_u32(&h[0]);
+    uint32x4_t state1 = vld1q_u32(&h[4]);
+
+    while (nblocks--) {
+        uint32x4_t save0 = state0, save1 = state1;
+        uint32x4_t m[4];
+
+        for (int i = 0; i < 4; i++) {
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+        }
+
+        for (int i = 0; i < 16; i++) {
+            if (i >= 4) {
+                // W[t] 由前 16 个字计算，m 作为 4 组的环形缓冲
+                m[i & 3] = vsha256su1q_u32(vsha256su0q_u32(m[i & 3], m[(i + 1) & 3]),
+                                           m[(i + 2) & 3], m[(i + 3) & 3]);
+            }
+            uint32x4_t wk = vaddq_u32(m[i & 3], vld1q_u32(&cz_sha256_k[4 * i]));
+            uint32x4_t tmp = state0;
+            state0 = vsha256hq_u32(state0, state1, wk);
+            state1 = vsha256h2q_u32(state1, tmp, wk);
+        }
+
+        state0 = vaddq_u32(state0, save0);
+        state1 = vaddq_u32(state1, save1);
+
+        data += CZ_SHA_BLOCK_LENGTH;
+    }
+
+    vst1q_u32(&h[0], state0);
+    vst1q_u32(&h[4], state1);
+}
+
+static void cz_sha1_blocks_armv8(uint32_t h[5], const uint8_t *data, size_t nblocks) {
+    uint32x4_t abcd = vld1q_u32(&h[0]);
+    uint32_t e0 = h[4];
+
+    while (nblocks--) {
+        uint32x4_t save_abcd = abcd;
+        uint32_t save_e = e0;
+        uint32x4_t m[4];
+
+        for (int i = 0; i < 4; i++) {
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+        }
+
+        uint32_t e = e0;
+
+        for (int i = 0; i < 20; i++) {
+            if (i >= 4) {
+                m[i & 3] = vsha1su1q_u32(vsha1su0q_u32(m[i & 3], m[(i + 1) & 3], m[(i + 2) & 3]),
+                                         m[(i + 3) & 3]);
+            }
+            uint32x4_t wk = vaddq_u32(m[i & 3], vdupq_n_u32(cz_sha1_k[i / 5]));
+            uint32_t next_e = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+            if (i < 5) {
+                abcd = vsha1cq_u32(abcd, e, wk);
+            } else if (i < 10 || i >= 15) {
+                abcd = vsha1pq_u32(abcd, e, wk);
+            } else {
+                abcd = vsha1mq_u32(abcd, e, wk);
+            }
+            e = next_e;
+        }
+
+        abcd = vaddq_u32(abcd, save_abcd);
+        e0 = e + save_e;
+
+        data += CZ_SHA_BLOCK_LENGTH;
+    }
+
+    vst1q_u32(&h[0], abcd);
+    h[4] = e0;
+}
+
+#endif
+
+#pragma mark - x86 SHA-NI
+
+#if CZ_SHA_SHANI
+
+CZ_SHANI_TARGET
+static void cz_sha256_blocks_shani(uint32_t h[8], const uint8_t *data, size_t nblocks) {
+    const __m128i shuf = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // 指令要求的状态排列是 ABEF / CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&h[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&h[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    while (nblocks--) {
+        __m128i save0 = state0, save1 = state1;
+        __m128i m[4];
+
+        for (int i = 0; i < 4; i++) {
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * i)), shuf);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            if (i >= 4) {
+                __m128i t = _mm_add_epi32(_mm_sha256msg1_epu32(m[i & 3], m[(i + 1) & 3]),
+                                          _mm_alignr_epi8(m[(i + 3) & 3], m[(i + 2) & 3], 4));
+                m[i & 3] = _mm_sha256msg2_epu32(t, m[(i + 3) & 3]);
+            }
+            __m128i wk = _mm_add_epi32(m[i & 3], _mm_loadu_si128((const __m128i *)&cz_sha256_k[4 * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+        }
+
+        state0 = _mm_add_epi32(state0, save0);
+        state1 = _mm_add_epi32(state1, save1);
+
+        data += CZ_SHA_BLOCK_LENGTH;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i *)&h[0], _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i *)&h[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+// sha1rnds4 的轮函数选择必须是立即数，只能展开
+#define CZ_SHA1_SHANI_ROUNDS(i, func)                                                   \
+    do {                                                                                \
+        if ((i) >= 4) {                                                                 \
+            m[(i) & 3] = _mm_sha1msg2_epu32(                                            \
+                _mm_xor_si128(_mm_sha1msg1_epu32(m[(i) & 3], m[((i) + 1) & 3]),         \
+                              m[((i) + 2) & 3]),                                        \
+                m[((i) + 3) & 3]);                                                      \
+        }                                                                               \
+        e = ((i) == 0) ? _mm_add_epi32(e, m[0]) : _mm_sha1nexte_epu32(e, m[(i) & 3]);   \
+        __m128i next_e = abcd;                                                          \
+        abcd = _mm_sha1rnds4_epu32(abcd, e, func);                                      \
+        e = next_e;                                                                     \
+    } while (0)
+
+CZ_SHANI_TARGET
+static void cz_sha1_blocks_shani(uint32_t h[5], const uint8_t *data, size_t nblocks) {
+    const __m128i shuf = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)h), 0x1B);
+    __m128i e0 = _mm_set_epi32((int)h[4], 0, 0, 0);
+
+    while (nblocks--) {
+        __m128i save_abcd = abcd, save_e = e0;
+        __m128i m[4];
+
+        for (int i = 0; i < 4; i++) {
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * i)), shuf);
+        }
+
+        __m128i e = e0;
+
+        CZ_SHA1_SHANI_ROUNDS(0, 0);  CZ_SHA1_SHANI_ROUNDS(1, 0);  CZ_SHA1_SHANI_ROUNDS(2, 0);
+        CZ_SHA1_SHANI_ROUNDS(3, 0);  CZ_SHA1_SHANI_ROUNDS(4, 0);  CZ_SHA1_SHANI_ROUNDS(5, 1);
+        CZ_SHA1_SHANI_ROUNDS(6, 1);  CZ_SHA1_SHANI_ROUNDS(7, 1);  CZ_SHA1_SHANI_ROUNDS(8, 1);
+        CZ_SHA1_SHANI_ROUNDS(9, 1);  CZ_SHA1_SHANI_ROUNDS(10, 2); CZ_SHA1_SHANI_ROUNDS(11, 2);
+        CZ_SHA1_SHANI_ROUNDS(12, 2); CZ_SHA1_SHANI_ROUNDS(13, 2); CZ_SHA1_SHANI_ROUNDS(14, 2);
+        CZ_SHA1_SHANI_ROUNDS(15, 3); CZ_SHA1_SHANI_ROUNDS(16, 3); CZ_SHA1_SHANI_ROUNDS(17, 3);
+        CZ_SHA1_SHANI_ROUNDS(18, 3); CZ_SHA1_SHANI_ROUNDS(19, 3);
+
+        e0 = _mm_sha1nexte_epu32(e, save_e);
+        abcd = _mm_add_epi32(abcd, save_abcd);
+
+        data += CZ_SHA_BLOCK_LENGTH;
+    }
+
+    _mm_storeu_si128((__m128i *)h, _mm_shuffle_epi32(abcd, 0x1B));
+    h[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+static int cz_cpu_has_shani(void) {
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    // SSSE3 + SSE4.1
+    if (!(ecx & (1u << 9)) || !(ecx & (1u << 19))) {
+        return 0;
+    }
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return 0;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    return (ebx & (1u << 29)) != 0;
+}
+
+#endif
+
+#pragma mark - 运行时选择
+
+static const char *cz_sha_kernel_names[CZSHAKernelCount] = { "auto", "scalar", "shani", "armv8" };
+
+static cz_sha1_blocks_fn cz_sha1_selected = cz_sha1_blocks_ref;
+static cz_sha256_blocks_fn cz_sha256_selected = cz_sha256_blocks_ref;
+static const char *cz_sha_selected_name = "scalar";
+static pthread_once_t cz_sha_once = PTHREAD_ONCE_INIT;
+
+/// 按 CPU 选择的实现
+static CZSHAKernel cz_sha_auto_kernel(void) {
+#if CZ_SHA_ARMV8
+    return CZSHAKernelARMv8;
+#elif CZ_SHA_SHANI
+    if (cz_cpu_has_shani()) {
+        return CZSHAKernelSHANI;
+    }
+    return CZSHAKernelScalar;
+#else
+    return CZSHAKernelScalar;
+#endif
+}
+
+int cz_sha_kernel_available(CZSHAKernel kernel) {
+    switch (kernel) {
+        case CZSHAKernelAuto:
+        case CZSHAKernelScalar:
+            return 1;
+#if CZ_SHA_SHANI
+        case CZSHAKernelSHANI:
+            return cz_cpu_has_shani();
+#endif
+#if CZ_SHA_ARMV8
+        case CZSHAKernelARMv8:
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+
+cz_sha1_blocks_fn cz_sha1_blocks_for(CZSHAKernel kernel) {
+    if (kernel == CZSHAKernelAuto) {
+        kernel = cz_sha_auto_kernel();
+    }
+    if (!cz_sha_kernel_available(kernel)) {
+        return NULL;
+    }
+
+    switch (kernel) {
+#if CZ_SHA_SHANI
+        case CZSHAKernelSHANI: return cz_sha1_blocks_shani;
+#endif
+#if CZ_SHA_ARMV8
+        case CZSHAKernelARMv8: return cz_sha1_blocks_armv8;
+#endif
+        default:               return cz_sha1_blocks_ref;
+    }
+}
+
+cz_sha256_blocks_fn cz_sha256_blocks_for(CZSHAKernel kernel) {
+    if (kernel == CZSHAKernelAuto) {
+        kernel = cz_sha_auto_kernel();
+    }
+    if (!cz_sha_kernel_available(kernel)) {
+        return NULL;
+    }
+
+    switch (kernel) {
+#if CZ_SHA_SHANI
+        case CZSHAKernelSHANI: return cz_sha256_blocks_shani;
+#endif
+#if CZ_SHA_ARMV8
+        case CZSHAKernelARMv8: return cz_sha256_blocks_armv8;
+#endif
+        default:               return cz_sha256_blocks_ref;
+    }
+}
+
+static void cz_sha_use(CZSHAKernel kernel) {
+    if (kernel == CZSHAKernelAuto) {
+        kernel = cz_sha_auto_kernel();
+    }
+    __atomic_store_n(&cz_sha1_selected, cz_sha1_blocks_for(kernel), __ATOMIC_RELEASE);
+    __atomic_store_n(&cz_sha256_selected, cz_sha256_blocks_for(kernel), __ATOMIC_RELEASE);
+    __atomic_store_n(&cz_sha_selected_name, cz_sha_kernel_names[kernel], __ATOMIC_RELEASE);
+}
+
+static void cz_sha_select(void) {
+    cz_sha_use(CZSHAKernelAuto);
+}
+
+cz_sha1_blocks_fn cz_sha1_blocks(void) {
+    pthread_once(&cz_sha_once, cz_sha_select);
+    return __atomic_load_n(&cz_sha1_selected, __ATOMIC_ACQUIRE);
+}
+
+cz_sha256_blocks_fn cz_sha256_blocks(void) {
+    pthread_once(&cz_sha_once, cz_sha_select);
+    return __atomic_load_n(&cz_sha256_selected, __ATOMIC_ACQUIRE);
+}
+
+const char *cz_sha_kernel_name(void) {
+    pthread_once(&cz_sha_once, cz_sha_select);
+    return __atomic_load_n(&cz_sha_selected_name, __ATOMIC_ACQUIRE);
+}
+
+int cz_sha_set_kernel(CZSHAKernel kernel) {
+    if ((unsigned)kernel >= CZSHAKernelCount || !cz_sha_kernel_available(kernel)) {
+        return -1;
+    }
+    pthread_once(&cz_sha_once, cz_sha_select);
+    cz_sha_use(kernel);
+
+    return 0;
+}
+
+#pragma mark - 增量接口
+
+/// 缓冲未满一个分组的输入，整块直接交给压缩函数
+#define CZ_SHA_UPDATE(ctx, data, len, blocks)                                   \
+    do {                                                                        \
+        const uint8_t *p = (data);                                              \
+        size_t n = (len);                                                       \
+        (ctx)->length += n;                                                     \
+        if ((ctx)->buffered > 0) {                                              \
+            size_t take = CZ_SHA_BLOCK_LENGTH - (ctx)->buffered;                \
+            if (take > n) {                                                     \
+                take = n;                                                       \
+            }                                                                   \
+            memcpy((ctx)->buffer + (ctx)->buffered, p, take);                   \
+            (ctx)->buffered += (uint32_t)take;                                  \
+            p += take;                                                          \
+            n -= take;                                                          \
+            if ((ctx)->buffered < CZ_SHA_BLOCK_LENGTH) {                        \
+                break;                                                          \
+            }                                                                   \
+            (blocks)((ctx)->h, (ctx)->buffer, 1);                               \
+            (ctx)->buffered = 0;                                                \
+        }                                                                       \
+        if (n >= CZ_SHA_BLOCK_LENGTH) {                                         \
+            (blocks)((ctx)->h, p, n / CZ_SHA_BLOCK_LENGTH);                     \
+            p += n & ~(size_t)(CZ_SHA_BLOCK_LENGTH - 1);                        \
+            n &= CZ_SHA_BLOCK_LENGTH - 1;                                       \
+        }                                                                       \
+        memcpy((ctx)->buffer, p, n);                                            \
+        (ctx)->buffered = (uint32_t)n;                                          \
+    } while (0)
+
+/// 补 0x80、补零、追加 64 位长度
+#define CZ_SHA_PAD(ctx, blocks)                                                 \
+    do {                                                                        \
+        uint64_t bits = (ctx)->length << 3;                                     \
+        (ctx)->buffer[(ctx)->buffered++] = 0x80;                                \
+        if ((ctx)->buffered > CZ_SHA_BLOCK_LENGTH - 8) {                        \
+            memset((ctx)->buffer + (ctx)->buffered, 0,                          \
+                   CZ_SHA_BLOCK_LENGTH - (ctx)->buffered);                      \
+            (blocks)((ctx)->h, (ctx)->buffer, 1);                               \
+            (ctx)->buffered = 0;                                                \
+        }                                                                       \
+        memset((ctx)->buffer + (ctx)->buffered, 0,                              \
+               CZ_SHA_BLOCK_LENGTH - 8 - (ctx)->buffered);                      \
+        cz_store_be32((ctx)->buffer + 56, (uint32_t)(bits >> 32));              \
+        cz_store_be32((ctx)->buffer + 60, (uint32_t)bits);                      \
+        (blocks)((ctx)->h, (ctx)->buffer, 1);                                   \
+        (ctx)->buffered = 0;                                                    \
+    } while (0)
+
+void cz_sha1_init(cz_sha1_ctx *ctx) {
+    static const uint32_t iv[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+    memcpy(ctx->h, iv, sizeof(iv));
+    ctx->length = 0;
+    ctx->buffered = 0;
+}
+
+void cz_sha1_update(cz_sha1_ctx *ctx, const void *data, size_t len) {
+    cz_sha1_blocks_fn blocks = cz_sha1_blocks();
+
+    CZ_SHA_UPDATE(ctx, data, len, blocks);
+}
+
+void cz_sha1_final(cz_sha1_ctx *ctx, uint8_t out[CZ_SHA1_DIGEST_LENGTH]) {
+    cz_sha1_blocks_fn blocks = cz_sha1_blocks();
+
+    CZ_SHA_PAD(ctx, blocks);
+
+    for (int i = 0; i < 5; i++) {
+        cz_store_be32(out + 4 * i, ctx->h[i]);
+    }
+}
+
+void cz_sha224_init(cz_sha256_ctx *ctx) {
+    static const uint32_t iv[8] = {
+        0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
+    };
+
+    memcpy(ctx->h, iv, sizeof(iv));
+    ctx->length = 0;
+    ctx->buffered = 0;
+    ctx->digest_length = CZ_SHA224_DIGEST_LENGTH;
+}
+
+void cz_sha256_init(cz_sha256_ctx *ctx) {
+    static const uint32_t iv[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    memcpy(ctx->h, iv, sizeof(iv));
+    ctx->length = 0;
+    ctx->buffered = 0;
+    ctx->digest_length = CZ_SHA256_DIGEST_LENGTH;
+}
+
+void cz_sha256_update(cz_sha256_ctx *ctx, const void *data, size_t len) {
+    cz_sha256_blocks_fn blocks = cz_sha256_blocks();
+
+    CZ_SHA_UPDATE(ctx, data, len, blocks);
+}
+
+void cz_sha256_final(cz_sha256_ctx *ctx, uint8_t *out) {
+    cz_sha256_blocks_fn blocks = cz_sha256_blocks();
+
+    CZ_SHA_PAD(ctx, blocks);
+
+    for (uint32_t i = 0; i < ctx->digest_length / 4; i++) {
+        cz_store_be32(out + 4 * i, ctx->h[i]);
+    }
+}
+
+#pragma mark - 一次性接口
+
+void cz_sha1(const void *data, size_t len, uint8_t out[CZ_SHA1_DIGEST_LENGTH]) {
+    cz_sha1_ctx ctx;
+    cz_sha1_init(&ctx);
+    cz_sha1_update(&ctx, data, len);
+    cz_sha1_final(&ctx, out);
+}
+
+void cz_sha224(const void *data, size_t len, uint8_t out[CZ_SHA224_DIGEST_LENGTH]) {
+    cz_sha256_ctx ctx;
+    cz_sha224_init(&ctx);
+    cz_sha256_update(&ctx, data, len);
+    cz_sha256_final(&ctx, out);
+}
+
+void cz_sha256(const void *data, size_t len, uint8_t out[CZ_SHA256_DIGEST_LENGTH]) {
+    cz_sha256_ctx ctx;
+    cz_sha256_init(&ctx);
+    cz_sha256_update(&ctx, data, len);
+    cz_sha256_final(&ctx, out);
+}
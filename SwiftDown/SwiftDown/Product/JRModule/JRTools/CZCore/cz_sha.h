@@ -0,0 +1,100 @@
+//
+//  cz_sha.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/11.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_sha_h
+#define cz_sha_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_SHA1_DIGEST_LENGTH       20
+#define CZ_SHA224_DIGEST_LENGTH     28
+#define CZ_SHA256_DIGEST_LENGTH     32
+#define CZ_SHA_BLOCK_LENGTH         64
+
+/// SHA1 增量上下文
+typedef struct {
+    uint32_t h[5];
+    uint64_t length;                    // 已输入的字节数
+    uint8_t  buffer[CZ_SHA_BLOCK_LENGTH];
+    uint32_t buffered;
+} cz_sha1_ctx;
+
+/// SHA224 / SHA256 增量上下文
+typedef struct {
+    uint32_t h[8];
+    uint64_t length;                    // 已输入的字节数
+    uint8_t  buffer[CZ_SHA_BLOCK_LENGTH];
+    uint32_t buffered;
+    uint32_t digest_length;             // 28 或 32
+} cz_sha256_ctx;
+
+/// 压缩函数，处理 nblocks 个完整的 64 字节分组
+typedef void (*cz_sha1_blocks_fn)(uint32_t h[5], const uint8_t *data, size_t nblocks);
+typedef void (*cz_sha256_blocks_fn)(uint32_t h[8], const uint8_t *data, size_t nblocks);
+
+/// 压缩函数的实现
+typedef enum {
+    CZSHAKernelAuto = 0,    // 按 CPU 自动选择
+    CZSHAKernelScalar,
+    CZSHAKernelSHANI,       // x86 SHA 扩展
+    CZSHAKernelARMv8,       // ARMv8 SHA1 / SHA2 指令
+    CZSHAKernelCount
+} CZSHAKernel;
+
+/// 当前选中的压缩函数
+///
+/// 首次调用时检测 CPU：ARMv8 SHA 指令、x86 SHA-NI，都没有则使用标量实现
+cz_sha1_blocks_fn cz_sha1_blocks(void);
+cz_sha256_blocks_fn cz_sha256_blocks(void);
+
+/// 标量参考实现，用于对照测试
+void cz_sha1_blocks_ref(uint32_t h[5], const uint8_t *data, size_t nblocks);
+void cz_sha256_blocks_ref(uint32_t h[8], const uint8_t *data, size_t nblocks);
+
+/// 当前使用的实现名称，"armv8" / "shani" / "scalar"
+const char *cz_sha_kernel_name(void);
+
+/// 当前平台能否使用 kernel，CZSHAKernelAuto 总是可以
+int cz_sha_kernel_available(CZSHAKernel kernel);
+
+/// 指定实现的压缩函数，当前平台不可用时返回 NULL
+cz_sha1_blocks_fn cz_sha1_blocks_for(CZSHAKernel kernel);
+cz_sha256_blocks_fn cz_sha256_blocks_for(CZSHAKernel kernel);
+
+/// 之后的 cz_sha1 / cz_sha256 等使用指定的实现，用于测试和性能对比
+///
+/// 只在没有其他线程正在散列时调用；CZSHAKernelAuto 恢复自动选择
+///
+/// @return 0 成功，-1 当前平台不可用 (保持原来的实现)
+int cz_sha_set_kernel(CZSHAKernel kernel);
+
+void cz_sha1_init(cz_sha1_ctx *ctx);
+void cz_sha1_update(cz_sha1_ctx *ctx, const void *data, size_t len);
+void cz_sha1_final(cz_sha1_ctx *ctx, uint8_t out[CZ_SHA1_DIGEST_LENGTH]);
+
+void cz_sha224_init(cz_sha256_ctx *ctx);
+void cz_sha256_init(cz_sha256_ctx *ctx);
+void cz_sha256_update(cz_sha256_ctx *ctx, const void *data, size_t len);
+
+/// 输出 ctx->digest_length 个字节
+void cz_sha256_final(cz_sha256_ctx *ctx, uint8_t *out);
+
+void cz_sha1(const void *data, size_t len, uint8_t out[CZ_SHA1_DIGEST_LENGTH]);
+void cz_sha224(const void *data, size_t len, uint8_t out[CZ_SHA224_DIGEST_LENGTH]);
+void cz_sha256(const void *data, size_t len, uint8_t out[CZ_SHA256_DIGEST_LENGTH]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_sha_h */
@@ -0,0 +1,147 @@
+//
+//  cz_tree_hash.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/13.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#include "cz_tree_hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t cz_tree_leaf_prefix = 0x00;
+static const uint8_t cz_tree_node_prefix = 0x01;
+
+size_t cz_tree_chunk_count(uint64_t length) {
+    if (length == 0) {
+        return 1;
+    }
+    return (size_t)((length + CZ_TREE_CHUNK_SIZE - 1) / CZ_TREE_CHUNK_SIZE);
+}
+
+void cz_tree_leaf(const void *chunk, size_t len, uint8_t out[CZ_TREE_HASH_LENGTH]) {
+    cz_sha256_ctx ctx;
+
+    cz_sha256_init(&ctx);
+    cz_sha256_update(&ctx, &cz_tree_leaf_prefix, 1);
+    cz_sha256_update(&ctx, chunk, len);
+    cz_sha256_final(&ctx, out);
+}
+
+void cz_tree_node(const uint8_t left[CZ_TREE_HASH_LENGTH],
+                  const uint8_t right[CZ_TREE_HASH_LENGTH],
+                  uint8_t out[CZ_TREE_HASH_LENGTH]) {
+    cz_sha256_ctx ctx;
+
+    cz_sha256_init(&ctx);
+    cz_sha256_update(&ctx, &cz_tree_node_prefix, 1);
+    cz_sha256_update(&ctx, left, CZ_TREE_HASH_LENGTH);
+    cz_sha256_update(&ctx, right, CZ_TREE_HASH_LENGTH);
+    cz_sha256_final(&ctx, out);
+}
+
+/// 原地把 n 个节点合并为上一层，返回上一层的节点数
+static size_t cz_tree_reduce(uint8_t *level, size_t n) {
+    size_t pairs = n / 2;
+
+    for (size_t i = 0; i < pairs; i++) {
+        cz_tree_node(level + 2 * i * CZ_TREE_HASH_LENGTH,
+                     level + (2 * i + 1) * CZ_TREE_HASH_LENGTH,
+                     level + i * CZ_TREE_HASH_LENGTH);
+    }
+    if (n & 1) {
+        memmove(level + pairs * CZ_TREE_HASH_LENGTH, level + (n - 1) * CZ_TREE_HASH_LENGTH, CZ_TREE_HASH_LENGTH);
+    }
+    return pairs + (n & 1);
+}
+
+int cz_tree_root(const uint8_t *leaves, size_t count, uint8_t root[CZ_TREE_HASH_LENGTH]) {
+    if (count == 0) {
+        return -1;
+    }
+
+    uint8_t *level = malloc(count * CZ_TREE_HASH_LENGTH);
+    if (level == NULL) {
+        return -1;
+    }
+    memcpy(level, leaves, count * CZ_TREE_HASH_LENGTH);
+
+    size_t n = count;
+    while (n > 1) {
+        n = cz_tree_reduce(level, n);
+    }
+    memcpy(root, level, CZ_TREE_HASH_LENGTH);
+
+    free(level);
+
+    return 0;
+}
+
+int cz_tree_proof(const uint8_t *leaves, size_t count, size_t index, uint8_t *proof) {
+    if (index >= count) {
+        return -1;
+    }
+
+    uint8_t *level = malloc(count * CZ_TREE_HASH_LENGTH);
+    if (level == NULL) {
+        return -1;
+    }
+    memcpy(level, leaves, count * CZ_TREE_HASH_LENGTH);
+
+    int proof_count = 0;
+    size_t n = count;
+
+    while (n > 1) {
+        size_t sibling = index ^ 1;
+
+        // 落单的最后一个节点这一层没有兄弟
+        if (sibling < n) {
+            memcpy(proof + proof_count * CZ_TREE_HASH_LENGTH, level + sibling * CZ_TREE_HASH_LENGTH, CZ_TREE_HASH_LENGTH);
+            proof_count++;
+        }
+        n = cz_tree_reduce(level, n);
+        index >>= 1;
+    }
+
+    free(level);
+
+    return proof_count;
+}
+
+int cz_tree_verify(const uint8_t leaf[CZ_TREE_HASH_LENGTH], size_t index, size_t count,
+                   const uint8_t *proof, size_t proof_count,
+                   const uint8_t root[CZ_TREE_HASH_LENGTH]) {
+    if (index >= count) {
+        return 0;
+    }
+
+    uint8_t hash[CZ_TREE_HASH_LENGTH];
+    memcpy(hash, leaf, CZ_TREE_HASH_LENGTH);
+
+    size_t used = 0;
+    size_t n = count;
+
+    while (n > 1) {
+        size_t sibling = index ^ 1;
+
+        if (sibling < n) {
+            if (used >= proof_count) {
+                return 0;
+            }
+            const uint8_t *other = proof + used * CZ_TREE_HASH_LENGTH;
+
+            if (index & 1) {
+                cz_tree_node(other, hash, hash);
+            } else {
+                cz_tree_node(hash, other, hash);
+            }
+            used++;
+        }
+        n = (n + 1) / 2;
+        index >>= 1;
+    }
+
+    return used == proof_count && memcmp(hash, root, CZ_TREE_HASH_LENGTH) == 0;
+}
@@ -0,0 +1,72 @@
+//
+//  cz_tree_hash.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/13.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+#ifndef cz_tree_hash_h
+#define cz_tree_hash_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cz_sha.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 树形散列 (Merkle Tree)
+//
+// - 文件按 CZ_TREE_CHUNK_SIZE 切块，最后一块可以不满，空文件视为一个空块
+// - 叶子 = SHA256(0x00 || 块数据)
+// - 节点 = SHA256(0x01 || 左 || 右)
+// - 每层从左到右两两合并，落单的最后一个节点原样进入上一层
+// - 根节点即整个文件的树形散列
+
+/// 切块大小，修改会改变所有根散列
+#define CZ_TREE_CHUNK_SIZE      (1 << 20)
+
+#define CZ_TREE_HASH_LENGTH     CZ_SHA256_DIGEST_LENGTH
+
+/// 证明路径的最大节点数 (树高)
+#define CZ_TREE_MAX_PROOF       64
+
+/// 文件长度对应的块数
+size_t cz_tree_chunk_count(uint64_t length);
+
+/// 计算一个叶子
+void cz_tree_leaf(const void *chunk, size_t len, uint8_t out[CZ_TREE_HASH_LENGTH]);
+
+/// 合并两个节点
+void cz_tree_node(const uint8_t left[CZ_TREE_HASH_LENGTH],
+                  const uint8_t right[CZ_TREE_HASH_LENGTH],
+                  uint8_t out[CZ_TREE_HASH_LENGTH]);
+
+/// 由全部叶子计算根
+///
+/// @param leaves count 个连续存放的叶子
+///
+/// @return 0 成功，-1 内存不足
+int cz_tree_root(const uint8_t *leaves, size_t count, uint8_t root[CZ_TREE_HASH_LENGTH]);
+
+/// 生成第 index 块的证明路径：自底向上的兄弟节点
+///
+/// @param proof 至少 CZ_TREE_MAX_PROOF * CZ_TREE_HASH_LENGTH 字节
+///
+/// @return 兄弟节点个数，-1 参数错误或内存不足
+int cz_tree_proof(const uint8_t *leaves, size_t count, size_t index, uint8_t *proof);
+
+/// 用证明路径校验一个叶子是否属于根
+///
+/// @return 1 校验通过，0 不通过
+int cz_tree_verify(const uint8_t leaf[CZ_TREE_HASH_LENGTH], size_t index, size_t count,
+                   const uint8_t *proof, size_t proof_count,
+                   const uint8_t root[CZ_TREE_HASH_LENGTH]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* cz_tree_hash_h */
@@ -0,0 +1,258 @@
+//
+//  bench_base64.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// BASE 64 编解码的吞吐
+///
+///     bench_base64 [MB]
+///
+/// - scalar: 每 3 字节 / 4 字符查一次表的逐组实现，作为参考和对照
+/// - openssl: EVP_EncodeBlock / EVP_DecodeBlock (只在链接 OpenSSL 的 Linux 上)
+/// - cz:     cz_base64_encode / cz_base64_decode
+///
+/// 开始前对照参考实现检查两种字母表的结果和非法输入。
+/// Makefile 在 x86 上还会用 -mssse3 编译一份 (bench_base64_ssse3)
+
+#include "cz_test.h"
+#include "cz_base64.h"
+
+#if !defined(__APPLE__)
+#define CZ_BENCH_OPENSSL 1
+#include <openssl/evp.h>
+#endif
+
+#pragma mark - 参考实现
+
+static const char *cz_ref_chars[] = {
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_",
+};
+
+static size_t cz_ref_encode(const uint8_t *bytes, size_t len, char *out, CZBase64Alphabet alphabet) {
+    const char *chars = cz_ref_chars[alphabet];
+    size_t k = 0;
+    size_t i = 0;
+
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = (uint32_t)bytes[i] << 16 | (uint32_t)bytes[i + 1] << 8 | bytes[i + 2];
+        out[k++] = chars[v >> 18];
+        out[k++] = chars[(v >> 12) & 63];
+        out[k++] = chars[(v >> 6) & 63];
+        out[k++] = chars[v & 63];
+    }
+    if (i < len) {
+        uint32_t v = (uint32_t)bytes[i] << 16 | (i + 1 < len ? (uint32_t)bytes[i + 1] << 8 : 0);
+        out[k++] = chars[v >> 18];
+        out[k++] = chars[(v >> 12) & 63];
+        out[k++] = i + 1 < len ? chars[(v >> 6) & 63] : '=';
+        out[k++] = '=';
+    }
+    return k;
+}
+
+/// 字符对应的值，非法字符为 -1，由 cz_ref_init 填好
+static int8_t cz_ref_values[2][256];
+
+static void cz_ref_init(void) {
+    memset(cz_ref_values, -1, sizeof(cz_ref_values));
+
+    for (int alphabet = 0; alphabet < 2; alphabet++) {
+        for (int i = 0; i < 64; i++) {
+            cz_ref_values[alphabet][(uint8_t)cz_ref_chars[alphabet][i]] = (int8_t)i;
+        }
+    }
+}
+
+/// 只处理带补位的输入，非法返回 -1
+static int cz_ref_decode(const char *in, size_t len, uint8_t *out, size_t *out_len, CZBase64Alphabet alphabet) {
+    const int8_t *values = cz_ref_values[alphabet];
+
+    if (len % 4 != 0) {
+        return -1;
+    }
+
+    size_t pad = len > 0 && in[len - 1] == '=' ? (len > 1 && in[len - 2] == '=' ? 2 : 1) : 0;
+    size_t k = 0;
+
+    for (size_t i = 0; i < len; i += 4) {
+        int last = i + 4 == len;
+        uint32_t v = 0;
+
+        for (int j = 0; j < 4; j++) {
+            int8_t x = last && j >= 4 - (int)pad ? 0 : values[(uint8_t)in[i + j]];
+            if (x < 0) {
+                return -1;
+            }
+            v = v << 6 | (uint32_t)x;
+        }
+        out[k++] = (uint8_t)(v >> 16);
+        if (!last || pad < 2) {
+            out[k++] = (uint8_t)(v >> 8);
+        }
+        if (!last || pad < 1) {
+            out[k++] = (uint8_t)v;
+        }
+    }
+    *out_len = k;
+    return 0;
+}
+
+#pragma mark - 正确性
+
+static int cz_check(void) {
+    uint8_t bytes[300];
+    uint8_t decoded[300];
+    char expected[400];
+    char actual[400];
+
+    cz_test_fill(bytes, sizeof(bytes), 3);
+
+    for (int alphabet = 0; alphabet < 2; alphabet++) {
+        for (size_t len = 0; len < sizeof(bytes); len++) {
+            size_t n = cz_ref_encode(bytes, len, expected, (CZBase64Alphabet)alphabet);
+            size_t m = cz_base64_encode(bytes, len, actual, (CZBase64Alphabet)alphabet, 1);
+            size_t out_len = 0;
+
+            if (n != m || memcmp(expected, actual, n) != 0 ||
+                cz_base64_decode(actual, m, decoded, &out_len, (CZBase64Alphabet)alphabet) != 0 ||
+                out_len != len || memcmp(decoded, bytes, len) != 0) {
+                printf("  alphabet %d, %zu bytes: differs from the reference\n", alphabet, len);
+                return 1;
+            }
+        }
+    }
+
+    // 非法字符出现在向量分组的每个位置都要被拒绝
+    for (size_t position = 0; position < 96; position++) {
+        size_t n = cz_ref_encode(bytes, 96, expected, CZBase64Standard);
+        size_t out_len = 0;
+
+        expected[position] = '-';
+        if (cz_base64_decode(expected, n, decoded, &out_len, CZBase64Standard) == 0) {
+            printf("  '-' at %zu accepted by the standard alphabet\n", position);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#pragma mark - 吞吐
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t         len;
+    const char    *text;
+    size_t         text_len;
+    char          *encoded;
+    uint8_t       *decoded;
+} cz_bench_buffers;
+
+static double cz_bench_encode(cz_bench_buffers *b, int which, size_t count) {
+    uint64_t best = UINT64_MAX;
+
+    for (int run = 0; run < 5; run++) {
+        uint64_t ns = cz_bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            if (which == 0) {
+                cz_ref_encode(b->bytes, b->len, b->encoded, CZBase64Standard);
+#if CZ_BENCH_OPENSSL
+            } else if (which == 1) {
+                EVP_EncodeBlock((unsigned char *)b->encoded, b->bytes, (int)b->len);
+#endif
+            } else {
+                cz_base64_encode(b->bytes, b->len, b->encoded, CZBase64Standard, 1);
+            }
+            cz_bench_consume(b->encoded);
+        }
+        ns = cz_bench_now_ns() - ns;
+        best = ns < best ? ns : best;
+    }
+    return cz_bench_mbps((uint64_t)b->len * count, best);
+}
+
+static double cz_bench_decode(cz_bench_buffers *b, int which, size_t count) {
+    uint64_t best = UINT64_MAX;
+    size_t out_len = 0;
+
+    for (int run = 0; run < 5; run++) {
+        uint64_t ns = cz_bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            if (which == 0) {
+                cz_ref_decode(b->text, b->text_len, b->decoded, &out_len, CZBase64Standard);
+#if CZ_BENCH_OPENSSL
+            } else if (which == 1) {
+                EVP_DecodeBlock(b->decoded, (const unsigned char *)b->text, (int)b->text_len);
+#endif
+            } else {
+                cz_base64_decode(b->text, b->text_len, b->decoded, &out_len, CZBase64Standard);
+            }
+            cz_bench_consume(b->decoded);
+        }
+        ns = cz_bench_now_ns() - ns;
+        best = ns < best ? ns : best;
+    }
+    return cz_bench_mbps((uint64_t)b->len * count, best);
+}
+
+int main(int argc, char *argv[]) {
+    size_t total = (argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 16) << 20;
+    static const size_t lengths[] = { 48, 1024, 64 << 10, 1 << 20 };
+    size_t max = 1 << 20;
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    printf("bench_base64 (neon)\n");
+#elif defined(__SSSE3__)
+    printf("bench_base64 (ssse3)\n");
+#else
+    printf("bench_base64 (scalar)\n");
+#endif
+
+    cz_ref_init();
+    if (cz_check() != 0) {
+        return 1;
+    }
+
+    uint8_t *bytes = malloc(max);
+    char *text = malloc(CZ_BASE64_ENCODED_LENGTH(max));
+    cz_bench_buffers b = {
+        .bytes = bytes,
+        .text = text,
+        .encoded = malloc(CZ_BASE64_ENCODED_LENGTH(max) + 1),
+        .decoded = malloc(CZ_BASE64_DECODED_MAX_LENGTH(CZ_BASE64_ENCODED_LENGTH(max))),
+    };
+    cz_test_fill(bytes, max, 4);
+
+    printf("MB/s of binary data   encode: scalar / openssl / cz    decode: scalar / openssl / cz\n");
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        b.len = lengths[l];
+        b.text_len = cz_ref_encode(bytes, b.len, text, CZBase64Standard);
+
+        size_t count = total / b.len;
+        double encode[3] = { 0 }, decode[3] = { 0 };
+
+        for (int which = 0; which < 3; which++) {
+#if !CZ_BENCH_OPENSSL
+            if (which == 1) {
+                continue;
+            }
+#endif
+            encode[which] = cz_bench_encode(&b, which, count);
+            decode[which] = cz_bench_decode(&b, which, count);
+        }
+
+        printf("  %7zu B   %7.0f / %7.0f / %7.0f    %7.0f / %7.0f / %7.0f\n", b.len,
+               encode[0], encode[1], encode[2], decode[0], decode[1], decode[2]);
+    }
+
+    free(bytes);
+    free(text);
+    free(b.encoded);
+    free(b.decoded);
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+//
+//  bench_batch.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 批量散列与逐条散列对比
+///
+///     bench_batch [条数 ...]
+///
+/// 消息长度在 8 ~ 96 字节之间随机，接近章节 ID、缓存 key 的长度。
+/// - CC loop:    原来 NSString+CZHash 每条调用一次 CC_MD5 / CC_SHA1 / CC_SHA256
+/// - cz loop:    每条调用一次 cz_digest
+/// - cz_batch:   cz_batch_digest 一次处理全部消息
+///
+/// 倍数是 cz loop 与 cz_batch 的比值。CPU 有 SHA 指令时 cz_batch 的 SHA1 / SHA256 逐条计算，
+/// 再强制使用标量 SHA 测一遍，对比多通道与标量的差距
+
+#include "cz_test.h"
+#include "cz_batch.h"
+#include "cz_digest.h"
+#include "cz_sha.h"
+
+#include <CommonCrypto/CommonCrypto.h>
+
+static const CZDigestAlgorithm cz_algs[] = { CZDigestMD5, CZDigestSHA1, CZDigestSHA256 };
+static const char *cz_names[] = { "md5", "sha1", "sha256" };
+
+static void cz_cc_digest(CZDigestAlgorithm alg, const void *bytes, size_t len, uint8_t *out) {
+    switch (alg) {
+        case CZDigestMD5:
+            CC_MD5(bytes, (CC_LONG)len, out);
+            break;
+        case CZDigestSHA1:
+            CC_SHA1(bytes, (CC_LONG)len, out);
+            break;
+        default:
+            CC_SHA256(bytes, (CC_LONG)len, out);
+            break;
+    }
+}
+
+static void cz_bench_count(size_t count) {
+    const void **msgs = malloc(count * sizeof(*msgs));
+    size_t *lens = malloc(count * sizeof(*lens));
+    uint8_t *bytes = malloc(count * 96);
+    uint8_t *out = malloc(count * CZ_DIGEST_MAX_LENGTH);
+    uint8_t *expected = malloc(count * CZ_DIGEST_MAX_LENGTH);
+    uint64_t state = count;
+    size_t total = 0;
+
+    cz_test_fill(bytes, count * 96, count);
+    for (size_t i = 0; i < count; i++) {
+        msgs[i] = bytes + i * 96;
+        lens[i] = 8 + (size_t)(cz_test_random(&state) % 89);
+        total += lens[i];
+    }
+
+    printf("%zu messages (%.1f MB, sha %s)\n", count, (double)total / (1 << 20), cz_sha_kernel_name());
+
+    int runs = count >= 1000000 ? 2 : 5;
+
+    for (size_t a = 0; a < sizeof(cz_algs) / sizeof(cz_algs[0]); a++) {
+        CZDigestAlgorithm alg = cz_algs[a];
+        size_t dlen = cz_digest_length(alg);
+        uint64_t best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+
+        for (int run = 0; run < runs; run++) {
+            uint64_t ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count; i++) {
+                cz_cc_digest(alg, msgs[i], lens[i], expected + i * dlen);
+            }
+            ns = cz_bench_now_ns() - ns;
+            best[0] = ns < best[0] ? ns : best[0];
+
+            ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count; i++) {
+                cz_digest(alg, msgs[i], lens[i], out + i * dlen);
+            }
+            ns = cz_bench_now_ns() - ns;
+            best[1] = ns < best[1] ? ns : best[1];
+
+            ns = cz_bench_now_ns();
+            cz_batch_digest(alg, msgs, lens, count, out);
+            ns = cz_bench_now_ns() - ns;
+            best[2] = ns < best[2] ? ns : best[2];
+        }
+
+        if (memcmp(out, expected, count * dlen) != 0) {
+            printf("  %s: batch result differs from CommonCrypto\n", cz_names[a]);
+            exit(1);
+        }
+
+        printf("  %-7s CC loop %7.1f ns/msg  cz loop %7.1f ns/msg  cz_batch %7.1f ns/msg  %.2fx\n", cz_names[a],
+               (double)best[0] / count, (double)best[1] / count, (double)best[2] / count,
+               (double)best[1] / (double)best[2]);
+    }
+
+    free(msgs);
+    free(lens);
+    free(bytes);
+    free(out);
+    free(expected);
+}
+
+int main(int argc, char *argv[]) {
+    printf("bench_batch (%d lanes)\n", cz_batch_lanes());
+
+    size_t counts[8] = { 10000, 100000, 1000000 };
+    int n = 3;
+
+    if (argc > 1) {
+        n = 0;
+        for (int i = 1; i < argc && n < 8; i++) {
+            counts[n++] = (size_t)strtoul(argv[i], NULL, 10);
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        cz_bench_count(counts[i]);
+    }
+
+    if (strcmp(cz_sha_kernel_name(), "scalar") != 0) {
+        cz_sha_set_kernel(CZSHAKernelScalar);
+        for (int i = 0; i < n; i++) {
+            cz_bench_count(counts[i]);
+        }
+        cz_sha_set_kernel(CZSHAKernelAuto);
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+//
+//  bench_chapter.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 字典转模型性能测试共用的章节模型和数据 (只在 macOS 上编译)
+///
+/// CZBenchChapter 对应 JRBookChapterModel 中 Objective-C 可见的属性；
+/// Swift 的可选数值属性 (CGFloat? / Bool? / TimeInterval?) 不是 @objc 属性，不参与映射
+
+#ifndef bench_chapter_h
+#define bench_chapter_h
+
+#import <Foundation/Foundation.h>
+
+@interface CZBenchChapter : NSObject
+
+@property (nonatomic, copy) NSString *bookId;
+@property (nonatomic, copy) NSString *chapterId;
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) BOOL status;
+@property (nonatomic, assign) NSInteger wordCount;
+@property (nonatomic, copy) NSString *content;
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, assign) BOOL isDowload;
+@property (nonatomic, assign) NSInteger pageNumb;
+
+@end
+
+@implementation CZBenchChapter
+
+/// 与 JRChapterRecord 相同，数值属性直接写入成员变量
++ (BOOL)cz_mapsScalarsDirectly {
+    return YES;
+}
+
+@end
+
+/// 章节目录接口返回的字典数组，含模型中没有的 key
+static inline NSArray<NSDictionary *> *CZBenchChapterDictionaries(NSUInteger count) {
+    NSMutableArray *arrayM = [NSMutableArray arrayWithCapacity:count];
+
+    for (NSUInteger i = 0; i < count; i++) {
+        [arrayM addObject:@{
+            @"bookId": @479435,
+            @"chapterId": @(8167891 + i),
+            @"name": [NSString stringWithFormat:@"第%lu章 九月，咱们能疯狂一次么！", (unsigned long)i + 1],
+            @"wordCount": @(2000 + i % 1500),
+            @"status": @1,
+            @"isVip": @(i > 50),
+            @"actualPrice": @(i > 50 ? 0.12 : 0),
+            @"createTime": @(1506000000 + i * 3600),
+            @"key": [NSNull null],
+            @"volumeId": @(i / 100),
+            @"updateTime": @"2017-09-16 12:00:00",
+        }];
+    }
+
+    return arrayM.copy;
+}
+
+/// 原来的 cz_objectsWithArray:，属性数组线性查找 key，再经过 KVC 赋值
+static inline NSArray *CZBenchLegacyObjects(Class cls, NSArray *array, NSArray *list) {
+    NSMutableArray *arrayM = [NSMutableArray array];
+
+    for (NSDictionary *dict in array) {
+        id obj = [cls new];
+
+        for (NSString *key in dict) {
+            if (![list containsObject:key]) {
+                continue;
+            }
+            [obj setValue:dict[key] forKey:key];
+        }
+        [arrayM addObject:obj];
+    }
+
+    return arrayM.copy;
+}
+
+#endif /* bench_chapter_h */
@@ -0,0 +1,273 @@
+//
+//  bench_fasthash.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_fasthash 的速度和分布质量
+///
+///     bench_fasthash [key 数]
+///
+/// 速度：短 key 每次的耗时、长数据的吞吐，与缓存文件名原来使用的 MD5 对比
+///
+/// 质量：
+/// 1. 雪崩：翻转输入的每一位，统计每个输出位翻转的概率，报告离 0.5 最远的偏差
+/// 2. 碰撞：顺序编号的 key ("chapter_%zu"、8 字节计数) 的 64 位结果不能碰撞，
+///    低 32 位的碰撞数应接近随机函数的期望 n² / 2³³
+/// 3. 分布：低 16 位分桶的卡方值，自由度 65535，随机函数约为 65535 ± 362
+///
+/// 质量不达标时返回 1
+
+#include "cz_test.h"
+#include "cz_digest.h"
+#include "cz_fasthash.h"
+
+#include <math.h>
+
+#pragma mark - 速度
+
+static void cz_bench_short(void) {
+    static const size_t lengths[] = { 8, 16, 32, 64, 128, 256 };
+    uint8_t key[256];
+    uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+    size_t count = 1000000;
+
+    cz_test_fill(key, sizeof(key), 1);
+
+    printf("short keys (ns/hash)\n");
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t len = lengths[l];
+        uint64_t best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+
+        for (int run = 0; run < 5; run++) {
+            uint64_t h = 0;
+            uint64_t ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count; i++) {
+                // 结果作为下一次的种子，避免多次调用被并行
+                h = cz_fasthash64(key, len, h);
+            }
+            ns = cz_bench_now_ns() - ns;
+            cz_bench_consume(&h);
+            best[0] = ns < best[0] ? ns : best[0];
+
+            cz_hash128 h128 = { 0, 0 };
+            ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count; i++) {
+                h128 = cz_fasthash128(key, len, h128.low);
+            }
+            ns = cz_bench_now_ns() - ns;
+            cz_bench_consume(&h128);
+            best[1] = ns < best[1] ? ns : best[1];
+
+            ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count / 10; i++) {
+                cz_digest(CZDigestMD5, key, len, digest);
+                cz_bench_consume(digest);
+            }
+            ns = (cz_bench_now_ns() - ns) * 10;
+            best[2] = ns < best[2] ? ns : best[2];
+        }
+
+        printf("  %4zu B  fasthash64 %6.1f  fasthash128 %6.1f  md5 %7.1f\n", len,
+               (double)best[0] / count, (double)best[1] / count, (double)best[2] / count);
+    }
+}
+
+static void cz_bench_long(void) {
+    static const size_t lengths[] = { 4096, 1 << 20 };
+    size_t max = 1 << 20;
+    uint8_t *data = malloc(max);
+    uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+
+    cz_test_fill(data, max, 2);
+
+    printf("long data (MB/s)\n");
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t len = lengths[l];
+        size_t count = (64u << 20) / len;
+        uint64_t best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+
+        for (int run = 0; run < 3; run++) {
+            uint64_t h = 0;
+            uint64_t ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count; i++) {
+                h = cz_fasthash64(data, len, h);
+            }
+            ns = cz_bench_now_ns() - ns;
+            cz_bench_consume(&h);
+            best[0] = ns < best[0] ? ns : best[0];
+
+            // 流式计算，每次 1000 字节，不与条带对齐
+            ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count; i++) {
+                cz_fasthash_state state;
+                cz_fasthash_init(&state, 0);
+                for (size_t offset = 0; offset < len; offset += 1000) {
+                    cz_fasthash_update(&state, data + offset, len - offset < 1000 ? len - offset : 1000);
+                }
+                h = cz_fasthash_final64(&state);
+                cz_bench_consume(&h);
+            }
+            ns = cz_bench_now_ns() - ns;
+            best[1] = ns < best[1] ? ns : best[1];
+
+            ns = cz_bench_now_ns();
+            for (size_t i = 0; i < count / 8; i++) {
+                cz_digest(CZDigestMD5, data, len, digest);
+                cz_bench_consume(digest);
+            }
+            ns = (cz_bench_now_ns() - ns) * 8;
+            best[2] = ns < best[2] ? ns : best[2];
+        }
+
+        uint64_t bytes = (uint64_t)len * count;
+        printf("  %7zu B  fasthash64 %8.1f  streaming %8.1f  md5 %7.1f\n", len,
+               cz_bench_mbps(bytes, best[0]), cz_bench_mbps(bytes, best[1]), cz_bench_mbps(bytes, best[2]));
+    }
+
+    free(data);
+}
+
+#pragma mark - 质量
+
+/// 返回 64 个输出位中翻转概率离 0.5 最远的偏差
+static double cz_avalanche(size_t len, size_t samples) {
+    uint8_t *key = malloc(len);
+    uint64_t *flips = calloc(64, sizeof(uint64_t));
+    uint64_t state = 0xa5a5 + len;
+    uint64_t trials = 0;
+
+    for (size_t s = 0; s < samples; s++) {
+        for (size_t i = 0; i < len; i++) {
+            key[i] = (uint8_t)(cz_test_random(&state) >> 56);
+        }
+        uint64_t h = cz_fasthash64(key, len, 0);
+
+        for (size_t bit = 0; bit < 8 * len; bit++) {
+            key[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            uint64_t diff = h ^ cz_fasthash64(key, len, 0);
+            key[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+
+            for (int o = 0; o < 64; o++) {
+                flips[o] += (diff >> o) & 1;
+            }
+            trials++;
+        }
+    }
+
+    double worst = 0;
+    for (int o = 0; o < 64; o++) {
+        double bias = fabs((double)flips[o] / (double)trials - 0.5);
+        worst = bias > worst ? bias : worst;
+    }
+
+    free(key);
+    free(flips);
+
+    return worst;
+}
+
+static int cz_compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/// 排好序的结果中相邻相等的个数
+static size_t cz_count_collisions(uint64_t *hashes, size_t count) {
+    size_t collisions = 0;
+
+    qsort(hashes, count, sizeof(uint64_t), cz_compare_u64);
+    for (size_t i = 1; i < count; i++) {
+        collisions += hashes[i] == hashes[i - 1];
+    }
+    return collisions;
+}
+
+static double cz_chi_square(const uint64_t *hashes, size_t count) {
+    size_t buckets = 1 << 16;
+    uint32_t *counts = calloc(buckets, sizeof(uint32_t));
+
+    for (size_t i = 0; i < count; i++) {
+        counts[hashes[i] & (buckets - 1)]++;
+    }
+
+    double expected = (double)count / (double)buckets;
+    double chi = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        double d = counts[b] - expected;
+        chi += d * d / expected;
+    }
+
+    free(counts);
+    return chi;
+}
+
+/// 顺序 key 的碰撞和分布，kind 0 为 "chapter_%zu"，1 为 8 字节小端计数
+static int cz_check_keys(size_t count, int kind) {
+    uint64_t *hashes = malloc(count * sizeof(uint64_t));
+    uint64_t *low = malloc(count * sizeof(uint64_t));
+    int failed = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (kind == 0) {
+            char key[32];
+            int len = snprintf(key, sizeof(key), "chapter_%zu", i);
+            hashes[i] = cz_fasthash64(key, (size_t)len, 0);
+        } else {
+            uint64_t key = i;
+            hashes[i] = cz_fasthash64(&key, sizeof(key), 0);
+        }
+        low[i] = hashes[i] & 0xffffffffu;
+    }
+
+    double chi = cz_chi_square(hashes, count);
+    size_t full = cz_count_collisions(hashes, count);
+    size_t half = cz_count_collisions(low, count);
+    double expected = (double)count * (double)count / 8589934592.0;
+
+    printf("  %-12s %zu keys: 64-bit collisions %zu, 32-bit %zu (expected %.0f), chi-square %.0f\n",
+           kind == 0 ? "chapter_%zu" : "counter", count, full, half, expected, chi);
+
+    // 64 位不能碰撞；32 位碰撞和卡方值偏离期望过多视为分布有问题
+    if (full != 0 || half > 2 * expected + 20 || fabs(chi - 65535) > 10 * 362) {
+        failed = 1;
+    }
+
+    free(hashes);
+    free(low);
+    return failed;
+}
+
+int main(int argc, char *argv[]) {
+    size_t keys = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 1000000;
+    int failed = 0;
+
+    printf("bench_fasthash\n");
+    cz_bench_short();
+    cz_bench_long();
+
+    printf("avalanche (worst output bit bias)\n");
+    static const struct { size_t len, samples; } avalanche[] = {
+        { 4, 20000 }, { 8, 20000 }, { 16, 10000 }, { 64, 2000 }, { 300, 300 }, { 1024, 100 },
+    };
+    for (size_t i = 0; i < sizeof(avalanche) / sizeof(avalanche[0]); i++) {
+        double bias = cz_avalanche(avalanche[i].len, avalanche[i].samples);
+        printf("  %4zu B  %.4f\n", avalanche[i].len, bias);
+        failed |= bias > 0.01;
+    }
+
+    printf("sequential keys\n");
+    failed |= cz_check_keys(keys, 0);
+    failed |= cz_check_keys(keys, 1);
+
+    if (failed) {
+        printf("bench_fasthash: quality check FAILED\n");
+    }
+    return failed;
+}
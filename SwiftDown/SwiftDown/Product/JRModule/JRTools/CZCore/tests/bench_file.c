@@ -0,0 +1,149 @@
+//
+//  bench_file.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 文件散列的读取方式对比
+///
+///     bench_file [MB ...]
+///
+/// - 4K loop: 原来 cz_file*Hash 的做法，每 4 KB 分配一块缓冲区 (对应每次一个 NSData) 再 read
+/// - stream:  cz_file_read_chunks 默认的 1 MB 页对齐缓冲区 pread
+/// - mapped:  CZFileReadMapped，不小于 CZ_FILE_MAP_MIN_SIZE 时只读映射 (cz_multi_digest_file 的方式)
+///
+/// 每种方式分别配合 CRC32C (读取开销为主) 和 SHA-256 (散列开销为主)；
+/// 文件刚写入，都在页缓存中，测的是系统调用、分配和复制的开销
+
+#include "cz_test.h"
+#include "cz_crc32c.h"
+#include "cz_file.h"
+#include "cz_sha.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+typedef struct {
+    int           sha256;
+    uint32_t      crc;
+    cz_sha256_ctx ctx;
+} cz_bench_consumer;
+
+static int cz_bench_consume_chunk(void *ctx, const uint8_t *bytes, size_t len) {
+    cz_bench_consumer *consumer = ctx;
+
+    if (consumer->sha256) {
+        cz_sha256_update(&consumer->ctx, bytes, len);
+    } else {
+        consumer->crc = cz_crc32c(consumer->crc, bytes, len);
+    }
+    return 0;
+}
+
+/// 原来的 4 KB 循环：每块单独分配
+static int cz_bench_read_4k(const char *path, cz_bench_consumer *consumer) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    while (1) {
+        uint8_t *chunk = malloc(4096);
+        ssize_t n = read(fd, chunk, 4096);
+
+        if (n <= 0) {
+            free(chunk);
+            break;
+        }
+        cz_bench_consume_chunk(consumer, chunk, (size_t)n);
+        free(chunk);
+    }
+    close(fd);
+
+    return 0;
+}
+
+static void cz_bench_mode(const char *path, size_t size, int mode, int sha256) {
+    static const char *names[] = { "4K loop", "stream", "mapped" };
+    uint64_t best = UINT64_MAX;
+    int runs = size >= (256u << 20) ? 3 : 5;
+
+    for (int run = 0; run < runs; run++) {
+        cz_bench_consumer consumer = { .sha256 = sha256 };
+        cz_sha256_init(&consumer.ctx);
+
+        uint64_t ns = cz_bench_now_ns();
+
+        if (mode == 0) {
+            cz_bench_read_4k(path, &consumer);
+        } else {
+            CZFileReadMode readMode = mode == 1 ? CZFileReadStream : CZFileReadMapped;
+            cz_file_read_chunks_mode(path, readMode, cz_bench_consume_chunk, &consumer);
+        }
+
+        ns = cz_bench_now_ns() - ns;
+        cz_bench_consume(&consumer);
+
+        if (ns < best) {
+            best = ns;
+        }
+    }
+
+    printf("  %-8s %-7s %9.1f MB/s\n", names[mode], sha256 ? "sha256" : "crc32c", cz_bench_mbps(size, best));
+}
+
+int main(int argc, char *argv[]) {
+    size_t sizes[8] = { 1, 16, 256 };
+    int count = 3;
+
+    if (argc > 1) {
+        count = 0;
+        for (int i = 1; i < argc && count < 8; i++) {
+            sizes[count++] = (size_t)strtoul(argv[i], NULL, 10);
+        }
+    }
+
+    const char *dir = getenv("TMPDIR");
+    if (dir == NULL || dir[0] == '\0') {
+        dir = "/tmp";
+    }
+
+    printf("bench_file (crc32c: %s, sha: %s)\n", cz_crc32c_kernel_name(), cz_sha_kernel_name());
+
+    for (int s = 0; s < count; s++) {
+        size_t size = sizes[s] << 20;
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s/cz_bench_file_XXXXXX", dir);
+
+        int fd = mkstemp(path);
+        if (fd < 0) {
+            perror("mkstemp");
+            return 1;
+        }
+
+        // 分块写入，避免一次分配整个文件
+        uint8_t *block = malloc(1 << 20);
+        cz_test_fill(block, 1 << 20, 1);
+        for (size_t written = 0; written < size; written += 1 << 20) {
+            if (write(fd, block, 1 << 20) != 1 << 20) {
+                perror("write");
+                return 1;
+            }
+        }
+        free(block);
+        close(fd);
+
+        printf("%zu MB\n", sizes[s]);
+        for (int sha256 = 0; sha256 < 2; sha256++) {
+            for (int mode = 0; mode < 3; mode++) {
+                cz_bench_mode(path, size, mode, sha256);
+            }
+        }
+        unlink(path);
+    }
+
+    return 0;
+}
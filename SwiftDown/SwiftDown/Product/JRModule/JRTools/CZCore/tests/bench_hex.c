@@ -0,0 +1,111 @@
+//
+//  bench_hex.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 十六进制编解码与逐字节格式化对比
+///
+///     bench_hex [次数]
+///
+/// - %02x:  stringFromBytes:length: 和 JRNetWorkURL.md5String 的做法，每字节格式化一次。
+///          这里用 snprintf 写进 char 缓冲区，不含 NSMutableString / String 追加的开销，
+///          实际的差距只会更大
+/// - cz_hex: cz_hex_encode / cz_hex_decode
+///
+/// Makefile 在 x86 上还会用 -mssse3 编译一份 (bench_hex_ssse3)
+
+#include "cz_test.h"
+#include "cz_hex.h"
+
+static void cz_format_encode(const uint8_t *bytes, size_t len, char *out) {
+    for (size_t i = 0; i < len; i++) {
+        snprintf(out + 2 * i, 3, "%02x", bytes[i]);
+    }
+}
+
+static int cz_format_decode(const char *hex, size_t len, uint8_t *out) {
+    for (size_t i = 0; i < len / 2; i++) {
+        if (sscanf(hex + 2 * i, "%2hhx", &out[i]) != 1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static double cz_bench_ns(void (*fn)(const void *, size_t, void *), const void *in, size_t len, void *out, size_t count) {
+    uint64_t best = UINT64_MAX;
+
+    for (int run = 0; run < 5; run++) {
+        uint64_t ns = cz_bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            fn(in, len, out);
+            cz_bench_consume(out);
+        }
+        ns = cz_bench_now_ns() - ns;
+        best = ns < best ? ns : best;
+    }
+    return (double)best / (double)count;
+}
+
+static void cz_run_format_encode(const void *in, size_t len, void *out) {
+    cz_format_encode(in, len, out);
+}
+
+static void cz_run_hex_encode(const void *in, size_t len, void *out) {
+    cz_hex_encode(in, len, out);
+}
+
+static void cz_run_format_decode(const void *in, size_t len, void *out) {
+    cz_format_decode(in, 2 * len, out);
+}
+
+static void cz_run_hex_decode(const void *in, size_t len, void *out) {
+    cz_hex_decode(in, 2 * len, out);
+}
+
+int main(int argc, char *argv[]) {
+    size_t count = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 20000;
+    // MD5 / SHA1 / SHA256 / SHA512 的结果，以及一段较长的数据
+    static const size_t lengths[] = { 16, 20, 32, 64, 4096 };
+
+    uint8_t bytes[4096];
+    uint8_t decoded[4096];
+    char expected[2 * 4096 + 1];
+    char hex[2 * 4096 + 1];
+
+    cz_test_fill(bytes, sizeof(bytes), 1);
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    printf("bench_hex (neon, %zu iterations)\n", count);
+#elif defined(__SSSE3__)
+    printf("bench_hex (ssse3, %zu iterations)\n", count);
+#else
+    printf("bench_hex (scalar, %zu iterations)\n", count);
+#endif
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t len = lengths[l];
+        size_t n = len > 64 ? count / 64 : count;
+
+        cz_format_encode(bytes, len, expected);
+        cz_hex_encode(bytes, len, hex);
+        if (memcmp(expected, hex, 2 * len) != 0 || cz_hex_decode(hex, 2 * len, decoded) != 0 ||
+            memcmp(decoded, bytes, len) != 0) {
+            printf("  %zu bytes: cz_hex differs from %%02x\n", len);
+            return 1;
+        }
+
+        double format = cz_bench_ns(cz_run_format_encode, bytes, len, hex, n);
+        double table = cz_bench_ns(cz_run_hex_encode, bytes, len, hex, n);
+        printf("  encode %4zu B  %%02x %9.1f ns  cz_hex %7.1f ns  %6.1fx\n", len, format, table, format / table);
+
+        format = cz_bench_ns(cz_run_format_decode, expected, len, decoded, n);
+        table = cz_bench_ns(cz_run_hex_decode, expected, len, decoded, n);
+        printf("  decode %4zu B  %%02x %9.1f ns  cz_hex %7.1f ns  %6.1fx\n", len, format, table, format / table);
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+//
+//  bench_hmac.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 短消息 HMAC：预处理密钥与每条消息重新处理密钥对比
+///
+///     bench_hmac [消息数]
+///
+/// - cached: CZHmac / sharedHmacWithKey: 的做法，密钥只处理一次，每条消息复制状态
+/// - per-message: 每条消息都 cz_hmac_key_init，相当于每次 CCHmac
+///
+/// 请求签名的消息通常只有几十到几百字节，密钥处理的两个分组占了大部分时间
+
+#include "cz_test.h"
+#include "cz_hmac.h"
+
+static const char *cz_names[] = { "md5", "sha1", "sha224", "sha256", "sha384", "sha512" };
+
+static void cz_bench_alg(CZDigestAlgorithm alg, const uint8_t *secret, size_t secret_len,
+                         const uint8_t *message, size_t len, size_t count) {
+    uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+    uint64_t best_cached = UINT64_MAX;
+    uint64_t best_fresh = UINT64_MAX;
+
+    for (int run = 0; run < 5; run++) {
+        cz_hmac_key key;
+        cz_hmac_key_init(&key, alg, secret, secret_len);
+
+        uint64_t ns = cz_bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            cz_hmac(&key, message, len, digest);
+            cz_bench_consume(digest);
+        }
+        ns = cz_bench_now_ns() - ns;
+        best_cached = ns < best_cached ? ns : best_cached;
+
+        ns = cz_bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            cz_hmac_key fresh;
+            cz_hmac_key_init(&fresh, alg, secret, secret_len);
+            cz_hmac(&fresh, message, len, digest);
+            cz_bench_consume(digest);
+        }
+        ns = cz_bench_now_ns() - ns;
+        best_fresh = ns < best_fresh ? ns : best_fresh;
+    }
+
+    double cached = (double)best_cached / (double)count;
+    double fresh = (double)best_fresh / (double)count;
+
+    printf("  %-7s %4zu B  cached %7.1f ns  per-message %7.1f ns  %.2fx\n",
+           cz_names[alg], len, cached, fresh, fresh / cached);
+}
+
+int main(int argc, char *argv[]) {
+    size_t count = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 50000;
+    static const size_t lengths[] = { 16, 64, 256 };
+
+    uint8_t message[256];
+    uint8_t secret[32];
+
+    cz_test_fill(message, sizeof(message), 1);
+    cz_test_fill(secret, sizeof(secret), 2);
+
+    printf("bench_hmac (%zu messages, 32 byte key)\n", count);
+
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            cz_bench_alg((CZDigestAlgorithm)alg, secret, sizeof(secret), message, lengths[l], count);
+        }
+    }
+
+    return 0;
+}
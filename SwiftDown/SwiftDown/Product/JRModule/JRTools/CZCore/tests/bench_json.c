@@ -0,0 +1,353 @@
+//
+//  bench_json.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 章节目录 JSON 解码
+///
+///     bench_json [章节数 ...]
+///
+/// 数据与 bench_chapter.h 的字典数组相同，放在 {"code":0,"data":[...]} 中，每 10 章的名字含有转义。
+/// - scan: 只读 token，解析器本身的吞吐
+/// - tree: 原来 NSJSONSerialization + cz_objectsWithArray: 的做法，先建完整的树，
+///         每个 key 和字符串都复制一份，再按字符串比较 key 赋给结构体。
+///         用同一个解析器读 token，只比较中间树的开销，不含装箱和 KVC
+/// - pull: CZJSONModelDecoder 的做法，key 按原子 ID 分派，直接赋给结构体，没有的 key 整段跳过
+
+#include "cz_test.h"
+#include "cz_json.h"
+
+/// 模型中的属性
+typedef struct {
+    int64_t bookId;
+    int64_t chapterId;
+    int64_t wordCount;
+    int     status;
+    int     hasKey;
+    char    name[128];
+} cz_chapter;
+
+static char *cz_chapter_json(size_t count, size_t *len) {
+    size_t cap = 64 + count * 320;
+    char *json = malloc(cap);
+    size_t n = (size_t)snprintf(json, cap, "{\"code\":0,\"data\":[");
+
+    for (size_t i = 0; i < count; i++) {
+        n += (size_t)snprintf(json + n, cap - n,
+                              "%s{\"bookId\":479435,\"chapterId\":%zu,"
+                              "\"name\":\"\xe7\xac\xac%zu\xe7\xab\xa0 %s\","
+                              "\"wordCount\":%zu,\"status\":1,\"isVip\":%s,\"actualPrice\":%s,"
+                              "\"createTime\":%zu,\"key\":null,\"volumeId\":%zu,"
+                              "\"updateTime\":\"2017-09-16 12:00:00\"}",
+                              i == 0 ? "" : ",", 8167891 + i, i + 1,
+                              i % 10 == 0 ? "\\\"\\u4e5d\\u6708\\\"" :
+                                            "\xe4\xb9\x9d\xe6\x9c\x88\xef\xbc\x8c\xe5\x92\xb1\xe4\xbb\xac",
+                              2000 + i % 1500, i > 50 ? "true" : "false", i > 50 ? "0.12" : "0",
+                              1506000000 + i * 3600, i / 100);
+    }
+    n += (size_t)snprintf(json + n, cap - n, "]}");
+
+    *len = n;
+    return json;
+}
+
+static void cz_copy_name(cz_chapter *chapter, const cz_json_parser *parser) {
+    size_t len = parser->str_len < sizeof(chapter->name) - 1 ? parser->str_len : sizeof(chapter->name) - 1;
+
+    if (parser->str_escaped) {
+        char buffer[256];
+        len = parser->str_len <= sizeof(buffer) ? cz_json_unescape(parser->str, parser->str_len, buffer) : 0;
+        if (len == (size_t)-1 || len >= sizeof(chapter->name)) {
+            len = 0;
+        }
+        memcpy(chapter->name, buffer, len);
+    } else {
+        memcpy(chapter->name, parser->str, len);
+    }
+    chapter->name[len] = '\0';
+}
+
+#pragma mark - scan
+
+static size_t cz_decode_scan(const char *json, size_t len, cz_chapter *chapters) {
+    cz_json_parser parser;
+    CZJSONToken token;
+    size_t tokens = 0;
+
+    (void)chapters;
+    cz_json_init(&parser, json, len);
+    while ((token = cz_json_next(&parser)) > CZJSONEnd) {
+        tokens++;
+    }
+    return token == CZJSONEnd ? tokens : 0;
+}
+
+#pragma mark - tree
+
+typedef struct cz_node cz_node;
+
+struct cz_node {
+    CZJSONToken type;
+    char       *key;        // 对象成员的 key
+    char       *string;
+    size_t      string_len;
+    int64_t     integer;
+    double      number;
+    cz_node    *child;      // 第一个成员 / 元素
+    cz_node    *next;
+};
+
+static char *cz_node_string(const cz_json_parser *parser, size_t *out_len) {
+    char *s = malloc(parser->str_len + 1);
+    size_t len = parser->str_escaped ? cz_json_unescape(parser->str, parser->str_len, s) : parser->str_len;
+
+    if (!parser->str_escaped) {
+        memcpy(s, parser->str, len);
+    }
+    s[len] = '\0';
+    if (out_len != NULL) {
+        *out_len = len;
+    }
+    return s;
+}
+
+static cz_node *cz_node_parse(cz_json_parser *parser, CZJSONToken token) {
+    cz_node *node = calloc(1, sizeof(cz_node));
+    node->type = token;
+
+    switch (token) {
+        case CZJSONString:
+            node->string = cz_node_string(parser, &node->string_len);
+            break;
+        case CZJSONInteger:
+        case CZJSONDouble:
+            node->integer = parser->integer;
+            node->number = parser->number;
+            break;
+        case CZJSONObjectBegin:
+        case CZJSONArrayBegin: {
+            cz_node **tail = &node->child;
+
+            for (;;) {
+                char *key = NULL;
+                token = cz_json_next(parser);
+                if (token == CZJSONObjectEnd || token == CZJSONArrayEnd) {
+                    break;
+                }
+                if (token == CZJSONKey) {
+                    key = cz_node_string(parser, NULL);
+                    token = cz_json_next(parser);
+                }
+                *tail = cz_node_parse(parser, token);
+                (*tail)->key = key;
+                tail = &(*tail)->next;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return node;
+}
+
+static void cz_node_free(cz_node *node) {
+    while (node != NULL) {
+        cz_node *next = node->next;
+
+        cz_node_free(node->child);
+        free(node->key);
+        free(node->string);
+        free(node);
+        node = next;
+    }
+}
+
+static size_t cz_decode_tree(const char *json, size_t len, cz_chapter *chapters) {
+    cz_json_parser parser;
+    size_t count = 0;
+
+    cz_json_init(&parser, json, len);
+    cz_node *root = cz_node_parse(&parser, cz_json_next(&parser));
+
+    cz_node *data = root->child;
+    while (data != NULL && strcmp(data->key, "data") != 0) {
+        data = data->next;
+    }
+
+    for (cz_node *item = data != NULL ? data->child : NULL; item != NULL; item = item->next) {
+        cz_chapter *chapter = &chapters[count++];
+
+        memset(chapter, 0, sizeof(*chapter));
+        for (cz_node *member = item->child; member != NULL; member = member->next) {
+            if (strcmp(member->key, "bookId") == 0) {
+                chapter->bookId = member->integer;
+            } else if (strcmp(member->key, "chapterId") == 0) {
+                chapter->chapterId = member->integer;
+            } else if (strcmp(member->key, "name") == 0) {
+                size_t n = member->string_len < sizeof(chapter->name) - 1 ? member->string_len : sizeof(chapter->name) - 1;
+                memcpy(chapter->name, member->string, n);
+                chapter->name[n] = '\0';
+            } else if (strcmp(member->key, "wordCount") == 0) {
+                chapter->wordCount = member->integer;
+            } else if (strcmp(member->key, "status") == 0) {
+                chapter->status = member->type == CZJSONTrue || (member->type == CZJSONInteger && member->integer != 0);
+            } else if (strcmp(member->key, "key") == 0) {
+                chapter->hasKey = member->type != CZJSONNull;
+            }
+        }
+    }
+
+    cz_node_free(root);
+    return count;
+}
+
+#pragma mark - pull
+
+enum {
+    CZ_KEY_BOOK_ID,
+    CZ_KEY_CHAPTER_ID,
+    CZ_KEY_NAME,
+    CZ_KEY_WORD_COUNT,
+    CZ_KEY_STATUS,
+    CZ_KEY_KEY,
+    CZ_KEY_DATA,
+    CZ_KEY_COUNT,
+};
+
+static const char *cz_key_names[CZ_KEY_COUNT] = { "bookId", "chapterId", "name", "wordCount", "status", "key", "data" };
+static cz_atom cz_key_atoms[CZ_KEY_COUNT];
+
+static int cz_key_index(cz_atom atom) {
+    for (int k = 0; k < CZ_KEY_COUNT; k++) {
+        if (cz_key_atoms[k] == atom) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+static size_t cz_decode_pull(const char *json, size_t len, cz_chapter *chapters) {
+    cz_json_parser parser;
+    size_t count = 0;
+
+    cz_json_init(&parser, json, len);
+    if (cz_json_next(&parser) != CZJSONObjectBegin) {
+        return 0;
+    }
+
+    // 找到 data，其余的值跳过
+    for (;;) {
+        if (cz_json_next(&parser) != CZJSONKey) {
+            return 0;
+        }
+        cz_atom atom = cz_json_key_atom(&parser);
+        CZJSONToken token = cz_json_next(&parser);
+        if (atom != CZ_ATOM_NONE && atom == cz_key_atoms[CZ_KEY_DATA] && token == CZJSONArrayBegin) {
+            break;
+        }
+        if (cz_json_skip(&parser, token) != 0) {
+            return 0;
+        }
+    }
+
+    CZJSONToken token;
+    while ((token = cz_json_next(&parser)) == CZJSONObjectBegin) {
+        cz_chapter *chapter = &chapters[count++];
+
+        memset(chapter, 0, sizeof(*chapter));
+        while ((token = cz_json_next(&parser)) == CZJSONKey) {
+            cz_atom atom = cz_json_key_atom(&parser);
+            int k = atom != CZ_ATOM_NONE ? cz_key_index(atom) : -1;
+
+            token = cz_json_next(&parser);
+            switch (k) {
+                case CZ_KEY_BOOK_ID:    chapter->bookId = parser.integer;                                   break;
+                case CZ_KEY_CHAPTER_ID: chapter->chapterId = parser.integer;                                break;
+                case CZ_KEY_NAME:       cz_copy_name(chapter, &parser);                                     break;
+                case CZ_KEY_WORD_COUNT: chapter->wordCount = parser.integer;                                break;
+                case CZ_KEY_STATUS:     chapter->status = token == CZJSONTrue || parser.integer != 0;       break;
+                case CZ_KEY_KEY:        chapter->hasKey = token != CZJSONNull;                              break;
+                default:
+                    if (cz_json_skip(&parser, token) != 0) {
+                        return 0;
+                    }
+                    break;
+            }
+        }
+        if (token != CZJSONObjectEnd) {
+            return 0;
+        }
+    }
+    return token == CZJSONArrayEnd ? count : 0;
+}
+
+#pragma mark -
+
+typedef size_t (*cz_decode_fn)(const char *, size_t, cz_chapter *);
+
+static uint64_t cz_bench_decode(cz_decode_fn fn, const char *json, size_t len, cz_chapter *chapters, size_t *result) {
+    uint64_t best = UINT64_MAX;
+
+    for (int run = 0; run < 5; run++) {
+        uint64_t ns = cz_bench_now_ns();
+        *result = fn(json, len, chapters);
+        cz_bench_consume(chapters);
+        ns = cz_bench_now_ns() - ns;
+        best = ns < best ? ns : best;
+    }
+    return best;
+}
+
+static int cz_bench_count(size_t count) {
+    size_t len;
+    char *json = cz_chapter_json(count, &len);
+    cz_chapter *tree = calloc(count, sizeof(cz_chapter));
+    cz_chapter *pull = calloc(count, sizeof(cz_chapter));
+    size_t tokens, tree_count, pull_count;
+
+    uint64_t scan_ns = cz_bench_decode(cz_decode_scan, json, len, NULL, &tokens);
+    uint64_t tree_ns = cz_bench_decode(cz_decode_tree, json, len, tree, &tree_count);
+    uint64_t pull_ns = cz_bench_decode(cz_decode_pull, json, len, pull, &pull_count);
+
+    int failed = tokens == 0 || tree_count != count || pull_count != count ||
+                 memcmp(tree, pull, count * sizeof(cz_chapter)) != 0 ||
+                 pull[0].chapterId != 8167891 || strstr(pull[0].name, "\"\xe4\xb9\x9d\xe6\x9c\x88\"") == NULL;
+
+    if (failed) {
+        printf("  %zu chapters: tree and pull results differ\n", count);
+    } else {
+        printf("  %6zu chapters (%5.1f MB)  scan %7.1f MB/s  tree %8.2f ms  pull %8.2f ms  %.1fx\n",
+               count, (double)len / (1 << 20), cz_bench_mbps(len, scan_ns), tree_ns / 1e6, pull_ns / 1e6,
+               (double)tree_ns / (double)pull_ns);
+    }
+
+    free(json);
+    free(tree);
+    free(pull);
+    return failed;
+}
+
+int main(int argc, char *argv[]) {
+    int failed = 0;
+
+    // 模型的属性名在创建映射表时登记
+    for (int k = 0; k < CZ_KEY_COUNT; k++) {
+        cz_key_atoms[k] = cz_atom_intern(cz_key_names[k], strlen(cz_key_names[k]));
+    }
+
+    printf("bench_json\n");
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            failed |= cz_bench_count((size_t)strtoul(argv[i], NULL, 10));
+        }
+    } else {
+        failed |= cz_bench_count(1700);
+        failed |= cz_bench_count(17000);
+    }
+
+    return failed;
+}
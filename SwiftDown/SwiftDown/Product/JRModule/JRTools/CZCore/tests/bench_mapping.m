@@ -0,0 +1,73 @@
+//
+//  bench_mapping.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 章节目录字典转模型 (只在 macOS 上编译)
+///
+///     bench_mapping [章节数 ...]
+///
+/// - legacy:  原来的 cz_objectsWithArray:，[list containsObject:key] + setValue:forKey:
+/// - mapping: CZClassMapping，散列查找属性、缓存的 setter IMP、数值直接写成员变量
+///
+/// 默认 1700 章 (一本长篇的目录) 和 17000 章
+
+#import <Foundation/Foundation.h>
+
+#import "cz_test.h"
+#import "bench_chapter.h"
+#import "NSObject+CZRuntime.h"
+
+static void CZBenchCount(NSUInteger count) {
+    NSArray *array = CZBenchChapterDictionaries(count);
+    NSArray *list = [CZBenchChapter cz_propertiesList];
+    uint64_t best[2] = { UINT64_MAX, UINT64_MAX };
+    NSArray *legacy = nil;
+    NSArray *mapped = nil;
+
+    for (int run = 0; run < 5; run++) {
+        @autoreleasepool {
+            uint64_t ns = cz_bench_now_ns();
+            legacy = CZBenchLegacyObjects([CZBenchChapter class], array, list);
+            ns = cz_bench_now_ns() - ns;
+            best[0] = ns < best[0] ? ns : best[0];
+
+            ns = cz_bench_now_ns();
+            mapped = [CZBenchChapter cz_objectsWithArray:array];
+            ns = cz_bench_now_ns() - ns;
+            best[1] = ns < best[1] ? ns : best[1];
+        }
+    }
+
+    // 两种方式的结果一致
+    for (NSUInteger i = 0; i < count; i++) {
+        CZBenchChapter *a = legacy[i];
+        CZBenchChapter *b = mapped[i];
+
+        CZ_CHECK([a.name isEqualToString:b.name] && a.wordCount == b.wordCount && a.status == b.status,
+                 "chapter %lu differs", (unsigned long)i);
+        CZ_CHECK(b.key == nil, "chapter %lu: NSNull should map to nil", (unsigned long)i);
+    }
+
+    printf("  %6lu chapters  legacy %8.2f ms  mapping %8.2f ms  %.1fx\n", (unsigned long)count,
+           best[0] / 1e6, best[1] / 1e6, (double)best[0] / (double)best[1]);
+}
+
+int main(int argc, char *argv[]) {
+    @autoreleasepool {
+        printf("bench_mapping\n");
+
+        if (argc > 1) {
+            for (int i = 1; i < argc; i++) {
+                CZBenchCount((NSUInteger)strtoul(argv[i], NULL, 10));
+            }
+        } else {
+            CZBenchCount(1700);
+            CZBenchCount(17000);
+        }
+    }
+    return cz_test_finish("bench_mapping");
+}
@@ -0,0 +1,70 @@
+//
+//  bench_parallel_mapping.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 多核并行字典转模型的扩展性 (只在 macOS 上编译)
+///
+///     bench_parallel_mapping [章节数]
+///
+/// GCD 不能限制 dispatch_apply 使用的线程数，这里改为控制分段数：
+/// 1 段即在当前线程创建，分段数为 2、4 ... 时最多只有这么多线程同时工作，
+/// 直到超过核心数。最后一行是 grainSize 为 0 的自动分段
+///
+/// 每次都检查结果的顺序与字典数组相同
+
+#import <Foundation/Foundation.h>
+
+#import "cz_test.h"
+#import "bench_chapter.h"
+#import "NSObject+CZRuntime.h"
+
+static uint64_t CZBenchMapping(NSArray *array, NSUInteger grainSize) {
+    uint64_t best = UINT64_MAX;
+
+    for (int run = 0; run < 5; run++) {
+        @autoreleasepool {
+            uint64_t ns = cz_bench_now_ns();
+            NSArray *objects = [CZBenchChapter cz_objectsWithArray:array grainSize:grainSize];
+            ns = cz_bench_now_ns() - ns;
+            best = ns < best ? ns : best;
+
+            CZ_CHECK(objects.count == array.count, "grain %lu: count", (unsigned long)grainSize);
+            for (NSUInteger i = 0; i < objects.count; i++) {
+                CZBenchChapter *chapter = objects[i];
+                if (![chapter.chapterId isEqualToString:[array[i][@"chapterId"] description]]) {
+                    CZ_CHECK(0, "grain %lu: object %lu out of order", (unsigned long)grainSize, (unsigned long)i);
+                    break;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    @autoreleasepool {
+        NSUInteger count = argc > 1 ? (NSUInteger)strtoul(argv[1], NULL, 10) : 100000;
+        NSUInteger cores = [NSProcessInfo processInfo].activeProcessorCount;
+        NSArray *array = CZBenchChapterDictionaries(count);
+
+        printf("bench_parallel_mapping (%lu chapters, %lu cores)\n", (unsigned long)count, (unsigned long)cores);
+
+        uint64_t serial = CZBenchMapping(array, count);
+        printf("  %4d chunk   %8.2f ms\n", 1, serial / 1e6);
+
+        for (NSUInteger chunks = 2; chunks <= cores * 4; chunks *= 2) {
+            NSUInteger grainSize = (count + chunks - 1) / chunks;
+            uint64_t ns = CZBenchMapping(array, grainSize);
+
+            printf("  %4lu chunks  %8.2f ms  %.2fx\n", (unsigned long)chunks, ns / 1e6, (double)serial / (double)ns);
+        }
+
+        uint64_t automatic = CZBenchMapping(array, 0);
+        printf("  auto         %8.2f ms  %.2fx\n", automatic / 1e6, (double)serial / (double)automatic);
+    }
+    return cz_test_finish("bench_parallel_mapping");
+}
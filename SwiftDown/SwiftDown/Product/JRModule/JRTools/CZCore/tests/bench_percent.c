@@ -0,0 +1,161 @@
+//
+//  bench_percent.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 百分号编解码与逐字节实现对比
+///
+///     bench_percent [次数]
+///
+/// - byte:       原来 addingPercentEncoding(withAllowedCharacters: .urlQueryAllowed) /
+///               removingPercentEncoding 的做法，逐字节查字符集，转义用 "%%%02X" 格式化。
+///               这里写进 char 缓冲区，不含 String 桥接的开销，实际的差距只会更大
+/// - cz_percent: cz_percent_encode / cz_percent_decode
+///
+/// 输入是请求参数常见的几种值：纯 ASCII 的 ID、中文书名、混合的搜索词、长 URL 和随机字节。
+/// Makefile 在 x86 上还会用 -mssse3 编译一份 (bench_percent_ssse3)
+
+#include "cz_test.h"
+#include "cz_percent.h"
+
+/// URLQueryAllowedCharacterSet
+static const char *cz_allowed = "!$&'()*+,-./:;=?@_~"
+                                "0123456789"
+                                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                "abcdefghijklmnopqrstuvwxyz";
+
+static size_t cz_byte_encode(const uint8_t *bytes, size_t len, char *out) {
+    size_t k = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (bytes[i] != 0 && strchr(cz_allowed, bytes[i]) != NULL) {
+            out[k++] = (char)bytes[i];
+        } else {
+            snprintf(out + k, 4, "%%%02X", bytes[i]);
+            k += 3;
+        }
+    }
+    return k;
+}
+
+static size_t cz_byte_decode(const char *str, size_t len, uint8_t *out) {
+    size_t k = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (str[i] != '%') {
+            out[k++] = (uint8_t)str[i];
+            continue;
+        }
+        if (i + 2 >= len) {
+            return (size_t)-1;
+        }
+        if (sscanf(str + i + 1, "%2hhx", &out[k]) != 1) {
+            return (size_t)-1;
+        }
+        k++;
+        i += 2;
+    }
+    return k;
+}
+
+typedef size_t (*cz_encode_fn)(const uint8_t *, size_t, char *);
+typedef size_t (*cz_decode_fn)(const char *, size_t, uint8_t *);
+
+static double cz_bench_encode(cz_encode_fn fn, const uint8_t *in, size_t len, char *out, size_t count) {
+    uint64_t best = UINT64_MAX;
+
+    for (int run = 0; run < 5; run++) {
+        uint64_t ns = cz_bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            fn(in, len, out);
+            cz_bench_consume(out);
+        }
+        ns = cz_bench_now_ns() - ns;
+        best = ns < best ? ns : best;
+    }
+    return (double)best / (double)count;
+}
+
+static double cz_bench_decode(cz_decode_fn fn, const char *in, size_t len, uint8_t *out, size_t count) {
+    uint64_t best = UINT64_MAX;
+
+    for (int run = 0; run < 5; run++) {
+        uint64_t ns = cz_bench_now_ns();
+        for (size_t i = 0; i < count; i++) {
+            fn(in, len, out);
+            cz_bench_consume(out);
+        }
+        ns = cz_bench_now_ns() - ns;
+        best = ns < best ? ns : best;
+    }
+    return (double)best / (double)count;
+}
+
+int main(int argc, char *argv[]) {
+    size_t count = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 20000;
+
+    static char url[4096];
+    static uint8_t random[4096];
+    size_t url_len = 0;
+
+    // 长 URL：路径和参数都不需要编码，偶尔夹一个空格
+    while (url_len + 64 < sizeof(url)) {
+        url_len += (size_t)snprintf(url + url_len, sizeof(url) - url_len,
+                                    "/book/479435/chapter/%zu?page=1&pageSize=20 ", url_len);
+    }
+    cz_test_fill(random, sizeof(random), 1);
+
+    const struct {
+        const char    *name;
+        const uint8_t *bytes;
+        size_t         len;
+    } inputs[] = {
+        { "id",      (const uint8_t *)"5d9252cd8cf00290e07c0618ae143e5869280f5f", 40 },
+        { "title",   (const uint8_t *)"\xe6\x96\x97\xe7\xa0\xb4\xe8\x8b\x8d\xe7\xa9\xb9", 12 },
+        { "keyword", (const uint8_t *)"\xe6\x96\x97\xe7\xa0\xb4 \xe8\x8b\x8d\xe7\xa9\xb9 chapter 1", 24 },
+        { "url",     (const uint8_t *)url, url_len },
+        { "random",  random, sizeof(random) },
+    };
+
+    static char expected[CZ_PERCENT_ENCODED_MAX_LENGTH(4096)];
+    static char encoded[CZ_PERCENT_ENCODED_MAX_LENGTH(4096)];
+    static uint8_t decoded[4096];
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    printf("bench_percent (neon, %zu iterations)\n", count);
+#elif defined(__SSSE3__)
+    printf("bench_percent (ssse3, %zu iterations)\n", count);
+#else
+    printf("bench_percent (scalar, %zu iterations)\n", count);
+#endif
+
+    for (size_t k = 0; k < sizeof(inputs) / sizeof(inputs[0]); k++) {
+        const uint8_t *bytes = inputs[k].bytes;
+        size_t len = inputs[k].len;
+        size_t n = len > 64 ? count / 64 : count;
+
+        size_t expected_len = cz_byte_encode(bytes, len, expected);
+        size_t encoded_len = cz_percent_encode(bytes, len, encoded);
+        if (encoded_len != expected_len || memcmp(encoded, expected, expected_len) != 0 ||
+            cz_percent_decode(encoded, encoded_len, decoded) != len || memcmp(decoded, bytes, len) != 0 ||
+            cz_byte_decode(expected, expected_len, decoded) != len || memcmp(decoded, bytes, len) != 0) {
+            printf("  %s: cz_percent differs from byte loop\n", inputs[k].name);
+            return 1;
+        }
+
+        double byte = cz_bench_encode(cz_byte_encode, bytes, len, encoded, n);
+        double table = cz_bench_encode(cz_percent_encode, bytes, len, encoded, n);
+        printf("  encode %-7s %4zu B  byte %9.1f ns  cz_percent %8.1f ns  %6.1fx\n",
+               inputs[k].name, len, byte, table, byte / table);
+
+        byte = cz_bench_decode(cz_byte_decode, expected, expected_len, decoded, n);
+        table = cz_bench_decode(cz_percent_decode, expected, expected_len, decoded, n);
+        printf("  decode %-7s %4zu B  byte %9.1f ns  cz_percent %8.1f ns  %6.1fx\n",
+               inputs[k].name, expected_len, byte, table, byte / table);
+    }
+
+    return 0;
+}
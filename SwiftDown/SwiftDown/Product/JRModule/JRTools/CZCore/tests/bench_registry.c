@@ -0,0 +1,223 @@
+//
+//  bench_registry.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_registry 多线程压力测试
+///
+///     bench_registry [每线程查找次数]
+///
+/// 1. 抢占发布：所有线程同时发布同一批 key，每个 key 所有线程拿到的都必须是同一个值
+/// 2. 读多写少：线程数从 1 增加到核心数的 2 倍 (至少 8)，每个线程随机查找已有的类，
+///    偶尔发布新的类；与每次查找都加互斥锁 (相当于原来 objc_setAssociatedObject
+///    的全局锁) 对比吞吐
+///
+/// 结果不一致时返回 1
+
+#include "cz_test.h"
+#include "cz_registry.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define CZ_MAX_THREADS  64
+#define CZ_KEYS         512     // 启动时已发布的类
+#define CZ_NEW_KEYS     4096    // 测试过程中发布的新类
+
+/// 充当 Class 指针的地址
+static char cz_keys[CZ_KEYS + CZ_NEW_KEYS];
+
+static int cz_go;
+static int cz_ready;
+
+static void cz_wait_start(void) {
+    __atomic_add_fetch(&cz_ready, 1, __ATOMIC_ACQ_REL);
+    while (!__atomic_load_n(&cz_go, __ATOMIC_ACQUIRE)) {
+    }
+}
+
+static void cz_start(int threads) {
+    while (__atomic_load_n(&cz_ready, __ATOMIC_ACQUIRE) < threads) {
+    }
+    __atomic_store_n(&cz_go, 1, __ATOMIC_RELEASE);
+}
+
+static void cz_reset(void) {
+    cz_ready = 0;
+    cz_go = 0;
+}
+
+#pragma mark - 抢占发布
+
+typedef struct {
+    cz_registry *registry;
+    int          index;
+    const void  *results[CZ_KEYS];
+} cz_race_arg;
+
+static void *cz_race_thread(void *p) {
+    cz_race_arg *arg = p;
+    // 每个线程发布自己的值，用 key + 线程序号区分
+    static char values[CZ_MAX_THREADS][CZ_KEYS];
+
+    cz_wait_start();
+    for (int k = 0; k < CZ_KEYS; k++) {
+        arg->results[k] = cz_registry_publish(arg->registry, &cz_keys[k], &values[arg->index][k]);
+    }
+    return NULL;
+}
+
+static int cz_check_race(int threads) {
+    cz_registry *registry = cz_registry_create(CZ_KEYS);
+    pthread_t tids[CZ_MAX_THREADS];
+    cz_race_arg *args = calloc((size_t)threads, sizeof(cz_race_arg));
+    int failed = 0;
+
+    cz_reset();
+    for (int t = 0; t < threads; t++) {
+        args[t].registry = registry;
+        args[t].index = t;
+        pthread_create(&tids[t], NULL, cz_race_thread, &args[t]);
+    }
+    cz_start(threads);
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+
+    for (int k = 0; k < CZ_KEYS; k++) {
+        const void *stored = cz_registry_get(registry, &cz_keys[k]);
+
+        for (int t = 0; t < threads; t++) {
+            if (args[t].results[k] == NULL || args[t].results[k] != stored) {
+                failed = 1;
+            }
+        }
+    }
+    if (cz_registry_count(registry) != CZ_KEYS) {
+        failed = 1;
+    }
+
+    free(args);
+    return failed;
+}
+
+#pragma mark - 读多写少
+
+typedef struct {
+    cz_registry     *registry;
+    pthread_mutex_t *lock;      // 非 NULL 时每次查找都加锁
+    size_t           lookups;
+    int              index;
+    int              failed;
+} cz_read_arg;
+
+/// 第 k 个 key 的值，所有线程发布相同的值，方便检查
+static const void *cz_value_for(int k) {
+    return &cz_keys[k] + 1;
+}
+
+static int cz_next_key;
+
+static void *cz_read_thread(void *p) {
+    cz_read_arg *arg = p;
+    uint64_t state = (uint64_t)arg->index * 0x9e3779b97f4a7c15ULL + 1;
+
+    cz_wait_start();
+    for (size_t i = 0; i < arg->lookups; i++) {
+        uint64_t r = cz_test_random(&state);
+        int k = (int)(r % CZ_KEYS);
+
+        // 每 1024 次查找遇到一个新类：查不到时发布
+        if ((r >> 32) % 1024 == 0) {
+            int next = __atomic_fetch_add(&cz_next_key, 1, __ATOMIC_RELAXED);
+            if (next < CZ_NEW_KEYS) {
+                k = CZ_KEYS + next;
+            }
+        }
+
+        const void *value;
+        if (arg->lock != NULL) {
+            pthread_mutex_lock(arg->lock);
+            value = cz_registry_get(arg->registry, &cz_keys[k]);
+            if (value == NULL) {
+                value = cz_registry_publish(arg->registry, &cz_keys[k], cz_value_for(k));
+            }
+            pthread_mutex_unlock(arg->lock);
+        } else {
+            value = cz_registry_get(arg->registry, &cz_keys[k]);
+            if (value == NULL) {
+                value = cz_registry_publish(arg->registry, &cz_keys[k], cz_value_for(k));
+            }
+        }
+
+        if (value != cz_value_for(k)) {
+            arg->failed = 1;
+        }
+    }
+    return NULL;
+}
+
+static double cz_bench_reads(int threads, size_t lookups, int locked, int *failed) {
+    cz_registry *registry = cz_registry_create(CZ_KEYS + CZ_NEW_KEYS);
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t tids[CZ_MAX_THREADS];
+    cz_read_arg args[CZ_MAX_THREADS];
+
+    for (int k = 0; k < CZ_KEYS; k++) {
+        cz_registry_publish(registry, &cz_keys[k], cz_value_for(k));
+    }
+
+    cz_reset();
+    cz_next_key = 0;
+    for (int t = 0; t < threads; t++) {
+        args[t] = (cz_read_arg){ registry, locked ? &lock : NULL, lookups, t, 0 };
+        pthread_create(&tids[t], NULL, cz_read_thread, &args[t]);
+    }
+
+    cz_start(threads);
+    uint64_t ns = cz_bench_now_ns();
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        *failed |= args[t].failed;
+    }
+    ns = cz_bench_now_ns() - ns;
+
+    // 注册表只增不减，每次新建；这里有意不释放
+    return (double)lookups * threads * 1000.0 / (double)ns;
+}
+
+int main(int argc, char *argv[]) {
+    size_t lookups = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 2000000;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    // 核心很少时也至少用 8 个线程，让抢占发布有机会交错
+    long wanted = cores * 2 > 8 ? cores * 2 : 8;
+    int max_threads = (int)(wanted < CZ_MAX_THREADS ? wanted : CZ_MAX_THREADS);
+    int failed = 0;
+
+    printf("bench_registry (%ld cores)\n", cores);
+
+    for (int threads = 2; threads <= max_threads; threads *= 2) {
+        int race = 0;
+        for (int round = 0; round < 20; round++) {
+            race |= cz_check_race(threads);
+        }
+        printf("  publish race, %2d threads x 20: %s\n", threads, race ? "FAILED" : "ok");
+        failed |= race;
+    }
+
+    printf("lookups, million per second (all threads)\n");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double lock_free = cz_bench_reads(threads, lookups, 0, &failed);
+        double locked = cz_bench_reads(threads, lookups / 4, 1, &failed);
+
+        printf("  %2d threads  registry %8.1f  mutex %7.1f  %.1fx\n", threads, lock_free, locked, lock_free / locked);
+    }
+
+    if (failed) {
+        printf("bench_registry: inconsistent results\n");
+    }
+    return failed;
+}
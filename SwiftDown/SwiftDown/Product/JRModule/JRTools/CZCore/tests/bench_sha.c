@@ -0,0 +1,134 @@
+//
+//  bench_sha.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_sha 各个实现的每字节周期数，与 CommonCrypto (Linux 上为 OpenSSL) 对比
+///
+///     bench_sha [scalar|shani|armv8 ...]
+///
+/// 不带参数时测试当前平台可用的所有实现；x86 上周期数来自 TSC，其他平台只输出 MB/s
+
+#include "cz_test.h"
+#include "cz_sha.h"
+
+#include <CommonCrypto/CommonCrypto.h>
+
+static const char *cz_kernel_names[CZSHAKernelCount] = { "auto", "scalar", "shani", "armv8" };
+
+static const size_t cz_lengths[] = { 64, 256, 1024, 8192, 1 << 20 };
+
+/// 每个长度大约处理的总字节数
+#define CZ_BENCH_BYTES  (16u << 20)
+
+typedef void (*cz_hash_fn)(const void *data, size_t len, uint8_t *out);
+
+static void cz_cc_sha1(const void *data, size_t len, uint8_t *out) {
+    CC_SHA1(data, (CC_LONG)len, out);
+}
+
+static void cz_cc_sha256(const void *data, size_t len, uint8_t *out) {
+    CC_SHA256(data, (CC_LONG)len, out);
+}
+
+static void cz_bench_sha1(const void *data, size_t len, uint8_t *out) {
+    cz_sha1(data, len, out);
+}
+
+static void cz_bench_sha256(const void *data, size_t len, uint8_t *out) {
+    cz_sha256(data, len, out);
+}
+
+/// 三次取最好的结果
+static void cz_bench_hash(const char *name, cz_hash_fn fn, const uint8_t *data) {
+    printf("  %-22s", name);
+
+    for (size_t l = 0; l < sizeof(cz_lengths) / sizeof(cz_lengths[0]); l++) {
+        size_t len = cz_lengths[l];
+        size_t iterations = CZ_BENCH_BYTES / len;
+        uint8_t digest[CZ_SHA256_DIGEST_LENGTH];
+
+        uint64_t best_ns = UINT64_MAX;
+        uint64_t best_cycles = UINT64_MAX;
+
+        for (int run = 0; run < 3; run++) {
+            uint64_t ns = cz_bench_now_ns();
+            uint64_t cycles = cz_bench_cycles();
+
+            for (size_t i = 0; i < iterations; i++) {
+                fn(data, len, digest);
+                cz_bench_consume(digest);
+            }
+
+            cycles = cz_bench_cycles() - cycles;
+            ns = cz_bench_now_ns() - ns;
+
+            if (ns < best_ns) {
+                best_ns = ns;
+                best_cycles = cycles;
+            }
+        }
+
+        uint64_t bytes = (uint64_t)iterations * len;
+        if (best_cycles != 0) {
+            printf("  %7zu: %5.2f cpb", len, (double)best_cycles / (double)bytes);
+        } else {
+            printf("  %7zu: %7.1f MB/s", len, cz_bench_mbps(bytes, best_ns));
+        }
+    }
+    printf("\n");
+}
+
+static void cz_bench_kernel(CZSHAKernel kernel, const uint8_t *data) {
+    if (cz_sha_set_kernel(kernel) != 0) {
+        printf("%s: not available\n", cz_kernel_names[kernel]);
+        return;
+    }
+
+    char name[32];
+
+    snprintf(name, sizeof(name), "sha1 %s", cz_kernel_names[kernel]);
+    cz_bench_hash(name, cz_bench_sha1, data);
+
+    snprintf(name, sizeof(name), "sha256 %s", cz_kernel_names[kernel]);
+    cz_bench_hash(name, cz_bench_sha256, data);
+}
+
+int main(int argc, char *argv[]) {
+    uint8_t *data = malloc(1 << 20);
+    cz_test_fill(data, 1 << 20, 1);
+
+    printf("bench_sha (auto kernel: %s)\n", cz_sha_kernel_name());
+
+    cz_bench_hash("sha1 CommonCrypto", cz_cc_sha1, data);
+    cz_bench_hash("sha256 CommonCrypto", cz_cc_sha256, data);
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            int found = 0;
+            for (int kernel = CZSHAKernelScalar; kernel < CZSHAKernelCount; kernel++) {
+                if (strcmp(argv[i], cz_kernel_names[kernel]) == 0) {
+                    cz_bench_kernel((CZSHAKernel)kernel, data);
+                    found = 1;
+                }
+            }
+            if (!found) {
+                fprintf(stderr, "unknown kernel %s (scalar, shani, armv8)\n", argv[i]);
+            }
+        }
+    } else {
+        for (int kernel = CZSHAKernelScalar; kernel < CZSHAKernelCount; kernel++) {
+            if (cz_sha_kernel_available((CZSHAKernel)kernel)) {
+                cz_bench_kernel((CZSHAKernel)kernel, data);
+            }
+        }
+    }
+
+    cz_sha_set_kernel(CZSHAKernelAuto);
+    free(data);
+
+    return 0;
+}
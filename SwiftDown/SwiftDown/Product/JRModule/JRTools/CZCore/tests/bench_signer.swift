@@ -0,0 +1,127 @@
+//
+//  bench_signer.swift
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 每个请求拼接签名字符串的耗时 (只在 macOS 上编译)
+///
+///     bench_signer [请求数]
+///
+/// - legacy: 原来的做法，每次重建公共参数字典、合并请求参数、全部排序，
+///           每个 key 一次 String(format:)
+/// - signer: JRParamSigner.signingString，公共片段预先排好序，只归并请求参数
+///
+/// encryptSign 在未提交的 JRIgnoreFile 中，两种方式的加密开销相同，这里只比较加密前的部分。
+/// 下面的 JRIgnoreFile / JRNetWorkURL 只是让 JRParamSigner.swift 单独编译的替身
+
+import Foundation
+
+enum JRIgnoreFile {
+	static func encryptSign(sign: String) -> String {
+		return sign
+	}
+}
+
+class JRNetWorkURL: NSObject {
+
+	/// 与 JRNetWorkURL.swift 中的公共上行参数相同
+	static func publicUpwardConcatenation() -> [String : Any] {
+
+		var publicUpwardDict: [String:String] = [:];
+
+		publicUpwardDict["channelType"]		= "AppStore"
+		publicUpwardDict["channelId"]		= "0"
+		publicUpwardDict["installId"]		= "5d9252cd8cf00290e07c0618ae143e5869280f5f"
+		publicUpwardDict["modelName"]		= "iPhoneSimulator"
+		publicUpwardDict["brand"]			= "Apple"
+		publicUpwardDict["model"]			= "iPhoneSimulator"
+		publicUpwardDict["os"]				= "ios"
+		publicUpwardDict["osVersion"]		= "9.3"
+		publicUpwardDict["clientVersion"]	= "4.0.0"
+		publicUpwardDict["screenW"]			= "1242"
+		publicUpwardDict["screenH"]			= "2208"
+		publicUpwardDict["userId"]			= "10"
+		publicUpwardDict["appId"]			= "ZHKXS"
+		publicUpwardDict["api_key"]			= "27A28A4D4B24022E543E"
+
+		return publicUpwardDict
+	}
+}
+
+/// 原来 getPublicParam + getParamSign 的签名部分
+func legacySigningString(param: [String : Any]) -> String {
+
+	var mParam = JRNetWorkURL.publicUpwardConcatenation()
+	for (k, v) in param {
+		mParam.updateValue(v, forKey: k)
+	}
+
+	var sign: String = String()
+	let keys: Array = mParam.keys.sorted(by: {$0 < $1})
+
+	for i in 0..<keys.count {
+		let key = keys[i]
+		if(i == 0){
+			sign.append(String(format: "%@=%@", key, mParam[key]! as! String))
+		}else{
+			sign.append(String(format: "&%@=%@", key, mParam[key]! as! String))
+		}
+	}
+	return sign
+}
+
+@main
+enum BenchSigner {
+
+	static func measure(_ count: Int, _ body: (Int) -> String) -> Double {
+		var best = UInt64.max
+
+		for _ in 0..<5 {
+			let start = DispatchTime.now().uptimeNanoseconds
+			var length = 0
+			for i in 0..<count {
+				length += body(i).utf8.count
+			}
+			let ns = DispatchTime.now().uptimeNanoseconds - start
+			best = min(best, ns)
+			precondition(length > 0)
+		}
+		return Double(best) / Double(count)
+	}
+
+	static func main() {
+		let count = CommandLine.arguments.count > 1 ? Int(CommandLine.arguments[1]) ?? 20000 : 20000
+		let signer = JRParamSigner(publicParam: JRNetWorkURL.publicUpwardConcatenation())
+
+		/// 常见请求：章节内容、书架分页、覆盖公共参数的 userId
+		let requests: [[String : Any]] = [
+			["bookId": "479435", "chapterId": "8167891"],
+			["page": "1", "pageSize": "20", "type": "shelf"],
+			["userId": "20481", "bookId": "479435", "sort": "desc"],
+			[:],
+		]
+
+		var failed = false
+		for param in requests {
+			if signer.signingString(requestParam: param) != legacySigningString(param: param) {
+				print("signing string differs for \(param)")
+				failed = true
+			}
+		}
+
+		print("bench_signer (\(count) requests, ns/request)")
+
+		for (index, param) in requests.enumerated() {
+			let legacyTime = measure(count) { _ in legacySigningString(param: param) }
+			let signerTime = measure(count) { _ in signer.signingString(requestParam: param) }
+
+			print(String(format: "  request %d (%d keys)  legacy %8.0f  signer %7.0f  %.1fx",
+			             index, param.count, legacyTime, signerTime, legacyTime / signerTime))
+		}
+
+		exit(failed ? 1 : 0)
+	}
+}
@@ -0,0 +1,60 @@
+//
+//  CommonCrypto.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 在 Linux 上编译测试时代替 <CommonCrypto/CommonCrypto.h>，
+/// 只映射 CZCore 用到的 CC_* 接口到 OpenSSL
+
+#ifndef cz_compat_CommonCrypto_h
+#define cz_compat_CommonCrypto_h
+
+#define OPENSSL_SUPPRESS_DEPRECATED
+
+#include <openssl/md5.h>
+#include <openssl/sha.h>
+
+typedef unsigned int CC_LONG;
+
+typedef MD5_CTX    CC_MD5_CTX;
+typedef SHA_CTX    CC_SHA1_CTX;
+typedef SHA256_CTX CC_SHA256_CTX;
+typedef SHA512_CTX CC_SHA512_CTX;
+
+#define CC_MD5_DIGEST_LENGTH        16
+#define CC_SHA1_DIGEST_LENGTH       20
+#define CC_SHA224_DIGEST_LENGTH     28
+#define CC_SHA256_DIGEST_LENGTH     32
+#define CC_SHA384_DIGEST_LENGTH     48
+#define CC_SHA512_DIGEST_LENGTH     64
+
+#define CC_MD5_BLOCK_BYTES          64
+#define CC_SHA1_BLOCK_BYTES         64
+#define CC_SHA256_BLOCK_BYTES       64
+#define CC_SHA512_BLOCK_BYTES       128
+
+#define CC_MD5_Init         MD5_Init
+#define CC_MD5_Update       MD5_Update
+#define CC_MD5_Final        MD5_Final
+#define CC_SHA1_Init        SHA1_Init
+#define CC_SHA1_Update      SHA1_Update
+#define CC_SHA1_Final       SHA1_Final
+#define CC_SHA256_Init      SHA256_Init
+#define CC_SHA256_Update    SHA256_Update
+#define CC_SHA256_Final     SHA256_Final
+#define CC_SHA384_Init      SHA384_Init
+#define CC_SHA384_Update    SHA384_Update
+#define CC_SHA384_Final     SHA384_Final
+#define CC_SHA512_Init      SHA512_Init
+#define CC_SHA512_Update    SHA512_Update
+#define CC_SHA512_Final     SHA512_Final
+
+#define CC_MD5              MD5
+#define CC_SHA1             SHA1
+#define CC_SHA256           SHA256
+#define CC_SHA512           SHA512
+
+#endif /* cz_compat_CommonCrypto_h */
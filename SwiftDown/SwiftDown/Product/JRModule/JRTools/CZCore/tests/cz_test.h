@@ -0,0 +1,110 @@
+//
+//  cz_test.h
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// CZCore 测试、性能测试共用的小工具，只在 tests 目录中使用
+
+#ifndef cz_test_h
+#define cz_test_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#pragma mark - 断言
+
+static int cz_test_failures = 0;
+
+/// 条件不成立时打印位置和信息，继续执行后面的检查
+#define CZ_CHECK(cond, ...) do {                                    \
+    if (!(cond)) {                                                  \
+        fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);             \
+        fprintf(stderr, __VA_ARGS__);                               \
+        fputc('\n', stderr);                                        \
+        cz_test_failures++;                                         \
+    }                                                               \
+} while (0)
+
+/// 打印结果，返回进程退出码
+static inline int cz_test_finish(const char *name) {
+    if (cz_test_failures != 0) {
+        printf("%s: %d failed\n", name, cz_test_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+#pragma mark - 数据
+
+/// 二进制转为小写十六进制，out 至少 2 * len + 1 字节
+static inline void cz_test_hex(const uint8_t *bytes, size_t len, char *out) {
+    static const char digits[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 15];
+    }
+    out[2 * len] = '\0';
+}
+
+/// 可重复的伪随机数 (xorshift64*)
+static inline uint64_t cz_test_random(uint64_t *state) {
+    uint64_t x = *state;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+
+    return x * 0x2545f4914f6cdd1dULL;
+}
+
+/// 用 seed 生成的伪随机字节填充
+static inline void cz_test_fill(uint8_t *bytes, size_t len, uint64_t seed) {
+    uint64_t state = seed | 1;
+
+    for (size_t i = 0; i < len; i++) {
+        bytes[i] = (uint8_t)(cz_test_random(&state) >> 56);
+    }
+}
+
+#pragma mark - 计时
+
+static inline uint64_t cz_bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/// 周期计数，x86 使用 TSC；其他平台返回 0，由调用方改用时间
+static inline uint64_t cz_bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/// 阻止编译器把结果优化掉
+static inline void cz_bench_consume(const void *p) {
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+}
+
+/// 每秒处理的 MB 数
+static inline double cz_bench_mbps(uint64_t bytes, uint64_t ns) {
+    return ns == 0 ? 0 : (double)bytes * 1000.0 / (double)ns;
+}
+
+#endif /* cz_test_h */
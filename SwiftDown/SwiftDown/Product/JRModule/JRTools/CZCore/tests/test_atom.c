@@ -0,0 +1,204 @@
+//
+//  test_atom.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_atom 原子表
+///
+/// 1. 相同的字节得到相同的 ID，不同的字节 (前缀、含 '\0'、空串) 得到不同的 ID；
+///    cz_atom_name 返回登记时的字节
+/// 2. 多个线程同时按不同顺序登记同一组字符串，同时查找，每个字符串只分配一个 ID
+/// 3. 登记到 CZ_ATOM_CAPACITY 个为止，之后返回 CZ_ATOM_NONE，已有的 ID 不变
+///
+/// 原子表是进程内全局的，各项测试按顺序执行，ID 的期望值都相对于开始时的 cz_atom_max()
+
+#include "cz_test.h"
+#include "cz_atom.h"
+
+#include <pthread.h>
+
+static void cz_check_name(cz_atom atom, const char *str, size_t len) {
+    size_t name_len = 0;
+    const char *name = cz_atom_name(atom, &name_len);
+
+    CZ_CHECK(name != NULL && name_len == len && memcmp(name, str, len) == 0 && name[len] == '\0',
+             "name of atom %u", atom);
+}
+
+#pragma mark - 相同与不同
+
+static void cz_test_identity(void) {
+    static const struct { const char *str; size_t len; } keys[] = {
+        { "id", 2 },
+        { "i", 1 },
+        { "id2", 3 },
+        { "ID", 2 },
+        { "", 0 },
+        { "a\0b", 3 },
+        { "a\0c", 3 },
+        { "chapter_name", 12 },
+        { "chapter_name ", 13 },
+    };
+    enum { count = sizeof(keys) / sizeof(keys[0]) };
+    cz_atom atoms[count];
+    cz_atom base = cz_atom_max();
+
+    CZ_CHECK(cz_atom_lookup("id", 2) == CZ_ATOM_NONE, "lookup before intern");
+    CZ_CHECK(cz_atom_name(CZ_ATOM_NONE, NULL) == NULL, "name of CZ_ATOM_NONE");
+    CZ_CHECK(cz_atom_name(base + 1, NULL) == NULL, "name of an unused ID");
+
+    for (size_t i = 0; i < count; i++) {
+        atoms[i] = cz_atom_intern(keys[i].str, keys[i].len);
+        CZ_CHECK(atoms[i] == base + 1 + i, "intern %zu: %u", i, atoms[i]);
+        CZ_CHECK(cz_atom_max() == atoms[i], "max after intern %zu", i);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        // 从另一块内存传入相同的字节
+        char copy[16];
+        memcpy(copy, keys[i].str, keys[i].len);
+
+        CZ_CHECK(cz_atom_intern(copy, keys[i].len) == atoms[i], "intern %zu again", i);
+        CZ_CHECK(cz_atom_lookup(copy, keys[i].len) == atoms[i], "lookup %zu", i);
+        cz_check_name(atoms[i], keys[i].str, keys[i].len);
+    }
+    CZ_CHECK(cz_atom_max() == base + count, "intern again must not allocate");
+
+    // 只比较 len 个字节
+    CZ_CHECK(cz_atom_lookup("idx", 2) == atoms[0], "lookup by length");
+    CZ_CHECK(cz_atom_lookup("id3", 3) == CZ_ATOM_NONE, "lookup missing key");
+}
+
+#pragma mark - 并发
+
+#define CZ_ATOM_TEST_THREADS    8
+#define CZ_ATOM_TEST_KEYS       1000
+
+typedef struct {
+    unsigned  index;
+    cz_atom   atoms[CZ_ATOM_TEST_KEYS];
+    int       lookup_failures;
+} cz_atom_worker;
+
+/// 所有线程创建完后同时开始 (macOS 没有 pthread_barrier)
+static int cz_atom_start;
+
+static size_t cz_atom_key(unsigned i, char *buffer) {
+    return (size_t)snprintf(buffer, 32, "concurrent_key_%u", i);
+}
+
+static void *cz_atom_work(void *arg) {
+    cz_atom_worker *worker = arg;
+    char key[32];
+
+    while (!__atomic_load_n(&cz_atom_start, __ATOMIC_ACQUIRE)) {
+    }
+
+    // 每个线程从不同的位置开始，奇数线程倒序
+    for (unsigned n = 0; n < CZ_ATOM_TEST_KEYS; n++) {
+        unsigned i = (n + worker->index * 97) % CZ_ATOM_TEST_KEYS;
+        if (worker->index & 1) {
+            i = CZ_ATOM_TEST_KEYS - 1 - i;
+        }
+
+        size_t len = cz_atom_key(i, key);
+        worker->atoms[i] = cz_atom_intern(key, len);
+
+        // 刚登记的 ID 对本线程和之前登记的字符串立即可见
+        if (cz_atom_lookup(key, len) != worker->atoms[i]) {
+            worker->lookup_failures++;
+        }
+        unsigned j = (i * 7) % CZ_ATOM_TEST_KEYS;
+        len = cz_atom_key(j, key);
+        cz_atom found = cz_atom_lookup(key, len);
+        if (found != CZ_ATOM_NONE && cz_atom_name(found, NULL) == NULL) {
+            worker->lookup_failures++;
+        }
+    }
+    return NULL;
+}
+
+static void cz_test_concurrent(void) {
+    static cz_atom_worker workers[CZ_ATOM_TEST_THREADS];
+    pthread_t threads[CZ_ATOM_TEST_THREADS];
+    cz_atom base = cz_atom_max();
+
+    for (unsigned t = 0; t < CZ_ATOM_TEST_THREADS; t++) {
+        workers[t].index = t;
+        pthread_create(&threads[t], NULL, cz_atom_work, &workers[t]);
+    }
+    __atomic_store_n(&cz_atom_start, 1, __ATOMIC_RELEASE);
+    for (unsigned t = 0; t < CZ_ATOM_TEST_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    CZ_CHECK(cz_atom_max() == base + CZ_ATOM_TEST_KEYS, "max after concurrent intern: %u", cz_atom_max() - base);
+
+    // 每个字符串一个 ID，所有线程看到的相同，ID 连续且不重复
+    static uint8_t used[CZ_ATOM_TEST_KEYS];
+    char key[32];
+
+    for (unsigned i = 0; i < CZ_ATOM_TEST_KEYS; i++) {
+        cz_atom atom = workers[0].atoms[i];
+        size_t len = cz_atom_key(i, key);
+
+        for (unsigned t = 1; t < CZ_ATOM_TEST_THREADS; t++) {
+            CZ_CHECK(workers[t].atoms[i] == atom, "key %u: thread %u got %u, thread 0 got %u",
+                     i, t, workers[t].atoms[i], atom);
+        }
+        CZ_CHECK(atom > base && atom <= base + CZ_ATOM_TEST_KEYS, "key %u: atom %u out of range", i, atom);
+        if (atom > base && atom <= base + CZ_ATOM_TEST_KEYS) {
+            CZ_CHECK(!used[atom - base - 1], "atom %u assigned twice", atom);
+            used[atom - base - 1] = 1;
+        }
+        CZ_CHECK(cz_atom_lookup(key, len) == atom, "lookup key %u", i);
+        cz_check_name(atom, key, len);
+    }
+
+    for (unsigned t = 0; t < CZ_ATOM_TEST_THREADS; t++) {
+        CZ_CHECK(workers[t].lookup_failures == 0, "thread %u: %d lookup failures", t, workers[t].lookup_failures);
+    }
+}
+
+#pragma mark - 表满
+
+static void cz_test_full(void) {
+    char key[32];
+    cz_atom first = cz_atom_max() + 1;
+
+    for (unsigned i = 0; cz_atom_max() < CZ_ATOM_CAPACITY; i++) {
+        size_t len = (size_t)snprintf(key, sizeof(key), "fill_%u", i);
+        cz_atom atom = cz_atom_intern(key, len);
+
+        if (atom != first + i) {
+            CZ_CHECK(0, "fill %u: %u", i, atom);
+            break;
+        }
+    }
+
+    CZ_CHECK(cz_atom_max() == CZ_ATOM_CAPACITY, "max when full: %u", cz_atom_max());
+    CZ_CHECK(cz_atom_intern("one_more", 8) == CZ_ATOM_NONE, "intern when full");
+    CZ_CHECK(cz_atom_lookup("one_more", 8) == CZ_ATOM_NONE, "lookup rejected key");
+    CZ_CHECK(cz_atom_max() == CZ_ATOM_CAPACITY, "max after rejected intern");
+    CZ_CHECK(cz_atom_name(CZ_ATOM_CAPACITY + 1, NULL) == NULL, "name beyond capacity");
+
+    // 已有的字符串照常登记、查找
+    CZ_CHECK(cz_atom_intern("id", 2) == cz_atom_lookup("id", 2) && cz_atom_lookup("id", 2) != CZ_ATOM_NONE,
+             "existing key when full");
+    size_t len = (size_t)snprintf(key, sizeof(key), "fill_%u", 0u);
+    CZ_CHECK(cz_atom_intern(key, len) == first, "first fill key when full");
+    len = (size_t)snprintf(key, sizeof(key), "fill_%u", CZ_ATOM_CAPACITY - first);
+    CZ_CHECK(cz_atom_lookup(key, len) == CZ_ATOM_CAPACITY, "last fill key when full");
+    cz_check_name(CZ_ATOM_CAPACITY, key, len);
+}
+
+int main(void) {
+    cz_test_identity();
+    cz_test_concurrent();
+    cz_test_full();
+
+    return cz_test_finish("test_atom");
+}
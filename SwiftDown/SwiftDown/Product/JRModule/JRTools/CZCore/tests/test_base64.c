@@ -0,0 +1,311 @@
+//
+//  test_base64.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_base64 一次编解码与流式编解码
+///
+/// 1. RFC 4648 向量，两种字母表，带补位和不带补位
+/// 2. 流式编码、解码在每个位置切成两段，以及按各种块大小分段输入，结果与一次编解码相同；
+///    覆盖 CZ_BASE64_STREAM_CHUNK 输出缓冲区的边界
+/// 3. 不合法的输入：非法字符在每个位置、中间的 '='、补位过多或不足、长度不正确，
+///    流式解码与一次解码的结论相同
+/// 4. 输出函数返回非 0 时停止
+///
+/// Makefile 在 x86 上还会用 -mssse3 编译一份
+
+#include "cz_test.h"
+#include "cz_base64.h"
+
+/// 收集流式输出
+typedef struct {
+    uint8_t *bytes;
+    size_t   len;
+    size_t   cap;
+    size_t   calls;
+    size_t   stop_after;    // 第几次输出之后停止，0 表示不停止
+} cz_collector;
+
+static int cz_collect(void *ctx, const void *bytes, size_t len) {
+    cz_collector *c = ctx;
+
+    CZ_CHECK(len <= CZ_BASE64_STREAM_CHUNK, "sink got %zu bytes", len);
+    CZ_CHECK(c->len + len <= c->cap, "sink overflow");
+    if (c->len + len <= c->cap) {
+        memcpy(c->bytes + c->len, bytes, len);
+        c->len += len;
+    }
+    c->calls++;
+    return c->stop_after != 0 && c->calls >= c->stop_after;
+}
+
+static cz_collector cz_collector_make(void *buffer, size_t cap) {
+    cz_collector c = { buffer, 0, cap, 0, 0 };
+    return c;
+}
+
+#pragma mark - 一次编解码
+
+static void cz_check_vector(const char *plain, const char *encoded, CZBase64Alphabet alphabet, int padding) {
+    char out[64];
+    uint8_t decoded[64];
+    size_t len = strlen(plain);
+    size_t n = cz_base64_encode((const uint8_t *)plain, len, out, alphabet, padding);
+
+    CZ_CHECK(n == strlen(encoded) && memcmp(out, encoded, n) == 0, "encode \"%s\" -> %.*s", plain, (int)n, out);
+
+    size_t decoded_len = 0;
+    CZ_CHECK(cz_base64_decode(encoded, strlen(encoded), decoded, &decoded_len, alphabet) == 0 &&
+             decoded_len == len && memcmp(decoded, plain, len) == 0, "decode %s", encoded);
+}
+
+static void cz_test_vectors(void) {
+    static const char *vectors[][3] = {
+        { "",       "",         ""         },
+        { "f",      "Zg==",     "Zg"       },
+        { "fo",     "Zm8=",     "Zm8"      },
+        { "foo",    "Zm9v",     "Zm9v"     },
+        { "foob",   "Zm9vYg==", "Zm9vYg"   },
+        { "fooba",  "Zm9vYmE=", "Zm9vYmE"  },
+        { "foobar", "Zm9vYmFy", "Zm9vYmFy" },
+    };
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        cz_check_vector(vectors[i][0], vectors[i][1], CZBase64Standard, 1);
+        cz_check_vector(vectors[i][0], vectors[i][2], CZBase64Standard, 0);
+    }
+
+    // 62、63 在两种字母表中不同
+    cz_check_vector("\xfb\xff\xbf", "+/+/", CZBase64Standard, 1);
+    cz_check_vector("\xfb\xff\xbf", "-_-_", CZBase64URLSafe, 1);
+    cz_check_vector("\xfb\xff", "-_8", CZBase64URLSafe, 0);
+}
+
+#pragma mark - 流式编码
+
+/// 按 splits 切开的若干段流式编码
+static size_t cz_stream_encode(const uint8_t *bytes, size_t len, const size_t *splits, size_t nsplits,
+                               char *out, size_t cap, CZBase64Alphabet alphabet, int padding) {
+    cz_base64_encoder enc;
+    cz_collector c = cz_collector_make(out, cap);
+    size_t pos = 0;
+
+    cz_base64_encoder_init(&enc, alphabet, padding, cz_collect, &c);
+    for (size_t i = 0; i <= nsplits; i++) {
+        size_t end = i < nsplits ? splits[i] : len;
+        CZ_CHECK(cz_base64_encoder_update(&enc, bytes + pos, end - pos) == 0, "encoder update");
+        pos = end;
+    }
+    CZ_CHECK(cz_base64_encoder_final(&enc) == 0, "encoder final");
+
+    return c.len;
+}
+
+/// 按 splits 切开的若干段流式解码，返回值与 cz_base64_decode 相同
+static int cz_stream_decode(const char *chars, size_t len, const size_t *splits, size_t nsplits,
+                            uint8_t *out, size_t cap, size_t *out_len, CZBase64Alphabet alphabet) {
+    cz_base64_decoder dec;
+    cz_collector c = cz_collector_make(out, cap);
+    size_t pos = 0;
+
+    cz_base64_decoder_init(&dec, alphabet, cz_collect, &c);
+    for (size_t i = 0; i <= nsplits; i++) {
+        size_t end = i < nsplits ? splits[i] : len;
+        if (cz_base64_decoder_update(&dec, chars + pos, end - pos) != 0) {
+            return -1;
+        }
+        pos = end;
+    }
+    if (cz_base64_decoder_final(&dec) != 0) {
+        return -1;
+    }
+
+    *out_len = c.len;
+    return 0;
+}
+
+/// 编码、解码都在每个位置切成两段
+static void cz_test_every_split(size_t len, int padding) {
+    static uint8_t bytes[400];
+    static char expected[CZ_BASE64_ENCODED_LENGTH(400)];
+    static char encoded[CZ_BASE64_ENCODED_LENGTH(400)];
+    static uint8_t decoded[400];
+
+    cz_test_fill(bytes, len, len + 1);
+    size_t expected_len = cz_base64_encode(bytes, len, expected, CZBase64Standard, padding);
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        size_t n = cz_stream_encode(bytes, len, &cut, 1, encoded, sizeof(encoded), CZBase64Standard, padding);
+        CZ_CHECK(n == expected_len && memcmp(encoded, expected, n) == 0,
+                 "encode %zu bytes (padding %d) split at %zu", len, padding, cut);
+    }
+
+    for (size_t cut = 0; cut <= expected_len; cut++) {
+        size_t n = 0;
+        int ret = cz_stream_decode(expected, expected_len, &cut, 1, decoded, sizeof(decoded), &n, CZBase64Standard);
+        CZ_CHECK(ret == 0 && n == len && memcmp(decoded, bytes, len) == 0,
+                 "decode %zu chars (padding %d) split at %zu", expected_len, padding, cut);
+    }
+}
+
+/// 较长的数据按固定块大小分段，跨过输出缓冲区的边界
+static void cz_test_chunked(size_t len, CZBase64Alphabet alphabet, int padding) {
+    static uint8_t bytes[3 * CZ_BASE64_STREAM_CHUNK + 2];
+    static char expected[CZ_BASE64_ENCODED_LENGTH(sizeof(bytes))];
+    static char encoded[CZ_BASE64_ENCODED_LENGTH(sizeof(bytes))];
+    static uint8_t decoded[sizeof(bytes)];
+    static size_t splits[sizeof(expected) + 1];
+    static const size_t steps[] = { 1, 2, 3, 4, 5, 7, 64, 1000, 3071, 3072, 3073, 4095, 4096, 4097, 10000 };
+
+    cz_test_fill(bytes, len, len);
+    size_t expected_len = cz_base64_encode(bytes, len, expected, alphabet, padding);
+
+    for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+        size_t step = steps[s];
+        size_t nsplits = 0;
+
+        for (size_t pos = step; pos < len; pos += step) {
+            splits[nsplits++] = pos;
+        }
+        size_t n = cz_stream_encode(bytes, len, splits, nsplits, encoded, sizeof(encoded), alphabet, padding);
+        CZ_CHECK(n == expected_len && memcmp(encoded, expected, n) == 0,
+                 "encode %zu bytes in steps of %zu", len, step);
+
+        nsplits = 0;
+        for (size_t pos = step; pos < expected_len; pos += step) {
+            splits[nsplits++] = pos;
+        }
+        size_t decoded_len = 0;
+        int ret = cz_stream_decode(expected, expected_len, splits, nsplits, decoded, sizeof(decoded), &decoded_len, alphabet);
+        CZ_CHECK(ret == 0 && decoded_len == len && memcmp(decoded, bytes, len) == 0,
+                 "decode %zu chars in steps of %zu", expected_len, step);
+    }
+}
+
+#pragma mark - 不合法的输入
+
+/// 流式解码 (每个位置切成两段) 与一次解码的结论和结果相同
+static void cz_check_same_as_oneshot(const char *chars, int valid) {
+    size_t len = strlen(chars);
+    uint8_t expected[64], decoded[64];
+    size_t expected_len = 0;
+
+    int oneshot = cz_base64_decode(chars, len, expected, &expected_len, CZBase64Standard);
+    CZ_CHECK((oneshot == 0) == valid, "one-shot \"%s\": %d", chars, oneshot);
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        size_t n = 0;
+        int ret = cz_stream_decode(chars, len, &cut, 1, decoded, sizeof(decoded), &n, CZBase64Standard);
+
+        CZ_CHECK(ret == oneshot, "stream \"%s\" split at %zu: %d, one-shot %d", chars, cut, ret, oneshot);
+        if (ret == 0 && oneshot == 0) {
+            CZ_CHECK(n == expected_len && memcmp(decoded, expected, n) == 0, "stream \"%s\" split at %zu", chars, cut);
+        }
+    }
+}
+
+static void cz_test_invalid(void) {
+    static const char *valid[] = {
+        "", "Zg==", "Zg", "Zm8=", "Zm8", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy",
+    };
+    static const char *invalid[] = {
+        "Z",            // 长度除 4 余 1
+        "Zm9vY",
+        "Zg=",          // 补位不足
+        "Zm9vYg=",
+        "Zg===",        // 补位过多
+        "Zm9v=",
+        "Zm9v====",
+        "=",
+        "==",
+        "Zg==Zg==",     // 中间的 '='
+        "Zm=9v",
+        "Zm9v=Ymfy",
+        "Zm9v Ym",      // 空白
+        "Zm9v\nYmFy",
+        "Zm9v-_",       // 其他字母表
+        "Zm9v*Ym",
+        "Zg==\xff",
+    };
+
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        cz_check_same_as_oneshot(valid[i], 1);
+    }
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        cz_check_same_as_oneshot(invalid[i], 0);
+    }
+
+    // 非法字符在长输入的每个位置，跨过 SIMD 分组和输出缓冲区
+    static uint8_t bytes[3000];
+    static char chars[CZ_BASE64_ENCODED_LENGTH(3000)];
+    static uint8_t decoded[3000];
+    size_t len = cz_base64_encode(bytes, sizeof(bytes), chars, CZBase64Standard, 1);
+
+    for (size_t pos = 0; pos < len; pos += pos < 100 ? 1 : 37) {
+        char saved = chars[pos];
+        size_t cut = len / 2;
+        size_t n = 0;
+
+        chars[pos] = '.';
+        CZ_CHECK(cz_base64_decode(chars, len, decoded, &n, CZBase64Standard) == -1, "one-shot: '.' at %zu", pos);
+        CZ_CHECK(cz_stream_decode(chars, len, &cut, 1, decoded, sizeof(decoded), &n, CZBase64Standard) == -1,
+                 "stream: '.' at %zu", pos);
+        chars[pos] = saved;
+    }
+}
+
+#pragma mark - 停止
+
+static void cz_test_stop(void) {
+    static uint8_t bytes[3 * CZ_BASE64_STREAM_CHUNK];
+    static char chars[CZ_BASE64_ENCODED_LENGTH(sizeof(bytes))];
+    static uint8_t out[sizeof(chars)];
+
+    cz_base64_encoder enc;
+    cz_collector c = cz_collector_make(out, sizeof(out));
+    c.stop_after = 1;
+
+    cz_base64_encoder_init(&enc, CZBase64Standard, 1, cz_collect, &c);
+    CZ_CHECK(cz_base64_encoder_update(&enc, bytes, sizeof(bytes)) == 1, "encoder stopped");
+    CZ_CHECK(c.calls == 1, "encoder kept writing after stop");
+
+    size_t len = cz_base64_encode(bytes, sizeof(bytes), chars, CZBase64Standard, 1);
+    cz_base64_decoder dec;
+    c = cz_collector_make(out, sizeof(out));
+    c.stop_after = 1;
+
+    cz_base64_decoder_init(&dec, CZBase64Standard, cz_collect, &c);
+    CZ_CHECK(cz_base64_decoder_update(&dec, chars, len) == 1, "decoder stopped");
+    CZ_CHECK(c.calls == 1, "decoder kept writing after stop");
+
+    // 最后一组在 final 中输出
+    c = cz_collector_make(out, sizeof(out));
+    c.stop_after = 1;
+    cz_base64_encoder_init(&enc, CZBase64Standard, 1, cz_collect, &c);
+    CZ_CHECK(cz_base64_encoder_update(&enc, "ab", 2) == 0 && c.calls == 0, "encoder carry");
+    CZ_CHECK(cz_base64_encoder_final(&enc) == 1 && c.len == 4 && memcmp(out, "YWI=", 4) == 0, "encoder final stopped");
+}
+
+int main(void) {
+    cz_test_vectors();
+
+    for (size_t len = 0; len <= 40; len++) {
+        cz_test_every_split(len, 1);
+        cz_test_every_split(len, 0);
+    }
+    cz_test_every_split(400, 1);
+
+    static const size_t lengths[] = { 3071, 3072, 3073, 3 * CZ_BASE64_STREAM_CHUNK + 1, 3 * CZ_BASE64_STREAM_CHUNK + 2 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        cz_test_chunked(lengths[i], CZBase64Standard, 1);
+        cz_test_chunked(lengths[i], CZBase64URLSafe, 0);
+    }
+
+    cz_test_invalid();
+    cz_test_stop();
+
+    return cz_test_finish("test_base64");
+}
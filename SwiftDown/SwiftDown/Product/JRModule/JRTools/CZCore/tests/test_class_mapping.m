@@ -0,0 +1,172 @@
+//
+//  test_class_mapping.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// CZClassMapping 的两种数值赋值方式 (只在 macOS 上编译)
+///
+/// 1. 默认调用 setter：重写的 setter 每次都被调用
+/// 2. +cz_mapsScalarsDirectly 返回 YES：写入成员变量，不调用 setter
+///
+/// 两种方式对每种数值类型的结果相同；浮点数赋给整数属性时 NaN、超出范围的值不会未定义
+
+#import <Foundation/Foundation.h>
+
+#import <math.h>
+
+#import "cz_test.h"
+#import "CZClassMapping.h"
+#import "NSObject+CZRuntime.h"
+
+/// 覆盖 CZWriteInteger 处理的全部数值类型
+///
+/// 映射表只解析类自己声明的属性，两个模型类各自声明一遍
+#define CZ_TEST_PROPERTIES                                          \
+@property (nonatomic, assign) char c;                               \
+@property (nonatomic, assign) unsigned char uc;                     \
+@property (nonatomic, assign) short s;                              \
+@property (nonatomic, assign) unsigned short us;                    \
+@property (nonatomic, assign) int i;                                \
+@property (nonatomic, assign) unsigned int ui;                      \
+@property (nonatomic, assign) long l;                               \
+@property (nonatomic, assign) unsigned long ul;                     \
+@property (nonatomic, assign) long long q;                          \
+@property (nonatomic, assign) unsigned long long uq;                \
+@property (nonatomic, assign) bool flag;                            \
+@property (nonatomic, assign) float f;                              \
+@property (nonatomic, assign) double d;                             \
+@property (nonatomic, copy) NSString *name;                         \
+/* setCount: 被调用的次数 */                                        \
+@property (nonatomic, assign, readonly) NSUInteger setterCalls;     \
+@property (nonatomic, assign) NSInteger count;
+
+/// 相当于 Swift 的 didSet
+#define CZ_TEST_SETTER                                              \
+- (void)setCount:(NSInteger)count {                                 \
+    _count = count;                                                 \
+    _setterCalls++;                                                 \
+}
+
+/// 默认方式，所有属性调用 setter
+@interface CZTestSetterModel : NSObject
+CZ_TEST_PROPERTIES
+@end
+
+@implementation CZTestSetterModel
+CZ_TEST_SETTER
+@end
+
+/// 允许直接写入成员变量
+@interface CZTestDirectModel : NSObject
+CZ_TEST_PROPERTIES
+@end
+
+@implementation CZTestDirectModel
+CZ_TEST_SETTER
+
++ (BOOL)cz_mapsScalarsDirectly {
+    return YES;
+}
+
+@end
+
+/// 两个类的属性相同，按其中一个访问
+typedef CZTestSetterModel CZTestScalars;
+
+static NSDictionary *CZTestDictionary(void) {
+    return @{
+        @"c": @(-5), @"uc": @200, @"s": @(-30000), @"us": @60000,
+        @"i": @(-2000000000), @"ui": @4000000000u, @"l": @(-9000000000L), @"ul": @9000000000UL,
+        @"q": @(INT64_MIN), @"uq": @"123456789012",
+        @"flag": @"true", @"f": @1.5, @"d": @"-2.25",
+        @"name": @42, @"count": @7,
+        @"unknown": @1,
+    };
+}
+
+static void CZCheckValues(CZTestScalars *m, const char *what) {
+    CZ_CHECK(m.c == -5 && m.uc == 200 && m.s == -30000 && m.us == 60000, "%s: 8 / 16 bit", what);
+    CZ_CHECK(m.i == -2000000000 && m.ui == 4000000000u, "%s: 32 bit", what);
+    CZ_CHECK(m.l == -9000000000L && m.ul == 9000000000UL, "%s: long", what);
+    CZ_CHECK(m.q == INT64_MIN && m.uq == 123456789012ULL, "%s: long long", what);
+    CZ_CHECK(m.flag && m.f == 1.5f && m.d == -2.25, "%s: bool / float / double", what);
+    CZ_CHECK([m.name isEqualToString:@"42"], "%s: number to string", what);
+    CZ_CHECK(m.count == 7, "%s: count", what);
+}
+
+static void CZTestMapping(Class cls, BOOL direct) {
+    const char *what = direct ? "direct" : "setter";
+    CZClassMapping *mapping = [CZClassMapping mappingForClass:cls];
+
+    // 1. 成员变量偏移只在允许直接写入时解析；重写了 setter 的属性照样按偏移写入，所以要由类明确允许
+    for (NSString *key in @[@"c", @"uc", @"s", @"i", @"q", @"flag", @"f", @"d", @"count"]) {
+        const CZPropertyInfo *property = [mapping propertyForKey:key];
+
+        CZ_CHECK(property != NULL, "%s: %s missing", what, key.UTF8String);
+        if (property != NULL) {
+            CZ_CHECK((property->offset >= 0) == direct, "%s: %s offset %ld", what, key.UTF8String, (long)property->offset);
+        }
+    }
+    CZ_CHECK([mapping propertyForKey:@"name"]->offset == -1, "%s: object property offset", what);
+    CZ_CHECK([mapping propertyForKey:@"setterCalls"] == NULL, "%s: readonly property", what);
+
+    // 2. 字典赋值
+    CZTestScalars *model = [cls new];
+    [mapping setValuesWithDictionary:CZTestDictionary() toObject:model];
+    CZCheckValues(model, what);
+    CZ_CHECK(model.setterCalls == (direct ? 0 : 1), "%s: setter called %lu times", what, (unsigned long)model.setterCalls);
+
+    // 3. JSON 解码直接传入的整数、浮点数
+    const CZPropertyInfo *count = [mapping propertyForKey:@"count"];
+    [mapping setInteger:11 forProperty:count ofObject:model];
+    [mapping setDouble:12.9 forProperty:count ofObject:model];
+    CZ_CHECK(model.count == 12, "%s: double truncated", what);
+    CZ_CHECK(model.setterCalls == (direct ? 0 : 3), "%s: setter called %lu times", what, (unsigned long)model.setterCalls);
+
+    // 4. NaN、inf 和超出 int64 的浮点数
+    const CZPropertyInfo *q = [mapping propertyForKey:@"q"];
+    const CZPropertyInfo *flag = [mapping propertyForKey:@"flag"];
+
+    [mapping setDouble:NAN forProperty:q ofObject:model];
+    CZ_CHECK(model.q == 0, "%s: NaN", what);
+    [mapping setDouble:1e300 forProperty:q ofObject:model];
+    CZ_CHECK(model.q == INT64_MAX, "%s: 1e300", what);
+    [mapping setDouble:-INFINITY forProperty:q ofObject:model];
+    CZ_CHECK(model.q == INT64_MIN, "%s: -inf", what);
+    [mapping setDouble:9223372036854775808.0 forProperty:q ofObject:model];
+    CZ_CHECK(model.q == INT64_MAX, "%s: 2^63", what);
+    [mapping setDouble:-9223372036854775808.0 forProperty:q ofObject:model];
+    CZ_CHECK(model.q == INT64_MIN, "%s: -2^63", what);
+    [mapping setDouble:0.5 forProperty:flag ofObject:model];
+    CZ_CHECK(!model.flag, "%s: 0.5 to bool", what);
+    [mapping setDouble:2 forProperty:flag ofObject:model];
+    CZ_CHECK(model.flag, "%s: 2 to bool", what);
+
+    // 5. NSNull 不修改数值属性，对象属性赋为 nil
+    [mapping setValuesWithDictionary:@{ @"q": [NSNull null], @"name": [NSNull null] } toObject:model];
+    CZ_CHECK(model.q == INT64_MIN && model.name == nil, "%s: NSNull", what);
+}
+
+int main(void) {
+    @autoreleasepool {
+        CZ_CHECK(![NSObject cz_mapsScalarsDirectly], "direct writes must be opt-in");
+
+        CZTestMapping([CZTestSetterModel class], NO);
+        CZTestMapping([CZTestDirectModel class], YES);
+
+        // 两种方式通过 cz_objectsWithArray: 的结果相同
+        NSArray *array = @[CZTestDictionary(), CZTestDictionary()];
+        NSArray *setterObjects = [CZTestSetterModel cz_objectsWithArray:array];
+        NSArray *directObjects = [CZTestDirectModel cz_objectsWithArray:array];
+
+        CZ_CHECK(setterObjects.count == 2 && directObjects.count == 2, "cz_objectsWithArray: count");
+        for (NSUInteger i = 0; i < MIN(setterObjects.count, directObjects.count); i++) {
+            CZCheckValues(setterObjects[i], "cz_objectsWithArray: setter");
+            CZCheckValues(directObjects[i], "cz_objectsWithArray: direct");
+        }
+    }
+    return cz_test_finish("test_class_mapping");
+}
@@ -0,0 +1,152 @@
+//
+//  test_crc32c.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_crc32c 的已知答案和对照测试
+///
+/// 1. 标准校验值 ("123456789" -> e3069283) 和 RFC 3720 的 iSCSI 向量
+/// 2. 当前实现 (armv8 / sse4.2 / table) 与查表实现、逐位计算的参考实现对照，
+///    覆盖各种长度和起始对齐，包括硬件路径分 3 段交替计算的大块数据
+/// 3. 任意切分后累加计算、cz_crc32c_combine 合并与一次计算相同
+/// 4. cz_crc32c_file 与内存中计算相同
+
+#include "cz_test.h"
+#include "cz_crc32c.h"
+
+#include <unistd.h>
+
+/// 逐位计算，不依赖任何表
+static uint32_t cz_bit_crc32c(uint32_t crc, const uint8_t *p, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78u : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+static void cz_test_vectors(void) {
+    uint8_t data[48];
+
+    CZ_CHECK(cz_crc32c(0, "123456789", 9) == 0xe3069283u, "123456789: %08x", cz_crc32c(0, "123456789", 9));
+    CZ_CHECK(cz_crc32c_ref(0, "123456789", 9) == 0xe3069283u, "ref 123456789");
+    CZ_CHECK(cz_crc32c(0, "", 0) == 0, "empty");
+    CZ_CHECK(cz_crc32c(0x12345678u, NULL, 0) == 0x12345678u, "empty keeps crc");
+
+    // RFC 3720 B.4
+    memset(data, 0, 32);
+    CZ_CHECK(cz_crc32c(0, data, 32) == 0x8a9136aau, "32 zero bytes");
+    memset(data, 0xff, 32);
+    CZ_CHECK(cz_crc32c(0, data, 32) == 0x62a8ab43u, "32 0xff bytes");
+    for (int i = 0; i < 32; i++) {
+        data[i] = (uint8_t)i;
+    }
+    CZ_CHECK(cz_crc32c(0, data, 32) == 0x46dd794eu, "32 incrementing bytes");
+    for (int i = 0; i < 32; i++) {
+        data[i] = (uint8_t)(31 - i);
+    }
+    CZ_CHECK(cz_crc32c(0, data, 32) == 0x113fdb5cu, "32 decrementing bytes");
+}
+
+static void cz_test_kernels(void) {
+    static uint8_t data[200000 + 16];
+
+    cz_test_fill(data, sizeof(data), 1);
+
+    // 短数据覆盖每个长度和对齐，长数据覆盖 3 段交替的边界
+    for (size_t offset = 0; offset < 16; offset++) {
+        for (size_t len = 0; len <= 300; len++) {
+            uint32_t crc = cz_crc32c(0, data + offset, len);
+            uint32_t ref = cz_crc32c_ref(0, data + offset, len);
+
+            CZ_CHECK(crc == ref, "%s: offset %zu len %zu", cz_crc32c_kernel_name(), offset, len);
+            CZ_CHECK(ref == cz_bit_crc32c(0, data + offset, len), "table: offset %zu len %zu", offset, len);
+        }
+    }
+
+    static const size_t lengths[] = { 4095, 4096, 3 * 4096 - 1, 3 * 4096, 3 * 4096 + 1, 3 * 4096 + 7, 6 * 4096 + 13, 65536, 200000 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        for (size_t offset = 0; offset < 16; offset += 5) {
+            size_t len = lengths[i];
+            uint32_t crc = cz_crc32c(0, data + offset, len);
+
+            CZ_CHECK(crc == cz_crc32c_ref(0, data + offset, len), "%s: offset %zu len %zu",
+                     cz_crc32c_kernel_name(), offset, len);
+            CZ_CHECK(crc == cz_bit_crc32c(0, data + offset, len), "bitwise: offset %zu len %zu", offset, len);
+        }
+    }
+}
+
+static void cz_test_incremental(void) {
+    static uint8_t data[100000];
+    uint64_t state = 7;
+
+    cz_test_fill(data, sizeof(data), 2);
+    uint32_t expected = cz_crc32c_ref(0, data, sizeof(data));
+
+    // 每个位置切成两段
+    for (size_t cut = 0; cut <= 256; cut++) {
+        uint32_t crc = cz_crc32c(cz_crc32c(0, data, cut), data + cut, 256 - cut);
+        CZ_CHECK(crc == cz_crc32c_ref(0, data, 256), "split at %zu", cut);
+    }
+
+    // 随机切成多段，累加计算和合并都与一次计算相同
+    for (int round = 0; round < 50; round++) {
+        uint32_t crc = 0;
+        uint32_t combined = 0;
+        size_t pos = 0;
+
+        while (pos < sizeof(data)) {
+            size_t len = (size_t)(cz_test_random(&state) % 9000);
+            if (len > sizeof(data) - pos) {
+                len = sizeof(data) - pos;
+            }
+            crc = cz_crc32c(crc, data + pos, len);
+            combined = cz_crc32c_combine(combined, cz_crc32c(0, data + pos, len), len);
+            pos += len;
+        }
+        CZ_CHECK(crc == expected, "round %d: incremental", round);
+        CZ_CHECK(combined == expected, "round %d: combine", round);
+    }
+
+    CZ_CHECK(cz_crc32c_combine(0x12345678u, 0, 0) == 0x12345678u, "combine with empty");
+}
+
+static void cz_test_file(void) {
+    static uint8_t data[3 << 20];
+    char path[] = "/tmp/test_crc32c.XXXXXX";
+    int fd = mkstemp(path);
+
+    CZ_CHECK(fd >= 0, "mkstemp");
+    if (fd < 0) {
+        return;
+    }
+
+    cz_test_fill(data, sizeof(data), 3);
+    CZ_CHECK(write(fd, data, sizeof(data)) == (ssize_t)sizeof(data), "write");
+    close(fd);
+
+    uint32_t crc = 0;
+    CZ_CHECK(cz_crc32c_file(path, &crc) == 0, "file");
+    CZ_CHECK(crc == cz_crc32c_ref(0, data, sizeof(data)), "file differs");
+
+    unlink(path);
+    CZ_CHECK(cz_crc32c_file(path, &crc) == -1, "missing file");
+}
+
+int main(void) {
+    printf("test_crc32c (%s)\n", cz_crc32c_kernel_name());
+
+    cz_test_vectors();
+    cz_test_kernels();
+    cz_test_incremental();
+    cz_test_file();
+
+    return cz_test_finish("test_crc32c");
+}
@@ -0,0 +1,342 @@
+//
+//  test_digest.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_digest / cz_multi_digest_file 的已知答案测试
+///
+/// 1. FIPS 180 / RFC 1321 的标准向量
+/// 2. 中间状态在每个位置导出、导入后继续输入，结果与一次计算相同；
+///    截断、算法不对、字段不一致的数据不能导入
+/// 3. 不同大小的临时文件，结果与 `openssl dgst` 的输出对照
+
+#include "cz_test.h"
+#include "cz_digest.h"
+
+#include <unistd.h>
+
+static const char *cz_alg_names[CZDigestCount] = {
+    "md5", "sha1", "sha224", "sha256", "sha384", "sha512"
+};
+
+#pragma mark - 标准向量
+
+typedef struct {
+    const char *message;
+    const char *digests[CZDigestCount];
+} cz_digest_vector;
+
+static const cz_digest_vector cz_vectors[] = {
+    { "", {
+        "d41d8cd98f00b204e9800998ecf8427e",
+        "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+        "d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f",
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+        "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b",
+        "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e",
+    } },
+    { "abc", {
+        "900150983cd24fb0d6963f7d28e17f72",
+        "a9993e364706816aba3e25717850c26c9cd0d89d",
+        "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7",
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+        "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7",
+        "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+    } },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", {
+        "8215ef0796a20bcaaae116d3876c664a",
+        "84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+        "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525",
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+        "3391fdddfc8dc7393707a65b1b4709397cf8b1d162af05abfe8f450de5f36bc6b0455a8520bc4e6f5fe95b1fe3c8452b",
+        "204a8fc6dda82f0a0ced7beb8e08a41657c16ef468b228a8279be331a703c33596fd15c13b1b07f9aa1d3bea57789ca031ad85c7a71dd70354ec631238ca3445",
+    } },
+};
+
+static void cz_test_vectors(void) {
+    uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+    char hex[2 * CZ_DIGEST_MAX_LENGTH + 1];
+
+    for (size_t v = 0; v < sizeof(cz_vectors) / sizeof(cz_vectors[0]); v++) {
+        const char *message = cz_vectors[v].message;
+        size_t len = strlen(message);
+
+        for (int alg = 0; alg < CZDigestCount; alg++) {
+            // 一次输入
+            cz_digest((CZDigestAlgorithm)alg, message, len, digest);
+            cz_test_hex(digest, cz_digest_length(alg), hex);
+            CZ_CHECK(strcmp(hex, cz_vectors[v].digests[alg]) == 0,
+                     "%s(\"%s\") = %s", cz_alg_names[alg], message, hex);
+
+            // 逐字节输入
+            cz_digest_ctx ctx;
+            cz_digest_init(&ctx, (CZDigestAlgorithm)alg);
+            for (size_t i = 0; i < len; i++) {
+                cz_digest_update(&ctx, message + i, 1);
+            }
+            cz_digest_final(&ctx, digest);
+            cz_test_hex(digest, cz_digest_length(alg), hex);
+            CZ_CHECK(strcmp(hex, cz_vectors[v].digests[alg]) == 0,
+                     "%s(\"%s\") byte by byte = %s", cz_alg_names[alg], message, hex);
+        }
+    }
+}
+
+#pragma mark - 状态保存
+
+static const CZDigestAlgorithm cz_resumable_algs[] = { CZDigestSHA1, CZDigestSHA224, CZDigestSHA256 };
+
+/// 输入 cut 字节后导出，导入到新的上下文继续输入，与一次计算对照
+static void cz_check_resume(CZDigestAlgorithm alg, const uint8_t *bytes, size_t len, size_t cut) {
+    uint8_t state[CZ_DIGEST_STATE_MAX_LENGTH];
+    uint8_t expected[CZ_DIGEST_MAX_LENGTH], digest[CZ_DIGEST_MAX_LENGTH];
+    size_t words = alg == CZDigestSHA1 ? 5 : 8;
+    cz_digest_ctx ctx, resumed;
+
+    cz_digest(alg, bytes, len, expected);
+
+    cz_digest_init(&ctx, alg);
+    cz_digest_update(&ctx, bytes, cut);
+    CZ_CHECK(cz_digest_processed(&ctx) == cut, "%s processed %zu", cz_alg_names[alg], cut);
+
+    size_t n = cz_digest_export(&ctx, state);
+    CZ_CHECK(n == 16 + 4 * words + (cut & 63) && n <= CZ_DIGEST_STATE_MAX_LENGTH,
+             "%s export at %zu: %zu bytes", cz_alg_names[alg], cut, n);
+
+    // 导入不依赖上下文原来的内容
+    memset(&resumed, 0xa5, sizeof(resumed));
+    CZ_CHECK(cz_digest_import(&resumed, state, n) == 0, "%s import at %zu", cz_alg_names[alg], cut);
+    CZ_CHECK(cz_digest_processed(&resumed) == cut, "%s resumed processed %zu", cz_alg_names[alg], cut);
+
+    cz_digest_update(&resumed, bytes + cut, len - cut);
+    cz_digest_final(&resumed, digest);
+    CZ_CHECK(memcmp(digest, expected, cz_digest_length(alg)) == 0,
+             "%s of %zu bytes resumed at %zu", cz_alg_names[alg], len, cut);
+
+    // 导出不改变原来的上下文
+    cz_digest_update(&ctx, bytes + cut, len - cut);
+    cz_digest_final(&ctx, digest);
+    CZ_CHECK(memcmp(digest, expected, cz_digest_length(alg)) == 0,
+             "%s of %zu bytes after export at %zu", cz_alg_names[alg], len, cut);
+}
+
+static void cz_test_resume(void) {
+    static uint8_t bytes[5000];
+    cz_test_fill(bytes, sizeof(bytes), 9);
+
+    for (size_t a = 0; a < sizeof(cz_resumable_algs) / sizeof(cz_resumable_algs[0]); a++) {
+        CZDigestAlgorithm alg = cz_resumable_algs[a];
+
+        CZ_CHECK(cz_digest_resumable(alg), "%s resumable", cz_alg_names[alg]);
+
+        // 分组内的每个位置
+        for (size_t cut = 0; cut <= 200; cut++) {
+            cz_check_resume(alg, bytes, 200, cut);
+        }
+        for (size_t cut = 0; cut <= sizeof(bytes); cut += 97) {
+            cz_check_resume(alg, bytes, sizeof(bytes), cut);
+        }
+        cz_check_resume(alg, bytes, sizeof(bytes), sizeof(bytes));
+    }
+
+    // 不支持的算法不导出
+    uint8_t state[CZ_DIGEST_STATE_MAX_LENGTH];
+    static const CZDigestAlgorithm others[] = { CZDigestMD5, CZDigestSHA384, CZDigestSHA512 };
+
+    for (size_t a = 0; a < sizeof(others) / sizeof(others[0]); a++) {
+        cz_digest_ctx ctx;
+
+        cz_digest_init(&ctx, others[a]);
+        cz_digest_update(&ctx, bytes, 100);
+        CZ_CHECK(!cz_digest_resumable(others[a]), "%s not resumable", cz_alg_names[others[a]]);
+        CZ_CHECK(cz_digest_export(&ctx, state) == 0, "%s export", cz_alg_names[others[a]]);
+        CZ_CHECK(cz_digest_processed(&ctx) == 0, "%s processed", cz_alg_names[others[a]]);
+    }
+}
+
+/// 格式与平台无关：SHA256 输入 "abc" 后的状态
+static void cz_test_state_format(void) {
+    static const char *expected =
+        "435a4831" "03" "03" "0000" "0300000000000000"
+        "67e6096a" "85ae67bb" "72f36e3c" "3af54fa5" "7f520e51" "8c68059b" "abd9831f" "19cde05b"
+        "616263";
+    uint8_t state[CZ_DIGEST_STATE_MAX_LENGTH];
+    char hex[2 * CZ_DIGEST_STATE_MAX_LENGTH + 1];
+    cz_digest_ctx ctx;
+
+    cz_digest_init(&ctx, CZDigestSHA256);
+    cz_digest_update(&ctx, "abc", 3);
+    size_t n = cz_digest_export(&ctx, state);
+    cz_test_hex(state, n, hex);
+    CZ_CHECK(strcmp(hex, expected) == 0, "sha256 state after \"abc\": %s", hex);
+}
+
+/// 不合法的序列化数据
+static void cz_test_state_invalid(void) {
+    static uint8_t bytes[100];
+    uint8_t state[CZ_DIGEST_STATE_MAX_LENGTH + 1], bad[CZ_DIGEST_STATE_MAX_LENGTH + 1];
+    cz_digest_ctx ctx;
+
+    cz_test_fill(bytes, sizeof(bytes), 11);
+
+    for (size_t a = 0; a < sizeof(cz_resumable_algs) / sizeof(cz_resumable_algs[0]); a++) {
+        CZDigestAlgorithm alg = cz_resumable_algs[a];
+        const char *name = cz_alg_names[alg];
+
+        cz_digest_init(&ctx, alg);
+        cz_digest_update(&ctx, bytes, sizeof(bytes));
+        size_t n = cz_digest_export(&ctx, state);
+
+        // 截断或多出字节
+        for (size_t len = 0; len < n; len++) {
+            CZ_CHECK(cz_digest_import(&ctx, state, len) == -1, "%s truncated to %zu", name, len);
+        }
+        memcpy(bad, state, n);
+        bad[n] = 0;
+        CZ_CHECK(cz_digest_import(&ctx, bad, n + 1) == -1, "%s with a trailing byte", name);
+
+        // 标识不对
+        memcpy(bad, state, n);
+        bad[3] = '2';
+        CZ_CHECK(cz_digest_import(&ctx, bad, n) == -1, "%s bad magic", name);
+
+        // 算法不支持或不存在
+        static const uint8_t wrong[] = { CZDigestMD5, CZDigestSHA384, CZDigestSHA512, CZDigestCount, 0xff };
+        for (size_t w = 0; w < sizeof(wrong); w++) {
+            memcpy(bad, state, n);
+            bad[4] = wrong[w];
+            CZ_CHECK(cz_digest_import(&ctx, bad, n) == -1, "%s relabelled as %u", name, wrong[w]);
+        }
+
+        // SHA1 与 SHA256 的状态字个数不同
+        memcpy(bad, state, n);
+        bad[4] = alg == CZDigestSHA1 ? CZDigestSHA256 : CZDigestSHA1;
+        CZ_CHECK(cz_digest_import(&ctx, bad, n) == -1, "%s relabelled as %s", name, cz_alg_names[bad[4]]);
+
+        // 缓冲字节数与已输入字节数不一致
+        memcpy(bad, state, n);
+        bad[5] ^= 1;
+        CZ_CHECK(cz_digest_import(&ctx, bad, n) == -1, "%s buffered count", name);
+        memcpy(bad, state, n);
+        bad[8] ^= 1;
+        CZ_CHECK(cz_digest_import(&ctx, bad, n) == -1, "%s processed count", name);
+
+        // 原数据仍然可以导入
+        CZ_CHECK(cz_digest_import(&ctx, state, n) == 0, "%s valid state", name);
+    }
+}
+
+#pragma mark - 文件
+
+/// 运行 `openssl dgst -<alg> -r path`，取出十六进制结果
+static int cz_openssl_dgst(const char *alg, const char *path, char *hex, size_t size) {
+    char command[512];
+    snprintf(command, sizeof(command), "openssl dgst -%s -r '%s' 2>/dev/null", alg, path);
+
+    FILE *pipe = popen(command, "r");
+    if (pipe == NULL) {
+        return -1;
+    }
+
+    int ok = fgets(hex, (int)size, pipe) != NULL;
+    pclose(pipe);
+
+    if (!ok) {
+        return -1;
+    }
+    hex[strcspn(hex, " \n")] = '\0';
+
+    return 0;
+}
+
+static void cz_test_file(const char *dir, size_t length, CZDigestMask mask) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/cz_digest_XXXXXX", dir);
+
+    int fd = mkstemp(path);
+    CZ_CHECK(fd >= 0, "mkstemp %s", path);
+    if (fd < 0) {
+        return;
+    }
+
+    uint8_t *bytes = malloc(length + 1);
+    cz_test_fill(bytes, length, length);
+    CZ_CHECK(write(fd, bytes, length) == (ssize_t)length, "write %zu bytes", length);
+    close(fd);
+    free(bytes);
+
+    uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH];
+    CZ_CHECK(cz_multi_digest_file(path, mask, out) == 0, "cz_multi_digest_file %zu bytes", length);
+
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        if (!(mask & CZDigestMaskOf(alg))) {
+            continue;
+        }
+
+        char expected[2 * CZ_DIGEST_MAX_LENGTH + 16];
+        char hex[2 * CZ_DIGEST_MAX_LENGTH + 1];
+
+        if (cz_openssl_dgst(cz_alg_names[alg], path, expected, sizeof(expected)) != 0) {
+            CZ_CHECK(0, "openssl dgst -%s failed", cz_alg_names[alg]);
+            continue;
+        }
+        cz_test_hex(out[alg], cz_digest_length(alg), hex);
+        CZ_CHECK(strcmp(hex, expected) == 0, "%s of %zu bytes: %s, openssl %s",
+                 cz_alg_names[alg], length, hex, expected);
+    }
+
+    // 流式读取与映射的结果相同
+    uint8_t streamed[CZDigestCount][CZ_DIGEST_MAX_LENGTH];
+    CZ_CHECK(cz_multi_digest_file_mode(path, mask, CZFileReadStream, NULL, streamed) == 0,
+             "streamed digest of %zu bytes", length);
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        if (mask & CZDigestMaskOf(alg)) {
+            CZ_CHECK(memcmp(streamed[alg], out[alg], cz_digest_length(alg)) == 0,
+                     "%s of %zu bytes: streamed and mapped differ", cz_alg_names[alg], length);
+        }
+    }
+
+    // 已取消时不计算结果
+    int cancelled = 1;
+    CZ_CHECK(cz_multi_digest_file_cancellable(path, mask, &cancelled, out) == (length == 0 ? 0 : 1),
+             "cancelled digest of %zu bytes", length);
+
+    unlink(path);
+}
+
+static void cz_test_files(void) {
+    const char *dir = getenv("TMPDIR");
+    if (dir == NULL || dir[0] == '\0') {
+        dir = "/tmp";
+    }
+
+    // 分组边界、流式读取的块大小、映射的最小大小和切片大小前后
+    static const size_t lengths[] = {
+        0, 1, 55, 56, 63, 64, 65, 111, 112, 127, 128, 129, 4095, 4097,
+        (1 << 20) - 1, (1 << 20) + 1, CZ_FILE_MAP_MIN_SIZE - 1, CZ_FILE_MAP_MIN_SIZE, (8 << 20) + 17,
+    };
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        cz_test_file(dir, lengths[i], CZDigestMaskAll);
+    }
+
+    // 只选部分算法
+    cz_test_file(dir, 1000003, CZDigestMaskOf(CZDigestMD5) | CZDigestMaskOf(CZDigestSHA256));
+    cz_test_file(dir, 1000003, CZDigestMaskOf(CZDigestSHA512));
+
+    uint8_t out[CZDigestCount][CZ_DIGEST_MAX_LENGTH];
+    CZ_CHECK(cz_multi_digest_file("/nonexistent/cz_digest", CZDigestMaskAll, out) == -1, "missing file");
+}
+
+int main(void) {
+    cz_test_vectors();
+    cz_test_resume();
+    cz_test_state_format();
+    cz_test_state_invalid();
+    cz_test_files();
+
+    return cz_test_finish("test_digest");
+}
@@ -0,0 +1,401 @@
+//
+//  test_json.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_json 拉取式解析器
+///
+/// 1. token 序列和值，cz_json_skip 跳过嵌套的值
+/// 2. 字符串转义，\uXXXX 的 1 ~ 3 字节 UTF8 和代理对，不合法的转义
+/// 3. 数字：int64 边界、超出范围的整数和 double 的 integer 值、不合法的写法
+/// 4. 嵌套层数上限
+/// 5. 不完整、多余或顺序错误的输入都返回 CZJSONError
+/// 6. 按原始字节和转义后的 key 查找原子
+
+#include "cz_test.h"
+#include "cz_json.h"
+
+#include <math.h>
+
+/// 读完整个文档，返回 token 个数 (不含 CZJSONEnd)，出错返回 -1
+static int cz_parse_all(const char *json) {
+    cz_json_parser parser;
+    int count = 0;
+
+    cz_json_init(&parser, json, strlen(json));
+    for (;;) {
+        CZJSONToken token = cz_json_next(&parser);
+        if (token == CZJSONError) {
+            return -1;
+        }
+        if (token == CZJSONEnd) {
+            return count;
+        }
+        count++;
+    }
+}
+
+#pragma mark - token
+
+static void cz_test_tokens(void) {
+    const char *json = " {\"id\": 42, \"name\": \"chapter\", \"tags\": [true, false, null, -1.5],\n"
+                       "  \"empty\": {}, \"none\": [] } ";
+    static const CZJSONToken expected[] = {
+        CZJSONObjectBegin,
+        CZJSONKey, CZJSONInteger,
+        CZJSONKey, CZJSONString,
+        CZJSONKey, CZJSONArrayBegin, CZJSONTrue, CZJSONFalse, CZJSONNull, CZJSONDouble, CZJSONArrayEnd,
+        CZJSONKey, CZJSONObjectBegin, CZJSONObjectEnd,
+        CZJSONKey, CZJSONArrayBegin, CZJSONArrayEnd,
+        CZJSONObjectEnd,
+        CZJSONEnd,
+    };
+    cz_json_parser parser;
+
+    cz_json_init(&parser, json, strlen(json));
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        CZJSONToken token = cz_json_next(&parser);
+
+        CZ_CHECK(token == expected[i], "token %zu: %d, expected %d", i, token, expected[i]);
+        if (token != expected[i]) {
+            return;
+        }
+        if (i == 1) {
+            CZ_CHECK(parser.str_len == 2 && memcmp(parser.str, "id", 2) == 0, "key id");
+        }
+        if (i == 2) {
+            CZ_CHECK(parser.integer == 42, "integer 42");
+        }
+        if (i == 4) {
+            CZ_CHECK(parser.str_len == 7 && memcmp(parser.str, "chapter", 7) == 0 && !parser.str_escaped,
+                     "string chapter");
+        }
+        if (i == 10) {
+            CZ_CHECK(parser.number == -1.5, "double -1.5");
+        }
+    }
+
+    // 标量也可以是顶层值
+    CZ_CHECK(cz_parse_all("\"top\"") == 1, "top-level string");
+    CZ_CHECK(cz_parse_all(" 7 ") == 1, "top-level number");
+    CZ_CHECK(cz_parse_all("null") == 1, "top-level null");
+}
+
+static void cz_test_skip(void) {
+    const char *json = "{\"skip\": {\"a\": [1, {\"b\": [[], {}]}, \"]\"]}, \"next\": 3}";
+    cz_json_parser parser;
+
+    cz_json_init(&parser, json, strlen(json));
+    CZ_CHECK(cz_json_next(&parser) == CZJSONObjectBegin, "skip: begin");
+    CZ_CHECK(cz_json_next(&parser) == CZJSONKey, "skip: key");
+
+    CZJSONToken token = cz_json_next(&parser);
+    const char *start = cz_json_position(&parser) - 1;
+    CZ_CHECK(cz_json_skip(&parser, token) == 0, "skip: nested value");
+
+    const char *raw = "{\"a\": [1, {\"b\": [[], {}]}, \"]\"]}";
+    size_t raw_len = (size_t)(cz_json_position(&parser) - start);
+    CZ_CHECK(raw_len == strlen(raw) && memcmp(start, raw, raw_len) == 0, "skip: raw value");
+
+    CZ_CHECK(cz_json_next(&parser) == CZJSONKey && parser.str_len == 4, "skip: next key");
+    token = cz_json_next(&parser);
+    CZ_CHECK(token == CZJSONInteger && parser.integer == 3, "skip: next value");
+    CZ_CHECK(cz_json_skip(&parser, token) == 0, "skip: scalar");
+    CZ_CHECK(cz_json_next(&parser) == CZJSONObjectEnd, "skip: end");
+    CZ_CHECK(cz_json_next(&parser) == CZJSONEnd, "skip: done");
+
+    CZ_CHECK(cz_json_skip(&parser, CZJSONObjectEnd) == -1, "skip: container end");
+
+    // 跳过的值里有语法错误
+    json = "[{\"a\": [1 2]}]";
+    cz_json_init(&parser, json, strlen(json));
+    cz_json_next(&parser);
+    token = cz_json_next(&parser);
+    CZ_CHECK(cz_json_skip(&parser, token) == -1, "skip: malformed nested value");
+}
+
+#pragma mark - 转义
+
+static void cz_check_unescape(const char *str, const char *expected, size_t expected_len) {
+    char out[64];
+    size_t len = cz_json_unescape(str, strlen(str), out);
+
+    CZ_CHECK(len == expected_len && memcmp(out, expected, expected_len) == 0, "unescape \"%s\"", str);
+}
+
+static void cz_test_escapes(void) {
+    cz_check_unescape("plain", "plain", 5);
+    cz_check_unescape("", "", 0);
+    cz_check_unescape("\\\"\\\\\\/\\b\\f\\n\\r\\t", "\"\\/\b\f\n\r\t", 8);
+    cz_check_unescape("a\\nb\\tc", "a\nb\tc", 5);
+
+    // \uXXXX 编码为 1、2、3 字节的 UTF8，大小写十六进制都可以
+    cz_check_unescape("\\u0041", "A", 1);
+    cz_check_unescape("\\u0000", "\0", 1);
+    cz_check_unescape("\\u00e9\\u00E9", "\xc3\xa9\xc3\xa9", 4);
+    cz_check_unescape("\\u4e2d\\u6587", "\xe4\xb8\xad\xe6\x96\x87", 6);
+    cz_check_unescape("\\uffff", "\xef\xbf\xbf", 3);
+
+    // 代理对编码为 4 字节
+    cz_check_unescape("\\ud83d\\ude00", "\xf0\x9f\x98\x80", 4);
+    cz_check_unescape("\\uD800\\uDC00", "\xf0\x90\x80\x80", 4);
+    cz_check_unescape("\\udbff\\udfff", "\xf4\x8f\xbf\xbf", 4);
+    cz_check_unescape("x\\ud83d\\ude00y", "x\xf0\x9f\x98\x80y", 6);
+
+    // 不合法的转义
+    static const char *invalid[] = {
+        "\\",               // 结尾的 '\'
+        "abc\\",
+        "\\x",              // 未知转义
+        "\\u12",            // 不足 4 位
+        "\\u12g4",
+        "\\ud83d",          // 只有高位代理
+        "\\ud83dabcdef",
+        "\\ud83d\\n",
+        "\\ud83d\\u0041",   // 高位代理之后不是低位代理
+        "\\ud83d\\ud83d",
+        "\\ude00",          // 只有低位代理
+        "\\ude00\\ud83d",
+    };
+    char out[64];
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        CZ_CHECK(cz_json_unescape(invalid[i], strlen(invalid[i]), out) == (size_t)-1,
+                 "invalid escape \"%s\" accepted", invalid[i]);
+    }
+
+    // 原地解码
+    char buffer[] = "\\u4e2d\\t\\ud83d\\ude00";
+    size_t len = cz_json_unescape(buffer, strlen(buffer), buffer);
+    CZ_CHECK(len == 8 && memcmp(buffer, "\xe4\xb8\xad\t\xf0\x9f\x98\x80", 8) == 0, "unescape in place");
+
+    // 解析器只标记转义，字符串原样返回，转义的引号不结束字符串
+    const char *json = "[\"a\\\"b\", \"\\\\\", \"\\ud83d\\ude00\"]";
+    cz_json_parser parser;
+
+    cz_json_init(&parser, json, strlen(json));
+    cz_json_next(&parser);
+    CZ_CHECK(cz_json_next(&parser) == CZJSONString && parser.str_escaped && parser.str_len == 4,
+             "escaped quote in string");
+    CZ_CHECK(cz_json_next(&parser) == CZJSONString && parser.str_escaped && parser.str_len == 2,
+             "escaped backslash before closing quote");
+    CZ_CHECK(cz_json_next(&parser) == CZJSONString && parser.str_escaped && parser.str_len == 12,
+             "surrogate pair in string");
+    CZ_CHECK(cz_json_next(&parser) == CZJSONArrayEnd, "escapes: end");
+
+    // 长字符串中 '"' 和 '\' 落在 8 字节分组的每个位置
+    for (size_t pos = 0; pos < 24; pos++) {
+        char text[64];
+
+        memset(text, 'x', sizeof(text));
+        text[0] = '"';
+        text[1 + pos] = '\\';
+        text[2 + pos] = '"';
+        text[40] = '"';
+        text[41] = '\0';
+        CZ_CHECK(cz_parse_all(text) == 1, "escaped quote at %zu", pos);
+    }
+}
+
+#pragma mark - 数字
+
+static void cz_check_number(const char *json, CZJSONToken expected, int64_t integer, double number) {
+    cz_json_parser parser;
+
+    cz_json_init(&parser, json, strlen(json));
+    CZJSONToken token = cz_json_next(&parser);
+
+    CZ_CHECK(token == expected, "%s: token %d, expected %d", json, token, expected);
+    CZ_CHECK(parser.integer == integer, "%s: integer %lld, expected %lld", json,
+             (long long)parser.integer, (long long)integer);
+    CZ_CHECK(parser.number == number, "%s: number %g, expected %g", json, parser.number, number);
+    CZ_CHECK(cz_json_next(&parser) == CZJSONEnd, "%s: end", json);
+}
+
+static void cz_test_numbers(void) {
+    cz_check_number("0", CZJSONInteger, 0, 0);
+    cz_check_number("-0", CZJSONInteger, 0, 0);
+    cz_check_number("123", CZJSONInteger, 123, 123);
+    cz_check_number("-42", CZJSONInteger, -42, -42);
+    cz_check_number("9223372036854775807", CZJSONInteger, INT64_MAX, (double)INT64_MAX);
+    cz_check_number("-9223372036854775808", CZJSONInteger, INT64_MIN, (double)INT64_MIN);
+
+    // 超出 int64 的整数按 double 返回，integer 限制在范围内
+    cz_check_number("9223372036854775808", CZJSONDouble, INT64_MAX, 9223372036854775808.0);
+    cz_check_number("-9223372036854775809", CZJSONDouble, INT64_MIN, -9223372036854775808.0);
+    cz_check_number("18446744073709551616", CZJSONDouble, INT64_MAX, 18446744073709551616.0);
+    cz_check_number("-100000000000000000000", CZJSONDouble, INT64_MIN, -1e20);
+
+    // 小数、指数向零取整，溢出为 ±inf 时取边界
+    cz_check_number("1.5", CZJSONDouble, 1, 1.5);
+    cz_check_number("-1.5", CZJSONDouble, -1, -1.5);
+    cz_check_number("0.25", CZJSONDouble, 0, 0.25);
+    cz_check_number("1e3", CZJSONDouble, 1000, 1000);
+    cz_check_number("2.5E+2", CZJSONDouble, 250, 250);
+    cz_check_number("5e-1", CZJSONDouble, 0, 0.5);
+    cz_check_number("1e19", CZJSONDouble, INT64_MAX, 1e19);
+    cz_check_number("-1e19", CZJSONDouble, INT64_MIN, -1e19);
+    cz_check_number("1e999", CZJSONDouble, INT64_MAX, HUGE_VAL);
+    cz_check_number("-1e999", CZJSONDouble, INT64_MIN, -HUGE_VAL);
+
+    // 超过栈上缓冲区长度的数字
+    char long_number[128];
+    memset(long_number, '1', 100);
+    long_number[100] = '\0';
+    cz_check_number(long_number, CZJSONDouble, INT64_MAX, strtod(long_number, NULL));
+
+    static const char *invalid[] = {
+        "-", "+1", "01", "-01", "00", ".5", "1.", "1.e5", "1e", "1e+", "--1", "0x10", "1a", "Infinity", "NaN",
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        CZ_CHECK(cz_parse_all(invalid[i]) == -1, "invalid number %s accepted", invalid[i]);
+    }
+
+    // 数字后紧跟容器结束
+    CZ_CHECK(cz_parse_all("[1,-2,3.5,4e1]") == 6, "numbers in array");
+    CZ_CHECK(cz_parse_all("{\"a\":-0.0}") == 4, "number before '}'");
+}
+
+#pragma mark - 嵌套
+
+static void cz_test_depth(void) {
+    char json[8 * CZ_JSON_MAX_DEPTH];
+    size_t len = 0;
+
+    // 恰好 CZ_JSON_MAX_DEPTH 层
+    for (int i = 0; i < CZ_JSON_MAX_DEPTH; i++) {
+        json[len++] = i & 1 ? '[' : '{';
+        if (!(i & 1)) {
+            memcpy(json + len, "\"k\":", 4);
+            len += 4;
+        }
+    }
+    json[len++] = '1';
+    for (int i = CZ_JSON_MAX_DEPTH - 1; i >= 0; i--) {
+        json[len++] = i & 1 ? ']' : '}';
+    }
+    json[len] = '\0';
+    CZ_CHECK(cz_parse_all(json) > 0, "depth %d rejected", CZ_JSON_MAX_DEPTH);
+
+    // 多一层
+    len = 0;
+    for (int i = 0; i <= CZ_JSON_MAX_DEPTH; i++) {
+        json[len++] = '[';
+    }
+    for (int i = 0; i <= CZ_JSON_MAX_DEPTH; i++) {
+        json[len++] = ']';
+    }
+    json[len] = '\0';
+    CZ_CHECK(cz_parse_all(json) == -1, "depth %d accepted", CZ_JSON_MAX_DEPTH + 1);
+
+    // 括号不匹配
+    CZ_CHECK(cz_parse_all("[[{}]]") == 6, "balanced brackets");
+    CZ_CHECK(cz_parse_all("[[{]]") == -1, "'{' closed by ']'");
+    CZ_CHECK(cz_parse_all("[{}}") == -1, "'[' closed by '}'");
+}
+
+#pragma mark - 不合法的输入
+
+static void cz_test_malformed(void) {
+    static const char *invalid[] = {
+        "",
+        "   ",
+        "{",
+        "[",
+        "}",
+        "]",
+        "[1,]",
+        "[,1]",
+        "[1 2]",
+        "[1,,2]",
+        "{,}",
+        "{\"a\"}",
+        "{\"a\":}",
+        "{\"a\" 1}",
+        "{\"a\":1,}",
+        "{\"a\":1 \"b\":2}",
+        "{1:2}",
+        "{a:1}",
+        "{'a':1}",
+        "\"abc",
+        "\"abc\\\"",
+        "\"abc\\",
+        "tru",
+        "truee",
+        "nul",
+        "fals",
+        "1 2",
+        "{} {}",
+        "[]]",
+        "null,",
+        "[true false]",
+    };
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        CZ_CHECK(cz_parse_all(invalid[i]) == -1, "malformed \"%s\" accepted", invalid[i]);
+    }
+
+    // 每个前缀都不完整
+    const char *json = "{\"list\":[{\"id\":1,\"name\":\"a\\\"b\"},null,true,-2.5e3]}";
+    size_t len = strlen(json);
+
+    for (size_t cut = 0; cut < len; cut++) {
+        cz_json_parser parser;
+        CZJSONToken token;
+
+        cz_json_init(&parser, json, cut);
+        do {
+            token = cz_json_next(&parser);
+        } while (token != CZJSONError && token != CZJSONEnd);
+
+        CZ_CHECK(token == CZJSONError, "prefix of %zu bytes accepted", cut);
+    }
+    CZ_CHECK(cz_parse_all(json) == 14, "complete document");
+
+    // 出错之后继续调用也只返回错误
+    cz_json_parser parser;
+    cz_json_init(&parser, "[1 2]", 5);
+    cz_json_next(&parser);
+    cz_json_next(&parser);
+    CZ_CHECK(cz_json_next(&parser) == CZJSONError && cz_json_next(&parser) == CZJSONError, "error is sticky");
+}
+
+#pragma mark - 原子
+
+static void cz_test_key_atoms(void) {
+    cz_atom chapter_id = cz_atom_intern("chapterId", 9);
+    cz_atom name = cz_atom_intern("\xe5\x90\x8d", 3);
+    const char *json = "{\"chapterId\": 1, \"chapter\\u0049d\": 2, \"\\u540d\": 3, \"unknown\": 4, \"bad\\u12\": 5}";
+    cz_json_parser parser;
+
+    CZ_CHECK(chapter_id != CZ_ATOM_NONE && name != CZ_ATOM_NONE, "intern keys");
+
+    cz_json_init(&parser, json, strlen(json));
+    cz_json_next(&parser);
+
+    static const int expected[] = { 1, 1, 2, 0, 0 };
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        CZ_CHECK(cz_json_next(&parser) == CZJSONKey, "atoms: key %zu", i);
+
+        cz_atom atom = cz_json_key_atom(&parser);
+        cz_atom want = expected[i] == 1 ? chapter_id : expected[i] == 2 ? name : CZ_ATOM_NONE;
+        CZ_CHECK(atom == want, "atoms: key %zu is %u, expected %u", i, atom, want);
+
+        cz_json_next(&parser);
+    }
+}
+
+int main(void) {
+    cz_test_tokens();
+    cz_test_skip();
+    cz_test_escapes();
+    cz_test_numbers();
+    cz_test_depth();
+    cz_test_malformed();
+    cz_test_key_atoms();
+
+    return cz_test_finish("test_json");
+}
@@ -0,0 +1,241 @@
+//
+//  test_percent.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_percent_encode / cz_percent_decode 与逐字节参考实现对照
+///
+/// 1. 每个字节值放在 16 字节分组的每个位置，覆盖高低 4 位查表的所有组合
+/// 2. 随机输入的编码、解码 (包括小写十六进制和原地解码)
+/// 3. 不合法的 '%' 转义，包括出现在分组边界上的
+///
+/// Makefile 在 x86 上还会用 -mssse3 编译一份，测试向量化的分组检查
+
+#include "cz_test.h"
+#include "cz_percent.h"
+
+/// URLQueryAllowedCharacterSet，与 cz_percent_table 分开写，作为参考
+static const char *cz_allowed = "!$&'()*+,-./:;=?@_~"
+                                "0123456789"
+                                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                "abcdefghijklmnopqrstuvwxyz";
+
+#pragma mark - 参考实现
+
+static int cz_ref_allowed(uint8_t c) {
+    return c != 0 && strchr(cz_allowed, c) != NULL;
+}
+
+static size_t cz_ref_encode(const uint8_t *bytes, size_t len, char *out) {
+    static const char hex[16] = "0123456789ABCDEF";
+    size_t k = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (cz_ref_allowed(bytes[i])) {
+            out[k++] = (char)bytes[i];
+        } else {
+            out[k++] = '%';
+            out[k++] = hex[bytes[i] >> 4];
+            out[k++] = hex[bytes[i] & 15];
+        }
+    }
+    return k;
+}
+
+static int cz_ref_hex(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static size_t cz_ref_decode(const char *str, size_t len, uint8_t *out) {
+    size_t k = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (str[i] != '%') {
+            out[k++] = (uint8_t)str[i];
+            continue;
+        }
+        if (i + 2 >= len || cz_ref_hex(str[i + 1]) < 0 || cz_ref_hex(str[i + 2]) < 0) {
+            return (size_t)-1;
+        }
+        out[k++] = (uint8_t)(cz_ref_hex(str[i + 1]) << 4 | cz_ref_hex(str[i + 2]));
+        i += 2;
+    }
+    return k;
+}
+
+#pragma mark - 编码
+
+static void cz_check_encode(const uint8_t *bytes, size_t len, const char *what) {
+    char *expected = malloc(len * 3 + 1);
+    char *actual = malloc(len * 3 + 1);
+    uint8_t *decoded = malloc(len + 1);
+
+    size_t n = cz_ref_encode(bytes, len, expected);
+    size_t m = cz_percent_encode(bytes, len, actual);
+    CZ_CHECK(n == m && memcmp(expected, actual, n) == 0, "encode %s (%zu bytes)", what, len);
+
+    // 编码结果能解码回原文
+    size_t d = cz_percent_decode(actual, m, decoded);
+    CZ_CHECK(d == len && memcmp(decoded, bytes, len) == 0, "round trip %s (%zu bytes)", what, len);
+
+    free(expected);
+    free(actual);
+    free(decoded);
+}
+
+/// 每个字节值放在 48 字节输入的每个位置，其余为不需要编码的字符
+static void cz_test_every_byte(void) {
+    uint8_t buffer[48];
+    char what[64];
+
+    for (int c = 0; c < 256; c++) {
+        CZ_CHECK(cz_percent_allowed((uint8_t)c) == cz_ref_allowed((uint8_t)c), "cz_percent_allowed(0x%02x)", c);
+
+        for (size_t position = 0; position < sizeof(buffer); position++) {
+            memset(buffer, 'a', sizeof(buffer));
+            buffer[position] = (uint8_t)c;
+
+            snprintf(what, sizeof(what), "byte 0x%02x at %zu", c, position);
+            cz_check_encode(buffer, sizeof(buffer), what);
+        }
+    }
+}
+
+/// 高低 4 位分别取边界值的两字节组合，整组 16 字节
+static void cz_test_nibble_pairs(void) {
+    static const uint8_t nibbles[] = { 0x0, 0x1, 0x7, 0x8, 0x9, 0xa, 0xe, 0xf };
+    uint8_t buffer[32];
+    char what[64];
+
+    for (size_t h = 0; h < 16; h++) {
+        for (size_t l = 0; l < sizeof(nibbles); l++) {
+            uint8_t c = (uint8_t)(h << 4 | nibbles[l]);
+
+            for (size_t i = 0; i < sizeof(buffer); i++) {
+                buffer[i] = i % 2 == 0 ? c : (uint8_t)(c ^ 0x10);
+            }
+            snprintf(what, sizeof(what), "pair 0x%02x/0x%02x", c, c ^ 0x10);
+            cz_check_encode(buffer, sizeof(buffer), what);
+        }
+    }
+}
+
+static void cz_test_random_encode(void) {
+    uint8_t bytes[300];
+    uint64_t state = 0xc0ffee;
+    size_t allowed = strlen(cz_allowed);
+
+    for (int round = 0; round < 200000; round++) {
+        size_t len = (size_t)(cz_test_random(&state) % sizeof(bytes));
+        int mode = (int)(cz_test_random(&state) % 3);
+
+        for (size_t i = 0; i < len; i++) {
+            uint64_t r = cz_test_random(&state);
+
+            if (mode == 0 || (mode == 2 && r % 20 == 0)) {
+                bytes[i] = (uint8_t)(r >> 56);
+            } else {
+                bytes[i] = (uint8_t)cz_allowed[(r >> 32) % allowed];
+            }
+        }
+        cz_check_encode(bytes, len, "random");
+    }
+}
+
+#pragma mark - 解码
+
+static void cz_check_decode(const char *str, size_t len, const char *what) {
+    uint8_t expected[512];
+    uint8_t actual[512];
+
+    size_t n = cz_ref_decode(str, len, expected);
+    size_t m = cz_percent_decode(str, len, actual);
+    CZ_CHECK(n == m && (n == (size_t)-1 || memcmp(expected, actual, n) == 0),
+             "decode %s: \"%.*s\" -> %ld, expected %ld", what, (int)len, str, (long)m, (long)n);
+
+    // 原地解码
+    char copy[512];
+    memcpy(copy, str, len);
+    m = cz_percent_decode(copy, len, (uint8_t *)copy);
+    CZ_CHECK(n == m && (n == (size_t)-1 || memcmp(expected, copy, n) == 0),
+             "in place decode %s: \"%.*s\"", what, (int)len, str);
+}
+
+static void cz_test_bad_escapes(void) {
+    // '%' 之后的字符刚好在 0-9 / A-F / a-f 范围之外
+    static const char *invalid[] = {
+        "%", "%4", "%zz", "a%4g", "%%41", "%G0", "%0G", "%g0", "%0g",
+        "%/0", "%:0", "%@0", "%`0", "%0/", "%0:", "%0@", "%0`",
+        "%\x80" "0", "%0\xc1", "% 1", "%+1", "%-1",
+    };
+    static const char *valid[] = {
+        "", "%41", "%4a", "%4A", "%fF", "%00", "a%2Fb", "%25%25", "plain", "+ +",
+    };
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        uint8_t out[16];
+        CZ_CHECK(cz_percent_decode(invalid[i], strlen(invalid[i]), out) == (size_t)-1, "\"%s\" should fail", invalid[i]);
+        cz_check_decode(invalid[i], strlen(invalid[i]), "invalid");
+    }
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        cz_check_decode(valid[i], strlen(valid[i]), "valid");
+    }
+
+    // 截断的转义出现在分组的每个位置
+    char str[64];
+    for (size_t position = 0; position < 40; position++) {
+        memset(str, 'x', position);
+        str[position] = '%';
+        str[position + 1] = '4';
+        cz_check_decode(str, position + 1, "truncated");
+        cz_check_decode(str, position + 2, "truncated");
+
+        str[position + 2] = '1';
+        cz_check_decode(str, position + 3, "complete");
+    }
+}
+
+static void cz_test_random_decode(void) {
+    static const char alphabet[] = "%%%0123456789abcdefABCDEFgxyz/+ ";
+    char str[200];
+    uint64_t state = 0xdec0de;
+
+    for (int round = 0; round < 200000; round++) {
+        size_t len = (size_t)(cz_test_random(&state) % sizeof(str));
+
+        for (size_t i = 0; i < len; i++) {
+            str[i] = alphabet[(cz_test_random(&state) >> 32) % (sizeof(alphabet) - 1)];
+        }
+        cz_check_decode(str, len, "random");
+    }
+}
+
+int main(void) {
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    printf("cz_percent span: neon\n");
+#elif defined(__SSSE3__)
+    printf("cz_percent span: ssse3\n");
+#else
+    printf("cz_percent span: scalar\n");
+#endif
+
+    cz_test_every_byte();
+    cz_test_nibble_pairs();
+    cz_test_random_encode();
+    cz_test_bad_escapes();
+    cz_test_random_decode();
+
+    return cz_test_finish("test_percent");
+}
@@ -0,0 +1,188 @@
+//
+//  test_sha.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_sha 各个实现的已知答案测试
+///
+/// 对当前平台可用的每个实现 (scalar / shani / armv8)：
+/// 1. 压缩函数与标量参考实现逐块对照
+/// 2. 通过 cz_sha_set_kernel 切换后，FIPS 180 向量和随机长度的输入与 CommonCrypto 对照
+
+#include "cz_test.h"
+#include "cz_sha.h"
+
+#include <CommonCrypto/CommonCrypto.h>
+
+static const char *cz_kernel_names[CZSHAKernelCount] = { "auto", "scalar", "shani", "armv8" };
+
+#pragma mark - 压缩函数
+
+static void cz_test_blocks(CZSHAKernel kernel) {
+    cz_sha1_blocks_fn sha1 = cz_sha1_blocks_for(kernel);
+    cz_sha256_blocks_fn sha256 = cz_sha256_blocks_for(kernel);
+
+    CZ_CHECK(sha1 != NULL && sha256 != NULL, "%s: missing blocks", cz_kernel_names[kernel]);
+    if (sha1 == NULL || sha256 == NULL) {
+        return;
+    }
+
+    uint8_t data[CZ_SHA_BLOCK_LENGTH * 17];
+
+    for (size_t nblocks = 1; nblocks <= 17; nblocks++) {
+        cz_test_fill(data, sizeof(data), nblocks);
+
+        uint32_t h1[5], r1[5];
+        uint32_t h2[8], r2[8];
+
+        for (int i = 0; i < 5; i++) {
+            h1[i] = r1[i] = (uint32_t)(0x01234567u * (i + 1));
+        }
+        for (int i = 0; i < 8; i++) {
+            h2[i] = r2[i] = (uint32_t)(0x89abcdefu * (i + 1));
+        }
+
+        sha1(h1, data, nblocks);
+        cz_sha1_blocks_ref(r1, data, nblocks);
+        CZ_CHECK(memcmp(h1, r1, sizeof(h1)) == 0, "%s: sha1 %zu blocks", cz_kernel_names[kernel], nblocks);
+
+        sha256(h2, data, nblocks);
+        cz_sha256_blocks_ref(r2, data, nblocks);
+        CZ_CHECK(memcmp(h2, r2, sizeof(h2)) == 0, "%s: sha256 %zu blocks", cz_kernel_names[kernel], nblocks);
+    }
+}
+
+#pragma mark - 完整散列
+
+typedef struct {
+    const char *message;
+    size_t      repeat;
+    const char *sha1;
+    const char *sha224;
+    const char *sha256;
+} cz_sha_vector;
+
+static const cz_sha_vector cz_vectors[] = {
+    { "", 1,
+        "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+        "d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f",
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", 1,
+        "a9993e364706816aba3e25717850c26c9cd0d89d",
+        "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7",
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+        "84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+        "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525",
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "a", 1000000,
+        "34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+        "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67",
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+};
+
+static void cz_test_vectors(CZSHAKernel kernel) {
+    const char *name = cz_kernel_names[kernel];
+
+    for (size_t v = 0; v < sizeof(cz_vectors) / sizeof(cz_vectors[0]); v++) {
+        const cz_sha_vector *vector = &cz_vectors[v];
+        size_t piece = strlen(vector->message);
+
+        cz_sha1_ctx sha1;
+        cz_sha256_ctx sha224, sha256;
+        cz_sha1_init(&sha1);
+        cz_sha224_init(&sha224);
+        cz_sha256_init(&sha256);
+
+        for (size_t i = 0; i < vector->repeat; i++) {
+            cz_sha1_update(&sha1, vector->message, piece);
+            cz_sha256_update(&sha224, vector->message, piece);
+            cz_sha256_update(&sha256, vector->message, piece);
+        }
+
+        uint8_t digest[CZ_SHA256_DIGEST_LENGTH];
+        char hex[2 * CZ_SHA256_DIGEST_LENGTH + 1];
+
+        cz_sha1_final(&sha1, digest);
+        cz_test_hex(digest, CZ_SHA1_DIGEST_LENGTH, hex);
+        CZ_CHECK(strcmp(hex, vector->sha1) == 0, "%s: sha1 vector %zu = %s", name, v, hex);
+
+        cz_sha256_final(&sha224, digest);
+        cz_test_hex(digest, CZ_SHA224_DIGEST_LENGTH, hex);
+        CZ_CHECK(strcmp(hex, vector->sha224) == 0, "%s: sha224 vector %zu = %s", name, v, hex);
+
+        cz_sha256_final(&sha256, digest);
+        cz_test_hex(digest, CZ_SHA256_DIGEST_LENGTH, hex);
+        CZ_CHECK(strcmp(hex, vector->sha256) == 0, "%s: sha256 vector %zu = %s", name, v, hex);
+    }
+}
+
+/// 随机长度、随机切分的输入与 CommonCrypto 对照
+static void cz_test_random_lengths(CZSHAKernel kernel) {
+    const char *name = cz_kernel_names[kernel];
+
+    uint8_t *data = malloc(4096);
+    uint64_t state = 0x5eed;
+
+    for (int round = 0; round < 2000; round++) {
+        size_t len = (size_t)(cz_test_random(&state) % 4096);
+        cz_test_fill(data, len, (uint64_t)round);
+
+        uint8_t expected[CC_SHA256_DIGEST_LENGTH];
+        uint8_t digest[CZ_SHA256_DIGEST_LENGTH];
+
+        // 一次输入
+        CC_SHA1(data, (CC_LONG)len, expected);
+        cz_sha1(data, len, digest);
+        CZ_CHECK(memcmp(digest, expected, CZ_SHA1_DIGEST_LENGTH) == 0, "%s: sha1 of %zu bytes", name, len);
+
+        CC_SHA256(data, (CC_LONG)len, expected);
+        cz_sha256(data, len, digest);
+        CZ_CHECK(memcmp(digest, expected, CZ_SHA256_DIGEST_LENGTH) == 0, "%s: sha256 of %zu bytes", name, len);
+
+        // 随机切分
+        cz_sha256_ctx ctx;
+        cz_sha256_init(&ctx);
+        for (size_t offset = 0; offset < len; ) {
+            size_t n = (size_t)(cz_test_random(&state) % 200);
+            if (n > len - offset) {
+                n = len - offset;
+            }
+            cz_sha256_update(&ctx, data + offset, n);
+            offset += n;
+        }
+        cz_sha256_final(&ctx, digest);
+        CZ_CHECK(memcmp(digest, expected, CZ_SHA256_DIGEST_LENGTH) == 0, "%s: split sha256 of %zu bytes", name, len);
+    }
+
+    free(data);
+}
+
+int main(void) {
+    printf("cz_sha auto kernel: %s\n", cz_sha_kernel_name());
+
+    for (int kernel = CZSHAKernelScalar; kernel < CZSHAKernelCount; kernel++) {
+        if (!cz_sha_kernel_available((CZSHAKernel)kernel)) {
+            CZ_CHECK(cz_sha_set_kernel((CZSHAKernel)kernel) == -1, "%s: set unavailable kernel", cz_kernel_names[kernel]);
+            printf("  %s: not available, skipped\n", cz_kernel_names[kernel]);
+            continue;
+        }
+
+        cz_test_blocks((CZSHAKernel)kernel);
+
+        CZ_CHECK(cz_sha_set_kernel((CZSHAKernel)kernel) == 0, "%s: set kernel", cz_kernel_names[kernel]);
+        CZ_CHECK(strcmp(cz_sha_kernel_name(), cz_kernel_names[kernel]) == 0, "%s: kernel name %s",
+                 cz_kernel_names[kernel], cz_sha_kernel_name());
+
+        cz_test_vectors((CZSHAKernel)kernel);
+        cz_test_random_lengths((CZSHAKernel)kernel);
+        printf("  %s: tested\n", cz_kernel_names[kernel]);
+    }
+
+    cz_sha_set_kernel(CZSHAKernelAuto);
+
+    return cz_test_finish("test_sha");
+}
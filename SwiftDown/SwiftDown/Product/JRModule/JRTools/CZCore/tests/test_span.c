@@ -0,0 +1,188 @@
+//
+//  test_span.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// 按 (指针, 长度) 散列含有 '\0' 的输入
+///
+/// NSString+CZHash / NSData+CZHash 最终都调用这里的接口，
+/// 结果必须覆盖完整长度，不能在第一个 '\0' 处截断
+
+#include "cz_test.h"
+#include "cz_batch.h"
+#include "cz_digest.h"
+#include "cz_fasthash.h"
+#include "cz_hmac.h"
+
+#include <CommonCrypto/CommonCrypto.h>
+
+/// 字符串字面量去掉结尾的 '\0'
+#define CZ_SPAN(s) { s, sizeof(s) - 1 }
+
+/// 含有 '\0' 的消息：开头、中间、结尾、连续多个
+static const struct {
+    const char *bytes;
+    size_t      len;
+} cz_messages[] = {
+    CZ_SPAN("\0"),
+    CZ_SPAN("\0abc"),
+    CZ_SPAN("a\0b"),
+    CZ_SPAN("abc\0"),
+    CZ_SPAN("\0\0\0\0\0\0\0\0"),
+    CZ_SPAN("\xe4\xb8\xad\0\xe6\x96\x87"),
+    CZ_SPAN("chapter\0body\0with\0several\0nul\0bytes\0inside\0a\0message\0longer\0than\0one\0block"),
+};
+
+#define CZ_MESSAGE_COUNT (sizeof(cz_messages) / sizeof(cz_messages[0]))
+
+static void cz_test_digest(void) {
+    uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+    uint8_t prefix[CZ_DIGEST_MAX_LENGTH];
+    uint8_t expected[CZ_DIGEST_MAX_LENGTH];
+
+    for (size_t m = 0; m < CZ_MESSAGE_COUNT; m++) {
+        const char *bytes = cz_messages[m].bytes;
+        size_t len = cz_messages[m].len;
+
+        for (int alg = 0; alg < CZDigestCount; alg++) {
+            size_t dlen = cz_digest_length(alg);
+
+            cz_digest((CZDigestAlgorithm)alg, bytes, len, digest);
+            cz_digest((CZDigestAlgorithm)alg, bytes, strlen(bytes), prefix);
+            CZ_CHECK(memcmp(digest, prefix, dlen) != 0, "alg %d message %zu truncated at NUL", alg, m);
+        }
+
+        CC_MD5((const uint8_t *)bytes, (CC_LONG)len, expected);
+        cz_digest(CZDigestMD5, bytes, len, digest);
+        CZ_CHECK(memcmp(digest, expected, CC_MD5_DIGEST_LENGTH) == 0, "md5 message %zu", m);
+
+        CC_SHA1((const uint8_t *)bytes, (CC_LONG)len, expected);
+        cz_digest(CZDigestSHA1, bytes, len, digest);
+        CZ_CHECK(memcmp(digest, expected, CC_SHA1_DIGEST_LENGTH) == 0, "sha1 message %zu", m);
+
+        CC_SHA256((const uint8_t *)bytes, (CC_LONG)len, expected);
+        cz_digest(CZDigestSHA256, bytes, len, digest);
+        CZ_CHECK(memcmp(digest, expected, CC_SHA256_DIGEST_LENGTH) == 0, "sha256 message %zu", m);
+
+        CC_SHA512((const uint8_t *)bytes, (CC_LONG)len, expected);
+        cz_digest(CZDigestSHA512, bytes, len, digest);
+        CZ_CHECK(memcmp(digest, expected, CC_SHA512_DIGEST_LENGTH) == 0, "sha512 message %zu", m);
+    }
+}
+
+/// 批量接口的每条结果与单条计算相同
+static void cz_test_batch(void) {
+    const void *msgs[CZ_MESSAGE_COUNT];
+    size_t lens[CZ_MESSAGE_COUNT];
+
+    for (size_t m = 0; m < CZ_MESSAGE_COUNT; m++) {
+        msgs[m] = cz_messages[m].bytes;
+        lens[m] = cz_messages[m].len;
+    }
+
+    for (int alg = 0; alg < CZDigestCount; alg++) {
+        size_t dlen = cz_digest_length(alg);
+        uint8_t out[CZ_MESSAGE_COUNT * CZ_DIGEST_MAX_LENGTH];
+        uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+
+        cz_batch_digest((CZDigestAlgorithm)alg, msgs, lens, CZ_MESSAGE_COUNT, out);
+
+        for (size_t m = 0; m < CZ_MESSAGE_COUNT; m++) {
+            cz_digest((CZDigestAlgorithm)alg, msgs[m], lens[m], digest);
+            CZ_CHECK(memcmp(out + m * dlen, digest, dlen) == 0, "batch alg %d message %zu", alg, m);
+        }
+    }
+}
+
+/// 一次计算与逐字节流式计算相同，且与截断后的前缀不同
+static void cz_test_fasthash(void) {
+    for (size_t m = 0; m < CZ_MESSAGE_COUNT; m++) {
+        const char *bytes = cz_messages[m].bytes;
+        size_t len = cz_messages[m].len;
+
+        cz_fasthash_state state;
+        cz_fasthash_init(&state, 0);
+        for (size_t i = 0; i < len; i++) {
+            cz_fasthash_update(&state, bytes + i, 1);
+        }
+
+        uint64_t hash = cz_fasthash64(bytes, len, 0);
+        CZ_CHECK(cz_fasthash_final64(&state) == hash, "fasthash streaming message %zu", m);
+        CZ_CHECK(cz_fasthash64(bytes, strlen(bytes), 0) != hash, "fasthash message %zu truncated at NUL", m);
+
+        cz_hash128 h128 = cz_fasthash128(bytes, len, 0);
+        cz_hash128 s128 = cz_fasthash_final128(&state);
+        CZ_CHECK(memcmp(&h128, &s128, sizeof(h128)) == 0, "fasthash128 streaming message %zu", m);
+    }
+
+    // 字节顺序与内存布局无关
+    cz_hash128 hash = { 0x8899aabbccddeeffull, 0x0011223344556677ull };
+    uint8_t bytes[16];
+    char hex[33];
+
+    cz_hash128_to_bytes(hash, bytes);
+    cz_test_hex(bytes, sizeof(bytes), hex);
+    CZ_CHECK(strcmp(hex, "00112233445566778899aabbccddeeff") == 0, "cz_hash128_to_bytes: %s", hex);
+}
+
+/// 按 RFC 2104 用 cz_digest 逐步计算 HMAC，作为对照
+static void cz_ref_hmac(CZDigestAlgorithm alg, const uint8_t *key, size_t key_len,
+                        const void *data, size_t len, uint8_t *out) {
+    size_t block = cz_hmac_block_length(alg);
+    size_t dlen = cz_digest_length(alg);
+    uint8_t k[128] = { 0 };
+    uint8_t pad[128];
+    uint8_t inner[CZ_DIGEST_MAX_LENGTH];
+
+    memcpy(k, key, key_len);
+
+    cz_digest_ctx ctx;
+
+    for (size_t i = 0; i < block; i++) {
+        pad[i] = k[i] ^ 0x36;
+    }
+    cz_digest_init(&ctx, alg);
+    cz_digest_update(&ctx, pad, block);
+    cz_digest_update(&ctx, data, len);
+    cz_digest_final(&ctx, inner);
+
+    for (size_t i = 0; i < block; i++) {
+        pad[i] = k[i] ^ 0x5c;
+    }
+    cz_digest_init(&ctx, alg);
+    cz_digest_update(&ctx, pad, block);
+    cz_digest_update(&ctx, inner, dlen);
+    cz_digest_final(&ctx, out);
+}
+
+static void cz_test_hmac(void) {
+    static const uint8_t secret[] = "api\0key";
+    static const CZDigestAlgorithm algs[] = { CZDigestMD5, CZDigestSHA1, CZDigestSHA256, CZDigestSHA512 };
+
+    for (size_t a = 0; a < sizeof(algs) / sizeof(algs[0]); a++) {
+        cz_hmac_key key;
+        cz_hmac_key_init(&key, algs[a], secret, sizeof(secret) - 1);
+
+        for (size_t m = 0; m < CZ_MESSAGE_COUNT; m++) {
+            uint8_t digest[CZ_DIGEST_MAX_LENGTH];
+            uint8_t expected[CZ_DIGEST_MAX_LENGTH];
+
+            cz_hmac(&key, cz_messages[m].bytes, cz_messages[m].len, digest);
+            cz_ref_hmac(algs[a], secret, sizeof(secret) - 1, cz_messages[m].bytes, cz_messages[m].len, expected);
+
+            CZ_CHECK(memcmp(digest, expected, cz_digest_length(algs[a])) == 0, "hmac alg %d message %zu", algs[a], m);
+        }
+    }
+}
+
+int main(void) {
+    cz_test_digest();
+    cz_test_batch();
+    cz_test_fasthash();
+    cz_test_hmac();
+
+    return cz_test_finish("test_span");
+}
@@ -0,0 +1,108 @@
+//
+//  test_string_hash.m
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// NSString+CZHash 对含有 '\0' 和非 UTF8 字符的字符串的结果 (只在 macOS 上编译)
+///
+/// 字符串散列必须等于它完整 UTF8 字节的散列：
+/// 不在第一个 '\0' 处截断，分段转码跨过缓冲区边界时结果不变，
+/// 单独的代理项与 -dataUsingEncoding:allowLossyConversion:YES 一样按有损转换处理
+
+#import <Foundation/Foundation.h>
+
+#import "cz_test.h"
+#import "NSString+CZHash.h"
+#import "NSData+CZHash.h"
+#import "CZHmac.h"
+
+static NSString *CZStringWithCharacters(const unichar *characters, NSUInteger length) {
+    return [NSString stringWithCharacters:characters length:length];
+}
+
+/// 与 string 的 UTF8 字节 (有损转换) 直接计算的结果对照
+static void CZCheckString(NSString *string, const char *what) {
+    NSData *utf8 = [string dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES];
+
+    for (CZHashAlgorithm algorithm = CZHashAlgorithmMD5; algorithm <= CZHashAlgorithmSHA512; algorithm++) {
+        NSString *hash = [string cz_hashStringWithAlgorithm:algorithm];
+        NSString *expected = [utf8 cz_hashStringWithAlgorithm:algorithm];
+
+        CZ_CHECK([hash isEqualToString:expected], "%s: algorithm %lu", what, (unsigned long)algorithm);
+
+        NSData *batch = [NSString cz_batchHashes:@[string, @"x", string] algorithm:algorithm];
+        NSData *single = [string cz_hashWithAlgorithm:algorithm];
+        NSUInteger length = single.length;
+
+        CZ_CHECK([[batch subdataWithRange:NSMakeRange(0, length)] isEqualToData:single] &&
+                 [[batch subdataWithRange:NSMakeRange(2 * length, length)] isEqualToData:single],
+                 "%s: batch algorithm %lu", what, (unsigned long)algorithm);
+    }
+
+    CZ_CHECK(string.cz_fastHash == utf8.cz_fastHash, "%s: fast hash", what);
+
+    // HMAC 与直接对 UTF8 字节计算的结果相同
+    NSData *hmac = [[CZHmac sharedHmacWithKey:@"key" algorithm:CZHashAlgorithmSHA256] hmacForData:utf8];
+    char hex[2 * 32 + 1];
+    cz_test_hex(hmac.bytes, hmac.length, hex);
+
+    CZ_CHECK([[string cz_hmacSHA256StringWithKey:@"key"] isEqualToString:[NSString stringWithUTF8String:hex]], "%s: hmac", what);
+}
+
+static void CZTestEmbeddedNUL(void) {
+    // ASCII 存储，走 CFStringGetCStringPtr
+    const unichar ascii[] = { 'a', 0, 'b' };
+    NSString *string = CZStringWithCharacters(ascii, 3);
+
+    CZ_CHECK(![string.cz_sha256String isEqualToString:@"a".cz_sha256String], "NUL truncated the input");
+    CZ_CHECK([string.cz_sha256String isEqualToString:[[NSData dataWithBytes:"a\0b" length:3] cz_hashStringWithAlgorithm:CZHashAlgorithmSHA256]],
+             "sha256 of a\\0b");
+    CZCheckString(string, "a\\0b");
+
+    // 开头、结尾的 '\0'
+    const unichar edges[] = { 0, 'x', 0 };
+    CZCheckString(CZStringWithCharacters(edges, 3), "\\0x\\0");
+
+    // 非 ASCII，走分段转码
+    const unichar chinese[] = { 0x4e2d, 0, 0x6587 };
+    CZCheckString(CZStringWithCharacters(chinese, 3), "中\\0文");
+}
+
+static void CZTestLongStrings(void) {
+    const unichar zero = 0;
+    NSString *nul = CZStringWithCharacters(&zero, 1);
+
+    // 多字节字符跨过 4096 字节的转码缓冲区
+    NSMutableString *string = [NSMutableString string];
+    for (int i = 0; i < 3000; i++) {
+        [string appendString:i % 7 == 0 ? nul : @"章"];
+    }
+    CZCheckString(string, "long non-ASCII with NUL");
+
+    NSMutableString *ascii = [NSMutableString string];
+    for (int i = 0; i < 10000; i++) {
+        [ascii appendString:i % 5 == 0 ? nul : @"a"];
+    }
+    CZCheckString(ascii, "long ASCII with NUL");
+}
+
+static void CZTestLoneSurrogate(void) {
+    // 单独的代理项不能转为 UTF8，整个字符串仍然参与计算
+    const unichar lone[] = { 'x', 0xd800, 'y', 0, 'z' };
+    NSString *string = CZStringWithCharacters(lone, 5);
+
+    CZ_CHECK(![string.cz_md5String isEqualToString:CZStringWithCharacters(lone, 1).cz_md5String], "lone surrogate truncated the input");
+    CZCheckString(string, "lone surrogate");
+}
+
+int main(void) {
+    @autoreleasepool {
+        CZTestEmbeddedNUL();
+        CZTestLongStrings();
+        CZTestLoneSurrogate();
+    }
+    return cz_test_finish("test_string_hash");
+}
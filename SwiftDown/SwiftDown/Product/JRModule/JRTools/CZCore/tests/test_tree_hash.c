@@ -0,0 +1,181 @@
+//
+//  test_tree_hash.c
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/31.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+/// cz_tree_hash 的树形散列和证明路径
+///
+/// 1. 叶子、节点与 CommonCrypto 按定义拼出的 SHA256 对照
+/// 2. 1 ~ CZ_MAX_LEAVES 个叶子的根与逐层新建数组的参考实现对照
+/// 3. 每个叶子的证明路径都能校验通过；篡改叶子、证明节点、序号、根或证明长度都不能通过
+
+#include "cz_test.h"
+#include "cz_tree_hash.h"
+
+#include <CommonCrypto/CommonCrypto.h>
+
+#define CZ_MAX_LEAVES   70
+
+static void cz_ref_leaf(const uint8_t *chunk, size_t len, uint8_t out[CZ_TREE_HASH_LENGTH]) {
+    uint8_t buffer[1 + 256];
+
+    buffer[0] = 0x00;
+    memcpy(buffer + 1, chunk, len);
+    CC_SHA256(buffer, (CC_LONG)(1 + len), out);
+}
+
+static void cz_ref_node(const uint8_t *left, const uint8_t *right, uint8_t out[CZ_TREE_HASH_LENGTH]) {
+    uint8_t buffer[1 + 2 * CZ_TREE_HASH_LENGTH];
+
+    buffer[0] = 0x01;
+    memcpy(buffer + 1, left, CZ_TREE_HASH_LENGTH);
+    memcpy(buffer + 1 + CZ_TREE_HASH_LENGTH, right, CZ_TREE_HASH_LENGTH);
+    CC_SHA256(buffer, (CC_LONG)sizeof(buffer), out);
+}
+
+/// 每层新建一个数组，两两合并，落单的节点复制到上一层
+static void cz_ref_root(const uint8_t *leaves, size_t count, uint8_t root[CZ_TREE_HASH_LENGTH]) {
+    uint8_t level[CZ_MAX_LEAVES][CZ_TREE_HASH_LENGTH];
+    uint8_t next[CZ_MAX_LEAVES][CZ_TREE_HASH_LENGTH];
+    size_t n = count;
+
+    memcpy(level, leaves, count * CZ_TREE_HASH_LENGTH);
+    while (n > 1) {
+        size_t m = 0;
+
+        for (size_t i = 0; i < n; i += 2, m++) {
+            if (i + 1 < n) {
+                cz_ref_node(level[i], level[i + 1], next[m]);
+            } else {
+                memcpy(next[m], level[i], CZ_TREE_HASH_LENGTH);
+            }
+        }
+        memcpy(level, next, m * CZ_TREE_HASH_LENGTH);
+        n = m;
+    }
+    memcpy(root, level[0], CZ_TREE_HASH_LENGTH);
+}
+
+static void cz_test_chunk_count(void) {
+    CZ_CHECK(cz_tree_chunk_count(0) == 1, "empty file is one chunk");
+    CZ_CHECK(cz_tree_chunk_count(1) == 1, "1 byte");
+    CZ_CHECK(cz_tree_chunk_count(CZ_TREE_CHUNK_SIZE) == 1, "one full chunk");
+    CZ_CHECK(cz_tree_chunk_count(CZ_TREE_CHUNK_SIZE + 1) == 2, "one chunk + 1 byte");
+    CZ_CHECK(cz_tree_chunk_count(5ULL * CZ_TREE_CHUNK_SIZE) == 5, "5 chunks");
+}
+
+static void cz_test_leaf_node(void) {
+    uint8_t chunk[256];
+    uint8_t leaf[CZ_TREE_HASH_LENGTH], expected[CZ_TREE_HASH_LENGTH];
+
+    cz_test_fill(chunk, sizeof(chunk), 1);
+    for (size_t len = 0; len <= sizeof(chunk); len += 37) {
+        cz_tree_leaf(chunk, len, leaf);
+        cz_ref_leaf(chunk, len, expected);
+        CZ_CHECK(memcmp(leaf, expected, CZ_TREE_HASH_LENGTH) == 0, "leaf of %zu bytes", len);
+    }
+
+    // 叶子和节点的前缀不同，同样的 64 字节作为块和作为两个子节点结果不同
+    uint8_t node[CZ_TREE_HASH_LENGTH];
+    cz_tree_node(chunk, chunk + CZ_TREE_HASH_LENGTH, node);
+    cz_ref_node(chunk, chunk + CZ_TREE_HASH_LENGTH, expected);
+    CZ_CHECK(memcmp(node, expected, CZ_TREE_HASH_LENGTH) == 0, "node");
+
+    cz_tree_leaf(chunk, 2 * CZ_TREE_HASH_LENGTH, leaf);
+    CZ_CHECK(memcmp(node, leaf, CZ_TREE_HASH_LENGTH) != 0, "node and leaf share a prefix");
+}
+
+static void cz_test_count(size_t count) {
+    uint8_t leaves[CZ_MAX_LEAVES * CZ_TREE_HASH_LENGTH];
+    uint8_t root[CZ_TREE_HASH_LENGTH], expected[CZ_TREE_HASH_LENGTH];
+    uint8_t proof[CZ_TREE_MAX_PROOF * CZ_TREE_HASH_LENGTH];
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t chunk[64];
+
+        // cz_test_fill 会把种子的最低位置 1，用奇数种子保证各块不同
+        cz_test_fill(chunk, sizeof(chunk), 2 * (count * 1000 + i) + 1);
+        cz_tree_leaf(chunk, sizeof(chunk), leaves + i * CZ_TREE_HASH_LENGTH);
+    }
+
+    CZ_CHECK(cz_tree_root(leaves, count, root) == 0, "%zu leaves: root failed", count);
+    cz_ref_root(leaves, count, expected);
+    CZ_CHECK(memcmp(root, expected, CZ_TREE_HASH_LENGTH) == 0, "%zu leaves: root differs", count);
+
+    // 树高 ceil(log2(count))
+    int height = 0;
+    while (((size_t)1 << height) < count) {
+        height++;
+    }
+
+    for (size_t index = 0; index < count; index++) {
+        const uint8_t *leaf = leaves + index * CZ_TREE_HASH_LENGTH;
+        int n = cz_tree_proof(leaves, count, index, proof);
+
+        CZ_CHECK(n >= 0 && n <= height, "%zu leaves, index %zu: proof length %d", count, index, n);
+        if (n < 0) {
+            continue;
+        }
+        CZ_CHECK(cz_tree_verify(leaf, index, count, proof, (size_t)n, root) == 1,
+                 "%zu leaves, index %zu: proof rejected", count, index);
+
+        // 篡改叶子
+        uint8_t tampered[CZ_TREE_HASH_LENGTH];
+        memcpy(tampered, leaf, CZ_TREE_HASH_LENGTH);
+        tampered[index % CZ_TREE_HASH_LENGTH] ^= 0x01;
+        CZ_CHECK(cz_tree_verify(tampered, index, count, proof, (size_t)n, root) == 0,
+                 "%zu leaves, index %zu: tampered leaf accepted", count, index);
+
+        // 篡改根
+        uint8_t wrong_root[CZ_TREE_HASH_LENGTH];
+        memcpy(wrong_root, root, CZ_TREE_HASH_LENGTH);
+        wrong_root[CZ_TREE_HASH_LENGTH - 1] ^= 0x80;
+        CZ_CHECK(cz_tree_verify(leaf, index, count, proof, (size_t)n, wrong_root) == 0,
+                 "%zu leaves, index %zu: wrong root accepted", count, index);
+
+        // 篡改每一个证明节点
+        for (int k = 0; k < n; k++) {
+            proof[k * CZ_TREE_HASH_LENGTH] ^= 0x01;
+            CZ_CHECK(cz_tree_verify(leaf, index, count, proof, (size_t)n, root) == 0,
+                     "%zu leaves, index %zu: tampered proof node %d accepted", count, index, k);
+            proof[k * CZ_TREE_HASH_LENGTH] ^= 0x01;
+        }
+
+        // 证明路径少一个、多一个节点
+        if (n > 0) {
+            CZ_CHECK(cz_tree_verify(leaf, index, count, proof, (size_t)n - 1, root) == 0,
+                     "%zu leaves, index %zu: short proof accepted", count, index);
+        }
+        memcpy(proof + n * CZ_TREE_HASH_LENGTH, root, CZ_TREE_HASH_LENGTH);
+        CZ_CHECK(cz_tree_verify(leaf, index, count, proof, (size_t)n + 1, root) == 0,
+                 "%zu leaves, index %zu: long proof accepted", count, index);
+
+        // 叶子换到别的位置
+        if (count > 1) {
+            size_t other = (index + 1) % count;
+            CZ_CHECK(cz_tree_verify(leaf, other, count, proof, (size_t)n, root) == 0,
+                     "%zu leaves, index %zu: accepted at index %zu", count, index, other);
+        }
+    }
+
+    // 越界的序号
+    CZ_CHECK(cz_tree_proof(leaves, count, count, proof) == -1, "%zu leaves: proof past the end", count);
+    CZ_CHECK(cz_tree_verify(leaves, count, count, proof, 0, root) == 0, "%zu leaves: verify past the end", count);
+}
+
+int main(void) {
+    cz_test_chunk_count();
+    cz_test_leaf_node();
+
+    for (size_t count = 1; count <= CZ_MAX_LEAVES; count++) {
+        cz_test_count(count);
+    }
+
+    uint8_t root[CZ_TREE_HASH_LENGTH];
+    CZ_CHECK(cz_tree_root(NULL, 0, root) == -1, "root of no leaves");
+
+    return cz_test_finish("test_tree_hash");
+}
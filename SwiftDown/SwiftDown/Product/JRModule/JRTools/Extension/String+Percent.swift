@@ -0,0 +1,53 @@
+//
+//  String+Percent.swift
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/29.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+import Foundation
+
+extension String {
+	
+	/// 百分号编码，结果与 addingPercentEncoding(withAllowedCharacters: .urlQueryAllowed) 相同
+	///
+	/// 使用 cz_percent_encode 按 16 字节一组分类，不需要编码的部分整段复制
+	var cz_percentEncoded: String {
+		
+		let bytes = Array(utf8)
+		if bytes.isEmpty {
+			return self
+		}
+		
+		/// 缓冲区多留一个 '\0'
+		var out = [CChar](repeating: 0, count: bytes.count * 3 + 1)
+		cz_percent_encode(bytes, bytes.count, &out)
+		
+		return String(cString: out)
+	}
+	
+	/// 百分号解码，结果与 removingPercentEncoding 相同
+	///
+	/// '%' 之后不是两位十六进制，或解码后不是合法的 UTF8 时返回 nil
+	var cz_percentDecoded: String? {
+		
+		let chars = Array(utf8)
+		if chars.isEmpty {
+			return self
+		}
+		
+		var out = [UInt8](repeating: 0, count: chars.count)
+		let length: Int = chars.withUnsafeBufferPointer { (buffer) -> Int in
+			return buffer.baseAddress!.withMemoryRebound(to: CChar.self, capacity: buffer.count) { (str) -> Int in
+				return cz_percent_decode(str, buffer.count, &out)
+			}
+		}
+		
+		/// 解码失败时返回 (size_t)-1
+		if length < 0 {
+			return nil
+		}
+		return String(bytes: out[0..<length], encoding: .utf8)
+	}
+}
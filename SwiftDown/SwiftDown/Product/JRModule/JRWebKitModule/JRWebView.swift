@@ -45,7 +45,7 @@ extension JRWebView {
 	func webViewNativeAction(jscontent: String) {
 		/// URL 解码
 //		delegate?.openTestVC!(js_Content: jscontent.removingPercentEncoding!)
-		jsOperation(jsString: jscontent.removingPercentEncoding!)
+		jsOperation(jsString: jscontent.cz_percentDecoded!)
 	}
 	
 	/// js 操作处理
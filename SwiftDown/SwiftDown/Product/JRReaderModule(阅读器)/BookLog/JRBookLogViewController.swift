@@ -13,11 +13,11 @@ class JRBookLogViewController: JRBaseViewController {
 	/// tableView
 	var tableView: UITableView?
 	
-	/// 目录数组
-	var logArray:[JRBookChapterModel] = [JRBookChapterModel]() {
+	/// 目录
+	var directory: JRChapterDirectory = JRChapterDirectory() {
 		
 		didSet {
-			if logArray.count > 0 {
+			if directory.count > 0 {
 				tableView?.reloadData()
 			}
 		}
@@ -50,15 +50,13 @@ extension JRBookLogViewController {
 extension JRBookLogViewController: UITableViewDataSource, UITableViewDelegate {
 	
 	func tableView(_ tableView: UITableView, numberOfRowsInSection section: Int) -> Int {
-		return logArray.count
+		return directory.count
 	}
 	
 	func tableView(_ tableView: UITableView, cellForRowAt indexPath: IndexPath) -> UITableViewCell {
 		let cell = tableView.dequeueReusableCell(withIdentifier: "logCell")
 		
-		let model:JRBookChapterModel = logArray[indexPath.row]
-		
-		let name = model.name ?? ""
+		let name = directory[indexPath.row].name
 		
 		cell?.textLabel?.text = "\(indexPath.row)、\(name)"
 		
@@ -24,8 +24,10 @@ class JRReaderViewController: JRBaseViewController {
 	
 	/// 书籍模型
 	var bookModel: JRInternalBookModel?
-	/// 章节模型
-	var chapterList: [JRBookChapterModel]?
+	/// 书籍目录
+	var directory: JRChapterDirectory?
+	/// 已经打开过的章节模型 [章节索引: 模型]，保存分页和下载状态
+	var chapterModels = [Int: JRBookChapterModel]()
 	
 	
 	/// 头部View
@@ -58,15 +60,16 @@ extension JRReaderViewController {
 		else { return }
 
 		/// 获取 bookID 加载书籍目录
-		JRBookServer.loadBookLog(bookId: bookId) { (models: [JRBookChapterModel]?, isSuccess: Bool) in
+		JRBookServer.loadBookDirectory(bookId: bookId) { (directory: JRChapterDirectory?, isSuccess: Bool) in
 			guard
-				let list = models
+				let directory = directory
 			else { return }
-			self.chapterList = list
+			self.directory = directory
+			self.chapterModels.removeAll()
 			/// 567556
 			/// 下载第一章节
-			let model:JRBookChapterModel = list.first!
-			let chapters = [list[0], list[1], list[2]]
+			let model:JRBookChapterModel = self.chapterModel(at: 0)!
+			let chapters = [model, self.chapterModel(at: 1)!, self.chapterModel(at: 2)!]
 
 			/// 下载前三章节
 			JRBookServer.loadChapter(bookId: model.bookId!, chapters: chapters, completion: { (isSuccess:Bool) in
@@ -74,6 +77,26 @@ extension JRReaderViewController {
 			})
 		}
 	}
+	
+	/// 取得章节模型，第一次访问时从目录创建
+	///
+	/// - Parameter index: 章节索引
+	/// - Returns: 章节模型，目录未加载或索引越界时返回 nil
+	func chapterModel(at index: Int) -> JRBookChapterModel? {
+		
+		if let model = chapterModels[index] {
+			return model
+		}
+		
+		guard
+			let directory = directory,
+			index >= 0 && index < directory.count
+		else { return nil }
+		
+		let model = directory[index].makeModel()
+		chapterModels[index] = model
+		return model
+	}
 }
 
 // MARK: - 初始化界面
@@ -137,13 +160,11 @@ extension JRReaderViewController: UICollectionViewDataSource, UICollectionViewDe
 	func collectionView(_ collectionView: UICollectionView, numberOfItemsInSection section: Int) -> Int {
 		
 		guard
-		let list = chapterList
+		let model = chapterModel(at: section + chapterOffset)
 		else {
 			return 1
 		}
 		
-		let model = list[section + chapterOffset]
-		
 		if model.pageList != nil && (model.pageList?.count)! > 0 {
 			return (model.pageList?.count)!
 		}
@@ -160,12 +181,12 @@ extension JRReaderViewController: UICollectionViewDataSource, UICollectionViewDe
 		} else {
 			cell.backgroundColor = UIColor.yellow
 		}
-		if chapterList != nil {
-			if ((chapterList?.count)! + chapterOffset) > indexPath.section {
-				let model:JRBookChapterModel = chapterList![indexPath.section + chapterOffset]
+		if let directory = directory {
+			if (directory.count + chapterOffset) > indexPath.section {
+				let model:JRBookChapterModel = chapterModel(at: indexPath.section + chapterOffset)!
 				cell.label.text = model.name
 				cell.chapterModel = model
-				cell.index = chapterList?.index(of: model)
+				cell.index = indexPath.section + chapterOffset
 				
 				if model.isDowload {
 					
@@ -395,7 +416,7 @@ extension JRReaderViewController: UICollectionViewDataSource, UICollectionViewDe
 		var numb = 0
 		
 		for i in chapterOffset..<chapterOffset + count {
-			let model = chapterList?[i]
+			let model = chapterModel(at: i)
 			
 			if model?.pageList == nil {
 				numb = numb + 1
@@ -413,7 +434,7 @@ extension JRReaderViewController: UICollectionViewDataSource, UICollectionViewDe
 	func loadNewChapter(index: Int) {
 		
 		///
-		let model:JRBookChapterModel = (chapterList?[index])!
+		let model:JRBookChapterModel = chapterModel(at: index)!
 		
 		if model.isDowload {
 			return
@@ -466,7 +487,7 @@ extension JRReaderViewController: JRBookReadBottomViewDelegate {
 		bottomView.appear = false
 		
 		let logVC = JRBookLogViewController()
-		logVC.logArray = chapterList!
+		logVC.directory = directory!
 		navigationController?.pushViewController(logVC, animated: true)
 	}
 	
@@ -11,32 +11,29 @@ import UIKit
 class JRBookServer: NSObject {
 
 	
-	/// 加载书籍目录
+	/// 加载按列存储的书籍目录
 	///
 	/// - Parameters:
 	///   - bookId: 书籍ID
 	///   - completion: 加载完成回调
-	static func loadBookLog(bookId: String, completion: @escaping (_ json: [JRBookChapterModel]?, _ isSuccess: Bool) -> ()) {
+	static func loadBookDirectory(bookId: String, completion: @escaping (_ directory: JRChapterDirectory?, _ isSuccess: Bool) -> ()) {
 		
 		let param:[String : Any] = ["bookId" : bookId]
 		
-		JRNetWorkManager.shared.myRequest(JRIgnoreFile.Url_kbookLog,
-		                                  parameters: param) { (json: AnyObject?, isSuccess: Bool) in
+		/// 目录有效期内直接使用磁盘缓存，过期后条件请求
+		JRNetWorkManager.shared.myCachedRequest(JRIgnoreFile.Url_kbookLog,
+		                                        parameters: param,
+		                                        maxAge: 600) { (data: Data?, isSuccess: Bool) in
 			
-											if !isSuccess || json == nil {
-												return
-											}
-											
-			let list:[String : Any] = json as! [String : Any]
-
-			let dic:[String : Any] = list["result"] as! [String : Any]
-			let data:[[String: Any]] = dic["chapterList"] as! [[String: Any]]
+			guard isSuccess, let data = data else {
+				completion(nil, false)
+				return
+			}
 			
-			let array = NSArray.yy_modelArray(with: JRBookChapterModel.self, json: data)
-			///
-			completion(array as? [JRBookChapterModel], isSuccess)
+			/// 直接从响应数据写入各列，不创建章节模型
+			let directory = JRChapterDirectory(data: data)
+			completion(directory, directory != nil)
 		}
-		
 	}
 
 	/// 加载章节内容
@@ -0,0 +1,246 @@
+//
+//  JRChapterDirectory.swift
+//  SwiftDown
+//
+//  Created by 王潇 on 2017/10/27.
+//  Copyright © 2017年 王潇. All rights reserved.
+//
+
+import UIKit
+
+/// 按列存储的书籍目录
+///
+/// 每一列是一个连续的数组，章节名称全部放在一块 UTF8 字符串区中，
+/// 标记按位保存；一章大约占 20 字节加上名称本身，不再为每章创建一个 NSObject
+struct JRChapterDirectory {
+
+	/// 书籍ID
+	private(set) var bookId: String = ""
+
+	/// 章节ID
+	fileprivate var chapterIds = [Int64]()
+	/// 章节字数
+	fileprivate var wordCounts = [Int32]()
+	/// 章节价格
+	fileprivate var prices = [Float]()
+	/// 章节名称字符串区，第 i 章为 nameArena[nameOffsets[i] ..< nameOffsets[i + 1]]
+	fileprivate var nameArena = [UInt8]()
+	fileprivate var nameOffsets: [UInt32] = [0]
+	/// 是否是VIP
+	fileprivate var vipFlags = JRBitSet()
+	/// 章节是否已经购买
+	fileprivate var purchasedFlags = JRBitSet()
+
+	init() {
+	}
+
+	/// 直接从目录接口的响应数据创建，不生成字典和章节模型
+	///
+	/// - Parameter data: 目录接口返回的 JSON 数据
+	init?(data: Data) {
+
+		var directory = JRChapterDirectory()
+
+		/// 临时记录逐个解码、逐个释放
+		let success = CZJSONModelDecoder.enumerateObjects(of: JRChapterRecord.self, from: data, keyPath: "result.chapterList") { (object, stop) in
+			guard
+				let record = object as? JRChapterRecord
+			else { return }
+			directory.append(record)
+		}
+
+		if !success {
+			return nil
+		}
+		self = directory
+	}
+
+	/// 从已有的章节模型创建
+	init(models: [JRBookChapterModel]) {
+		reserveCapacity(models.count)
+		for model in models {
+			append(bookId: model.bookId,
+			       chapterId: Int64(model.chapterId ?? "") ?? 0,
+			       name: model.name ?? "",
+			       wordCount: model.wordCount,
+			       price: Float(model.actualPrice ?? 0),
+			       isVip: model.isVip ?? false,
+			       isPurchased: model.status)
+		}
+	}
+
+	/// 追加一章
+	mutating func append(bookId: String?,
+	                     chapterId: Int64,
+	                     name: String,
+	                     wordCount: Int,
+	                     price: Float,
+	                     isVip: Bool,
+	                     isPurchased: Bool) {
+
+		if self.bookId.isEmpty, let bookId = bookId {
+			self.bookId = bookId
+		}
+
+		let index = chapterIds.count
+
+		chapterIds.append(chapterId)
+		wordCounts.append(Int32(min(max(wordCount, 0), Int(Int32.max))))
+		prices.append(price)
+		nameArena.append(contentsOf: name.utf8)
+		nameOffsets.append(UInt32(nameArena.count))
+		vipFlags.set(index, isVip)
+		purchasedFlags.set(index, isPurchased)
+	}
+
+	/// 按章节数预留空间
+	mutating func reserveCapacity(_ capacity: Int) {
+		chapterIds.reserveCapacity(capacity)
+		wordCounts.reserveCapacity(capacity)
+		prices.reserveCapacity(capacity)
+		nameOffsets.reserveCapacity(capacity + 1)
+	}
+
+	fileprivate mutating func append(_ record: JRChapterRecord) {
+		append(bookId: record.bookId,
+		       chapterId: record.chapterId,
+		       name: record.name ?? "",
+		       wordCount: record.wordCount,
+		       price: Float(record.actualPrice),
+		       isVip: record.isVip,
+		       isPurchased: record.status)
+	}
+}
+
+// MARK: - 按索引访问
+extension JRChapterDirectory: RandomAccessCollection {
+
+	typealias Indices = CountableRange<Int>
+
+	var startIndex: Int {
+		return 0
+	}
+
+	var endIndex: Int {
+		return chapterIds.count
+	}
+
+	var indices: CountableRange<Int> {
+		return startIndex..<endIndex
+	}
+
+	func index(after i: Int) -> Int {
+		return i + 1
+	}
+
+	func index(before i: Int) -> Int {
+		return i - 1
+	}
+
+	/// O(1) 取得第 position 章的视图，只在读取名称时解码字符串
+	subscript(position: Int) -> JRChapterEntry {
+		return JRChapterEntry(directory: self, index: position)
+	}
+
+	/// 章节ID对应的索引
+	func index(ofChapterId chapterId: Int64) -> Int? {
+		return chapterIds.index(of: chapterId)
+	}
+}
+
+/// 目录中一章的视图，只保存目录和索引
+struct JRChapterEntry {
+
+	let directory: JRChapterDirectory
+	let index: Int
+
+	/// 章节ID
+	var chapterId: Int64 {
+		return directory.chapterIds[index]
+	}
+
+	/// 章节名称
+	var name: String {
+		let begin = Int(directory.nameOffsets[index])
+		let end = Int(directory.nameOffsets[index + 1])
+		return String(bytes: directory.nameArena[begin..<end], encoding: .utf8) ?? ""
+	}
+
+	/// 章节字数
+	var wordCount: Int {
+		return Int(directory.wordCounts[index])
+	}
+
+	/// 章节价格
+	var price: Float {
+		return directory.prices[index]
+	}
+
+	/// 是否是VIP
+	var isVip: Bool {
+		return directory.vipFlags[index]
+	}
+
+	/// 章节是否已经购买
+	var isPurchased: Bool {
+		return directory.purchasedFlags[index]
+	}
+
+	/// 创建阅读器使用的章节模型，只在下载、显示章节内容时调用
+	func makeModel() -> JRBookChapterModel {
+		let model = JRBookChapterModel()
+		model.bookId = directory.bookId
+		model.chapterId = "\(chapterId)"
+		model.name = name
+		model.wordCount = wordCount
+		model.actualPrice = CGFloat(price)
+		model.isVip = isVip
+		model.status = isPurchased
+		return model
+	}
+}
+
+/// 按位保存的标记
+fileprivate struct JRBitSet {
+
+	private var words = [UInt64]()
+
+	subscript(index: Int) -> Bool {
+		let word = index >> 6
+		if word >= words.count {
+			return false
+		}
+		return words[word] & (UInt64(1) << UInt64(index & 63)) != 0
+	}
+
+	mutating func set(_ index: Int, _ value: Bool) {
+		let word = index >> 6
+		while word >= words.count {
+			words.append(0)
+		}
+		let bit = UInt64(1) << UInt64(index & 63)
+		if value {
+			words[word] |= bit
+		} else {
+			words[word] &= ~bit
+		}
+	}
+}
+
+/// 解码目录时的临时记录
+///
+/// 数值属性不是可选类型、没有 didSet，CZClassMapping 可以直接写入
+class JRChapterRecord: NSObject {
+
+	var bookId: String?
+	var chapterId: Int64 = 0
+	var name: String?
+	var wordCount: Int = 0
+	var actualPrice: Double = 0
+	var isVip: Bool = false
+	var status: Bool = true
+
+	override class func cz_mapsScalarsDirectly() -> Bool {
+		return true
+	}
+}
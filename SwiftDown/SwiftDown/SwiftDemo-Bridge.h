@@ -8,3 +8,5 @@
 
 #import "CZAdditions.h"
 #import <CommonCrypto/CommonCrypto.h>
+#import "cz_hex.h"
+#import "cz_percent.h"